@@ -39,9 +39,12 @@ function on_open()
     create_setting("chunks.load-distance", "Load Distance", 1)
     create_setting("chunks.load-speed", "Load Speed", 1)
     create_setting("graphics.fog-curve", "Fog Curve", 0.1)
+    create_setting("graphics.lod-distance", "LOD Distance", 1, "", "graphics.lod-distance.tooltip")
     
     create_checkbox("graphics.backlight", "Backlight", "graphics.backlight.tooltip")
     create_checkbox("graphics.soft-lighting", "Soft lighting", "graphics.soft-lighting.tooltip")
+    create_checkbox("graphics.greedy-meshing", "Greedy meshing", "graphics.greedy-meshing.tooltip")
+    create_checkbox("graphics.packed-chunk-vertices", "Packed chunk vertices", "graphics.packed-chunk-vertices.tooltip")
     create_checkbox("graphics.dense-render", "Dense blocks render", "graphics.dense-render.tooltip")
     create_checkbox("graphics.advanced-render", "Advanced render", "graphics.advanced-render.tooltip")
     create_setting("graphics.ssao", "SSAO", 1, "", "graphics.ssao.tooltip")
@@ -0,0 +1,82 @@
+local FFI = ffi
+
+FFI.cdef[[
+    typedef struct {
+        uint16_t id;
+        uint16_t states;
+    } voxel_t;
+]]
+
+local voxel_ptr_t = FFI.typeof("voxel_t*")
+local light_ptr_t = FFI.typeof("uint16_t*")
+
+local _pin_chunk = world.__pin_chunk
+local _unpin_chunk = world.__unpin_chunk
+local _commit_chunk = world.__commit_chunk
+world.__pin_chunk = nil
+world.__unpin_chunk = nil
+world.__commit_chunk = nil
+
+-- weak keys: an unreachable view is unpinned by its anchor finalizer
+local open_views = setmetatable({}, {__mode="k"})
+
+local ChunkView = {}
+ChunkView.__index = ChunkView
+
+function ChunkView:index(x, y, z)
+    return (y * self.depth + z) * self.width + x
+end
+
+function ChunkView:is_open()
+    return open_views[self] ~= nil
+end
+
+function ChunkView:commit()
+    if not open_views[self] then
+        error("chunk view is closed")
+    end
+    return _commit_chunk(self.x, self.z)
+end
+
+function ChunkView:close()
+    if not open_views[self] then
+        return
+    end
+    open_views[self] = nil
+    FFI.gc(self.anchor, nil)
+    self.anchor = nil
+    self.voxels = nil
+    self.lights = nil
+    _unpin_chunk(self.x, self.z)
+end
+
+function world.open_chunk_view(x, z)
+    local voxels, lights, width, height, depth = _pin_chunk(x, z)
+    if not voxels then
+        return nil
+    end
+    local view = setmetatable({
+        x = x,
+        z = z,
+        width = width,
+        height = height,
+        depth = depth,
+        volume = width * height * depth,
+        voxels = FFI.cast(voxel_ptr_t, voxels),
+        lights = lights and FFI.cast(light_ptr_t, lights),
+        -- unpins the chunk if the view is collected without close()
+        anchor = FFI.gc(FFI.new("uint8_t[1]"), function()
+            _unpin_chunk(x, z)
+        end),
+    }, ChunkView)
+    open_views[view] = true
+    return view
+end
+
+return {
+    close_all = function()
+        for view, _ in pairs(open_views) do
+            view:close()
+        end
+    end
+}
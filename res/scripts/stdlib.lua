@@ -123,6 +123,7 @@ end
 require "core:internal/maths_inline"
 require "core:internal/debugging"
 require "core:internal/audio_input"
+local chunk_views = require "core:internal/chunk_views"
 require "core:internal/extensions/inventory"
 asserts = require "core:internal/asserts"
 events = require "core:internal/events"
@@ -505,6 +506,7 @@ function __vc_on_world_quit()
     gui_util:__reset_local()
     stdcomp.__reset()
     file.__close_all_descriptors()
+    chunk_views.close_all()
 end
 
 local __post_runnables = {}
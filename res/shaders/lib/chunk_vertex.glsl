@@ -0,0 +1,74 @@
+#ifndef CHUNK_VERTEX_GLSL_
+#define CHUNK_VERTEX_GLSL_
+
+#include <constants>
+
+struct ChunkVertex {
+    vec3 position;
+    vec2 texCoord;
+    vec4 light;
+    vec3 normal;
+    float emission;
+    vec4 region;
+};
+
+#ifdef PACKED_CHUNK_VERTEX
+// xyz - fixed point position, w - normal (5 bits per axis) and emission bit
+layout (location = 0) in vec4 v_packed;
+layout (location = 1) in vec2 v_texCoord;
+layout (location = 2) in vec4 v_light;
+layout (location = 3) in vec2 v_regionEnd;
+
+ChunkVertex decode_chunk_vertex() {
+    ChunkVertex vertex;
+    vertex.position = v_packed.xyz / CHUNK_POSITION_SCALE - CHUNK_POSITION_OFFSET;
+    float bits = v_packed.w;
+    vec3 normalBits = mod(floor(vec3(bits, bits / 32.0, bits / 1024.0)), 32.0);
+    vertex.normal = normalBits / 15.0 - 1.0;
+    vertex.emission = floor(bits / 32768.0);
+    vertex.light = v_light;
+
+    if (v_regionEnd == vec2(0.0)) {
+        vertex.texCoord = v_texCoord;
+        vertex.region = vec4(0.0);
+        return vertex;
+    }
+    vertex.region = vec4(v_texCoord, v_regionEnd);
+    // repeated region faces are axis-aligned, texture repeats are
+    // measured along face axes from block edges
+    vec3 n = vertex.normal;
+    vec3 axisX;
+    if (abs(n.x) > 0.5) {
+        axisX = vec3(0.0, 0.0, -n.x);
+    } else if (abs(n.y) > 0.5) {
+        axisX = vec3(1.0, 0.0, 0.0);
+    } else {
+        axisX = vec3(n.z, 0.0, 0.0);
+    }
+    vec3 axisY = abs(n.y) > 0.5 ? vec3(0.0, 0.0, -n.y) : vec3(0.0, 1.0, 0.0);
+    vec3 pos = vertex.position + 0.5;
+    vertex.texCoord = vec2(dot(pos, axisX), dot(pos, axisY));
+    return vertex;
+}
+#else
+layout (location = 0) in vec3 v_position;
+layout (location = 1) in vec2 v_texCoord;
+layout (location = 2) in vec4 v_light;
+layout (location = 3) in vec4 v_normal;
+// provided by merged faces meshes only, others read the default (0, 0, 0, 1)
+// which is a zero width region
+layout (location = 4) in vec4 v_region;
+
+ChunkVertex decode_chunk_vertex() {
+    ChunkVertex vertex;
+    vertex.position = v_position;
+    vertex.texCoord = v_texCoord;
+    vertex.light = v_light;
+    vertex.normal = v_normal.xyz * 2.0 - 1.0;
+    vertex.emission = v_normal.w;
+    vertex.region = v_region;
+    return vertex;
+}
+#endif
+
+#endif // CHUNK_VERTEX_GLSL_
@@ -12,6 +12,10 @@
 #define SKY_LIGHT_TINT (vec3(1.0, 0.95, 0.9) * 2.0)
 #define MIN_SKY_LIGHT vec3(0.2, 0.25, 0.33)
 
+// packed chunk vertices
+#define CHUNK_POSITION_SCALE 128.0
+#define CHUNK_POSITION_OFFSET 128.0
+
 // fog
 #define FOG_POS_SCALE vec3(1.0, 0.2, 1.0)
 
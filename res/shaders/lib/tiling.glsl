@@ -0,0 +1,20 @@
+#ifndef TILING_GLSL_
+#define TILING_GLSL_
+
+// Sample texture atlas region repeated over a merged face.
+// region - atlas region (u1, v1, u2, v2), zero width region means
+// texCoord is an ordinary atlas coordinate
+vec4 sample_tiled(sampler2D tex, vec2 texCoord, vec4 region) {
+    if (region.x == region.z) {
+        return texture(tex, texCoord);
+    }
+    vec2 size = region.zw - region.xy;
+    return textureGrad(
+        tex,
+        region.xy + fract(texCoord) * size,
+        dFdx(texCoord) * size,
+        dFdy(texCoord) * size
+    );
+}
+
+#endif // TILING_GLSL_
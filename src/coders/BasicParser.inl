@@ -1,9 +1,10 @@
 #include "BasicParser.hpp"
 
 #include <cmath>
-#include <sstream>
+#include <type_traits>
 
 #include "util/stringutil.hpp"
+#include "scanning.hpp"
 
 namespace {
     inline int is_box(int c) {
@@ -33,6 +34,14 @@ namespace {
 template<typename CharT>
 void BasicParser<CharT>::skipWhitespaceBasic(bool newline) {
     while (hasNext()) {
+        if constexpr (std::is_same<CharT, char>()) {
+            const char* data = source.data();
+            pos = scanning::skip_blanks(data + pos, data + source.length()) -
+                  data;
+            if (!hasNext()) {
+                break;
+            }
+        }
         CharT next = source[pos];
         if (next == '\n') {
             if (!newline) {
@@ -126,6 +135,11 @@ void BasicParser<CharT>::skip(size_t n) {
 
 template<typename CharT>
 void BasicParser<CharT>::skipLine() {
+    if constexpr (std::is_same<CharT, char>()) {
+        const char* data = source.data();
+        pos = scanning::find_char(data + pos, data + source.length(), '\n') -
+              data;
+    }
     while (hasNext()) {
         if (source[pos] == '\n') {
             pos++;
@@ -282,6 +296,10 @@ CharT BasicParser<CharT>::peekNoJump() {
 template<typename CharT>
 std::basic_string_view<CharT> BasicParser<CharT>::readUntil(CharT c) {
     int start = pos;
+    if constexpr (std::is_same<CharT, char>()) {
+        const char* data = source.data();
+        pos = scanning::find_char(data + pos, data + source.length(), c) - data;
+    }
     while (hasNext() && source[pos] != c) {
         pos++;
     }
@@ -317,6 +335,11 @@ std::basic_string_view<CharT> BasicParser<CharT>::readUntilWhitespace() {
 template <typename CharT>
 std::basic_string_view<CharT> BasicParser<CharT>::readUntilEOL() {
     int start = pos;
+    if constexpr (std::is_same<CharT, char>()) {
+        const char* data = source.data();
+        pos = scanning::find_char(data + pos, data + source.length(), '\n') -
+              data;
+    }
     while (hasNext() && source[pos] != '\n') {
         pos++;
     }
@@ -364,6 +387,22 @@ int64_t BasicParser<CharT>::parseSimpleInt(int base, size_t maxLength) {
     }
     int64_t value = index;
     pos++;
+    if constexpr (std::is_same<CharT, char>()) {
+        if (base == 10) {
+            // digits span, separators are handled below
+            const char* data = source.data();
+            size_t limit = std::min<size_t>(maxLength, source.length());
+            limit = std::min<size_t>(source.length(), start + limit);
+            if (pos < limit) {
+                const char* end =
+                    scanning::skip_digits(data + pos, data + limit);
+                for (const char* ptr = data + pos; ptr < end; ptr++) {
+                    value = value * 10 + (*ptr - '0');
+                }
+                pos = end - data;
+            }
+        }
+    }
     while (hasNext() && pos - start < maxLength) {
         c = source[pos];
         while (c == '_') {
@@ -467,19 +506,30 @@ template <typename CharT>
 std::basic_string<CharT> BasicParser<CharT>::parseString(
     CharT quote, bool closeRequired
 ) {
-    std::basic_stringstream<CharT> ss;
+    std::basic_string<CharT> ss;
     while (hasNext()) {
+        if constexpr (std::is_same<CharT, char>()) {
+            const char* data = source.data();
+            const char* end = scanning::find_string_special(
+                data + pos, data + source.length(), quote
+            );
+            ss.append(data + pos, end - data - pos);
+            pos = end - data;
+            if (!hasNext()) {
+                break;
+            }
+        }
         CharT c = source[pos];
         if (c == quote) {
             pos++;
-            return ss.str();
+            return ss;
         }
         if (c == '\\') {
             pos++;
             c = nextChar();
             if (c >= '0' && c <= '7') {
                 pos--;
-                ss << (char)parseSimpleInt(8);
+                ss.push_back(static_cast<char>(parseSimpleInt(8)));
                 continue;
             }
             if (c == 'u' || c == 'x') {
@@ -490,20 +540,20 @@ std::basic_string<CharT> BasicParser<CharT>::parseString(
                 for (int i = 0; i < 4; i++) {
                     chars[i] = bytes[i];
                 }
-                ss.write(chars, size);
+                ss.append(chars, size);
                 continue;
             }
             switch (c) {
-                case 'n': ss << '\n'; break;
-                case 'r': ss << '\r'; break;
-                case 'b': ss << '\b'; break;
-                case 't': ss << '\t'; break;
-                case 'f': ss << '\f'; break;
-                case 'v': ss << '\v'; break;
-                case '\'': ss << '\''; break;
-                case '"': ss << '"'; break;
-                case '\\': ss << '\\'; break;
-                case '/': ss << '/'; break;
+                case 'n': ss.push_back('\n'); break;
+                case 'r': ss.push_back('\r'); break;
+                case 'b': ss.push_back('\b'); break;
+                case 't': ss.push_back('\t'); break;
+                case 'f': ss.push_back('\f'); break;
+                case 'v': ss.push_back('\v'); break;
+                case '\'': ss.push_back('\''); break;
+                case '"': ss.push_back('"'); break;
+                case '\\': ss.push_back('\\'); break;
+                case '/': ss.push_back('/'); break;
                 case '\n': continue;
                 default:
                     throw error(
@@ -517,13 +567,13 @@ std::basic_string<CharT> BasicParser<CharT>::parseString(
         if (c == '\n' && closeRequired) {
             throw error("non-closed string literal");
         }
-        ss << c;
+        ss.push_back(c);
         pos++;
     }
     if (closeRequired) {
         throw error("unexpected end");
     }
-    return ss.str();
+    return ss;
 }
 
 template <>
@@ -1,169 +1,412 @@
 #include "binary_json.hpp"
 
+#include <cstring>
 #include <stdexcept>
 
 #include "data/dv.hpp"
-#include "byte_utils.hpp"
 #include "gzip.hpp"
 #include "util/Buffer.hpp"
+#include "util/data_io.hpp"
 
 using namespace json;
 
-static void to_binary(ByteBuilder& builder, const dv::value& value) {
+static constexpr size_t LIST_OFFSET = static_cast<size_t>(-1);
+
+template <typename T>
+static void put_le(std::vector<ubyte>& buffer, T value) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    value = dataio::h2le(value);
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+BjsonWriter::BjsonWriter(std::vector<ubyte>& buffer) : buffer(buffer) {
+}
+
+void BjsonWriter::putTypeByte(int typecode) {
+    buffer.push_back(static_cast<ubyte>(typecode));
+}
+
+void BjsonWriter::beginObject() {
+    if (containers.full()) {
+        throw std::runtime_error("bjson nesting is too deep");
+    }
+    containers.push_back(buffer.size());
+    putTypeByte(BJSON_TYPE_DOCUMENT);
+    // document size is set on end()
+    put_le<int32_t>(buffer, 0);
+}
+
+void BjsonWriter::beginList() {
+    if (containers.full()) {
+        throw std::runtime_error("bjson nesting is too deep");
+    }
+    containers.push_back(LIST_OFFSET);
+    putTypeByte(BJSON_TYPE_LIST);
+}
+
+void BjsonWriter::end() {
+    if (containers.empty()) {
+        throw std::runtime_error("no open document or list");
+    }
+    size_t start = containers[containers.size() - 1];
+    containers.pop_back();
+    putTypeByte(BJSON_END);
+    if (start != LIST_OFFSET) {
+        int32_t size = dataio::h2le(static_cast<int32_t>(buffer.size() - start));
+        std::memcpy(buffer.data() + start + 1, &size, sizeof(int32_t));
+    }
+}
+
+void BjsonWriter::key(std::string_view name) {
+    buffer.insert(buffer.end(), name.begin(), name.end());
+    buffer.push_back(0);
+}
+
+void BjsonWriter::putNull() {
+    putTypeByte(BJSON_TYPE_NULL);
+}
+
+void BjsonWriter::putBoolean(bool value) {
+    putTypeByte(BJSON_TYPE_FALSE + value);
+}
+
+void BjsonWriter::putInteger(dv::integer_t value) {
+    if (value >= 0 && value <= 255) {
+        putTypeByte(BJSON_TYPE_BYTE);
+        buffer.push_back(static_cast<ubyte>(value));
+    } else if (value >= INT16_MIN && value <= INT16_MAX) {
+        putTypeByte(BJSON_TYPE_INT16);
+        put_le<int16_t>(buffer, value);
+    } else if (value >= INT32_MIN && value <= INT32_MAX) {
+        putTypeByte(BJSON_TYPE_INT32);
+        put_le<int32_t>(buffer, value);
+    } else {
+        putTypeByte(BJSON_TYPE_INT64);
+        put_le<int64_t>(buffer, value);
+    }
+}
+
+void BjsonWriter::putNumber(dv::number_t value) {
+    putTypeByte(BJSON_TYPE_NUMBER);
+    int64_t bits;
+    std::memcpy(&bits, &value, sizeof(int64_t));
+    put_le<int64_t>(buffer, bits);
+}
+
+void BjsonWriter::putString(std::string_view value) {
+    putTypeByte(BJSON_TYPE_STRING);
+    put_le<int32_t>(buffer, value.size());
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+void BjsonWriter::putBytes(const ubyte* data, size_t size) {
+    putTypeByte(BJSON_TYPE_BYTES);
+    put_le<int32_t>(buffer, size);
+    buffer.insert(buffer.end(), data, data + size);
+}
+
+void BjsonWriter::putValue(const dv::value& value) {
     switch (value.getType()) {
         case dv::value_type::none:
-            throw std::runtime_error("none value is not implemented");
-        case dv::value_type::object: {
-            const auto bytes = json::to_binary(value);
-            builder.put(bytes.data(), bytes.size());
+            putNull();
+            break;
+        case dv::value_type::object:
+            beginObject();
+            for (const auto& [name, element] : value.asObject()) {
+                key(name);
+                putValue(element);
+            }
+            end();
             break;
-        }
         case dv::value_type::list:
-            builder.put(BJSON_TYPE_LIST);
+            beginList();
             for (const auto& element : value) {
-                to_binary(builder, element);
+                putValue(element);
             }
-            builder.put(BJSON_END);
+            end();
             break;
         case dv::value_type::bytes: {
             const auto& bytes = value.asBytes();
-            builder.put(BJSON_TYPE_BYTES);
-            builder.putInt32(bytes.size());
-            builder.put(bytes.data(), bytes.size());
+            putBytes(bytes.data(), bytes.size());
             break;
         }
-        case dv::value_type::integer: {
-            auto val = value.asInteger();
-            if (val >= 0 && val <= 255) {
-                builder.put(BJSON_TYPE_BYTE);
-                builder.put(val);
-            } else if (val >= INT16_MIN && val <= INT16_MAX) {
-                builder.put(BJSON_TYPE_INT16);
-                builder.putInt16(val);
-            } else if (val >= INT32_MIN && val <= INT32_MAX) {
-                builder.put(BJSON_TYPE_INT32);
-                builder.putInt32(val);
-            } else {
-                builder.put(BJSON_TYPE_INT64);
-                builder.putInt64(val);
-            }
+        case dv::value_type::integer:
+            putInteger(value.asInteger());
             break;
-        }
         case dv::value_type::number:
-            builder.put(BJSON_TYPE_NUMBER);
-            builder.putFloat64(value.asNumber());
+            putNumber(value.asNumber());
             break;
         case dv::value_type::boolean:
-            builder.put(BJSON_TYPE_FALSE + value.asBoolean());
+            putBoolean(value.asBoolean());
             break;
         case dv::value_type::string:
-            builder.put(BJSON_TYPE_STRING);
-            builder.put(value.asString());
+            putString(value.asString());
             break;
     }
 }
 
+void json::to_binary(const dv::value& object, std::vector<ubyte>& dst) {
+    BjsonWriter writer(dst);
+    writer.beginObject();
+    for (const auto& [key, value] : object.asObject()) {
+        writer.key(key);
+        writer.putValue(value);
+    }
+    writer.end();
+}
+
 std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
+    std::vector<ubyte> bytes;
+    to_binary(object, bytes);
     if (compress) {
-        auto bytes = to_binary(object, false);
         return gzip::compress(bytes.data(), bytes.size());
     }
-    ByteBuilder builder;
-    // type byte
-    builder.put(BJSON_TYPE_DOCUMENT);
-    // document size
-    builder.putInt32(0);
+    return bytes;
+}
 
-    // writing entries
-    for (const auto& [key, value] : object.asObject()) {
-        builder.putCStr(key.c_str());
-        to_binary(builder, value);
+BjsonReader::BjsonReader(const ubyte* src, size_t size)
+    : src(src), size(size) {
+}
+
+void BjsonReader::require(size_t n) const {
+    if (n > size - pos) {
+        throw std::runtime_error("unexpected end of bjson data");
     }
-    // terminating byte
-    builder.put(BJSON_END);
+}
 
-    // updating document size
-    builder.setInt32(1, builder.size());
-    return builder.build();
+template <typename T>
+static T get_le(const ubyte* src) {
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return dataio::le2h(value);
 }
 
-static dv::value list_from_binary(ByteReader& reader);
-static dv::value object_from_binary(ByteReader& reader);
+std::string_view BjsonReader::readCString() {
+    const auto begin = src + pos;
+    const auto end = static_cast<const ubyte*>(
+        std::memchr(begin, 0, size - pos)
+    );
+    if (end == nullptr) {
+        throw std::runtime_error("unterminated bjson key");
+    }
+    pos += end - begin + 1;
+    return std::string_view(reinterpret_cast<const char*>(begin), end - begin);
+}
 
-static dv::value value_from_binary(ByteReader& reader) {
-    ubyte typecode = reader.get();
+void BjsonReader::readTyped(ubyte typecode) {
     switch (typecode) {
         case BJSON_TYPE_DOCUMENT:
-            reader.getInt32();
-            return object_from_binary(reader);
         case BJSON_TYPE_LIST:
-            return list_from_binary(reader);
+            if (containers.full()) {
+                throw std::runtime_error("bjson nesting is too deep");
+            }
+            if (typecode == BJSON_TYPE_DOCUMENT) {
+                // document size is not needed for sequential reading
+                require(sizeof(int32_t));
+                pos += sizeof(int32_t);
+                containers.push_back(true);
+                current = Token::BEGIN_OBJECT;
+            } else {
+                containers.push_back(false);
+                current = Token::BEGIN_LIST;
+            }
+            return;
         case BJSON_TYPE_BYTE:
-            return reader.get();
+            require(1);
+            scalar.integer = src[pos++];
+            current = Token::INTEGER;
+            return;
         case BJSON_TYPE_INT16:
-            return reader.getInt16();
+            require(sizeof(int16_t));
+            scalar.integer = get_le<int16_t>(src + pos);
+            pos += sizeof(int16_t);
+            current = Token::INTEGER;
+            return;
         case BJSON_TYPE_INT32:
-            return reader.getInt32();
+            require(sizeof(int32_t));
+            scalar.integer = get_le<int32_t>(src + pos);
+            pos += sizeof(int32_t);
+            current = Token::INTEGER;
+            return;
         case BJSON_TYPE_INT64:
-            return reader.getInt64();
-        case BJSON_TYPE_NUMBER:
-            return reader.getFloat64();
+            require(sizeof(int64_t));
+            scalar.integer = get_le<int64_t>(src + pos);
+            pos += sizeof(int64_t);
+            current = Token::INTEGER;
+            return;
+        case BJSON_TYPE_NUMBER: {
+            require(sizeof(int64_t));
+            int64_t bits = get_le<int64_t>(src + pos);
+            std::memcpy(&scalar.number, &bits, sizeof(int64_t));
+            pos += sizeof(int64_t);
+            current = Token::NUMBER;
+            return;
+        }
         case BJSON_TYPE_FALSE:
         case BJSON_TYPE_TRUE:
-            return (typecode - BJSON_TYPE_FALSE) != 0;
-        case BJSON_TYPE_STRING:
-            return reader.getString();
+            scalar.boolean = typecode == BJSON_TYPE_TRUE;
+            current = Token::BOOLEAN;
+            return;
         case BJSON_TYPE_NULL:
-            return nullptr;
+            current = Token::NONE;
+            return;
+        case BJSON_TYPE_STRING: {
+            require(sizeof(int32_t));
+            auto length = static_cast<uint32_t>(get_le<int32_t>(src + pos));
+            pos += sizeof(int32_t);
+            require(length);
+            stringValue = std::string_view(
+                reinterpret_cast<const char*>(src + pos), length
+            );
+            pos += length;
+            current = Token::STRING;
+            return;
+        }
         case BJSON_TYPE_BYTES: {
-            int32_t size = reader.getInt32();
-            if (size < 0) {
+            require(sizeof(int32_t));
+            int32_t length = get_le<int32_t>(src + pos);
+            pos += sizeof(int32_t);
+            if (length < 0) {
                 throw std::runtime_error(
-                    "invalid byte-buffer size "+std::to_string(size));
+                    "invalid byte-buffer size "+std::to_string(length));
             }
-            if (size > reader.remaining()) {
+            if (static_cast<size_t>(length) > size - pos) {
                 throw std::runtime_error(
-                    "buffer_size > remaining_size "+std::to_string(size));
+                    "buffer_size > remaining_size "+std::to_string(length));
             }
-            auto bytes = std::make_shared<util::Buffer<ubyte>>(
-                reader.pointer(), size);
-            reader.skip(size);
-            return bytes;
+            bytesValue = util::span<ubyte>(src + pos, length);
+            pos += length;
+            current = Token::BYTES;
+            return;
         }
     }
     throw std::runtime_error(
         "type support not implemented for <"+std::to_string(typecode)+">");
 }
 
-static dv::value list_from_binary(ByteReader& reader) {
-    auto list = dv::list();
-    while (reader.peek() != BJSON_END) {
-        list.add(value_from_binary(reader));
+BjsonReader::Token BjsonReader::next() {
+    currentKey = {};
+    if (containers.empty()) {
+        if (pos >= size) {
+            return current = Token::END_OF_INPUT;
+        }
+    } else {
+        require(1);
+        if (src[pos] == BJSON_END) {
+            pos++;
+            containers.pop_back();
+            return current = Token::END;
+        }
+        if (containers[containers.size() - 1]) {
+            currentKey = readCString();
+        }
+        require(1);
+    }
+    readTyped(src[pos++]);
+    return current;
+}
+
+void BjsonReader::skip() {
+    if (current != Token::BEGIN_OBJECT && current != Token::BEGIN_LIST) {
+        return;
+    }
+    size_t target = depth() - 1;
+    while (depth() > target) {
+        next();
+    }
+}
+
+dv::value BjsonReader::readValue(const std::shared_ptr<dv::Arena>& arena) {
+    switch (current) {
+        case Token::BEGIN_OBJECT: {
+            auto obj = dv::object(arena);
+            while (next() != Token::END) {
+                // keys are null-terminated in the source buffer
+                const char* name = currentKey.data();
+                auto& entry = obj[name];
+                entry = readValue(arena);
+            }
+            return obj;
+        }
+        case Token::BEGIN_LIST: {
+            auto list = dv::list(arena);
+            while (next() != Token::END) {
+                list.add(readValue(arena));
+            }
+            return list;
+        }
+        case Token::NONE:
+            return nullptr;
+        case Token::BOOLEAN:
+            return scalar.boolean;
+        case Token::INTEGER:
+            return scalar.integer;
+        case Token::NUMBER:
+            return scalar.number;
+        case Token::STRING:
+            return std::string(stringValue);
+        case Token::BYTES:
+            return std::make_shared<util::Buffer<ubyte>>(
+                bytesValue.data(), bytesValue.size()
+            );
+        case Token::END:
+        case Token::END_OF_INPUT:
+            break;
+    }
+    throw std::runtime_error("unexpected end of bjson document or list");
+}
+
+bool BjsonReader::getBoolean() const {
+    if (current != Token::BOOLEAN) {
+        throw std::runtime_error("bjson boolean expected");
+    }
+    return scalar.boolean;
+}
+
+dv::integer_t BjsonReader::getInteger() const {
+    if (current != Token::INTEGER) {
+        throw std::runtime_error("bjson integer expected");
+    }
+    return scalar.integer;
+}
+
+dv::number_t BjsonReader::getNumber() const {
+    if (current == Token::INTEGER) {
+        return scalar.integer;
+    } else if (current != Token::NUMBER) {
+        throw std::runtime_error("bjson number expected");
+    }
+    return scalar.number;
+}
+
+std::string_view BjsonReader::getString() const {
+    if (current != Token::STRING) {
+        throw std::runtime_error("bjson string expected");
     }
-    reader.get();
-    return list;
+    return stringValue;
 }
 
-static dv::value object_from_binary(ByteReader& reader) {
-    auto obj = dv::object();
-    while (reader.peek() != BJSON_END) {
-        const char* key = reader.getCString();
-        obj[key] = value_from_binary(reader);
+util::span<ubyte> BjsonReader::getBytes() const {
+    if (current != Token::BYTES) {
+        throw std::runtime_error("bjson bytes expected");
     }
-    reader.get();
-    return obj;
+    return bytesValue;
 }
 
-dv::value json::from_binary(const ubyte* src, size_t size) {
+dv::value json::from_binary(
+    const ubyte* src, size_t size, const std::shared_ptr<dv::Arena>& arena
+) {
     if (size < 2) {
         throw std::runtime_error("bytes length is less than 2");
     }
     if (src[0] == gzip::MAGIC[0] && src[1] == gzip::MAGIC[1]) {
         // reading compressed document
         auto data = gzip::decompress(src, size);
-        return from_binary(data.data(), data.size());
+        return from_binary(data.data(), data.size(), arena);
     } else {
-        ByteReader reader(src, size);
-        return value_from_binary(reader);
+        BjsonReader reader(src, size);
+        reader.next();
+        return reader.readValue(arena);
     }
 }
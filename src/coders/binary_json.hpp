@@ -1,9 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "data/dv.hpp"
+#include "util/span.hpp"
+#include "util/stack_vector.hpp"
 
 #include "typedefs.hpp"
 
@@ -23,7 +26,129 @@ namespace json {
     inline constexpr int BJSON_TYPE_NULL = 0xC;
     inline constexpr int BJSON_TYPE_CDOCUMENT = 0x1F;
 
+    /// @brief Max nesting depth supported by BjsonWriter and BjsonReader
+    inline constexpr int BJSON_MAX_DEPTH = 128;
+
+    /// @brief Streaming bjson writer appending encoded data to a caller
+    /// provided buffer, so the buffer may be reused between documents.
+    /// Nested documents sizes are patched in place on end().
+    class BjsonWriter {
+        std::vector<ubyte>& buffer;
+        /// @brief Start offsets of open documents (npos for lists)
+        util::stack_vector<size_t, BJSON_MAX_DEPTH> containers;
+
+        void putTypeByte(int typecode);
+    public:
+        BjsonWriter(std::vector<ubyte>& buffer);
+
+        /// @brief Open a document (object). Entries are written as key()
+        /// followed by a value
+        void beginObject();
+        /// @brief Open a list
+        void beginList();
+        /// @brief Close last opened document or list
+        void end();
+
+        /// @brief Write document entry key
+        void key(std::string_view name);
+
+        void putNull();
+        void putBoolean(bool value);
+        void putInteger(dv::integer_t value);
+        void putNumber(dv::number_t value);
+        void putString(std::string_view value);
+        void putBytes(const ubyte* data, size_t size);
+        /// @brief Write dynamic value recursively
+        void putValue(const dv::value& value);
+
+        /// @return Number of currently open documents and lists
+        size_t depth() const {
+            return containers.size();
+        }
+    };
+
+    /// @brief Pull parser over uncompressed bjson data. Keys, strings and
+    /// bytes are returned as views into the source buffer, so no
+    /// allocations are made while reading.
+    class BjsonReader {
+    public:
+        enum class Token {
+            BEGIN_OBJECT,
+            BEGIN_LIST,
+            /// @brief End of document or list
+            END,
+            NONE,
+            BOOLEAN,
+            INTEGER,
+            NUMBER,
+            STRING,
+            BYTES,
+            END_OF_INPUT,
+        };
+
+        BjsonReader(const ubyte* src, size_t size);
+
+        /// @brief Read next token. Inside of a document current entry key
+        /// is available via key()
+        Token next();
+
+        /// @brief Skip rest of the current document or list
+        /// (after BEGIN_OBJECT or BEGIN_LIST token)
+        void skip();
+
+        /// @brief Read current token value as dv::value. Documents and lists
+        /// are read entirely
+        /// @param arena optional arena to allocate objects and lists in
+        dv::value readValue(const std::shared_ptr<dv::Arena>& arena = nullptr);
+
+        /// @brief Current entry key (null-terminated in the source buffer)
+        std::string_view key() const {
+            return currentKey;
+        }
+        Token token() const {
+            return current;
+        }
+        bool getBoolean() const;
+        dv::integer_t getInteger() const;
+        /// @brief Get number value. Integers are converted
+        dv::number_t getNumber() const;
+        std::string_view getString() const;
+        util::span<ubyte> getBytes() const;
+
+        /// @return Number of currently open documents and lists
+        size_t depth() const {
+            return containers.size();
+        }
+    private:
+        const ubyte* src;
+        size_t size;
+        size_t pos = 0;
+        Token current = Token::NONE;
+        std::string_view currentKey;
+        union {
+            bool boolean;
+            dv::integer_t integer;
+            dv::number_t number;
+        } scalar {};
+        std::string_view stringValue;
+        util::span<ubyte> bytesValue {nullptr, 0};
+        /// @brief true for documents, false for lists
+        util::stack_vector<bool, BJSON_MAX_DEPTH> containers;
+
+        void require(size_t n) const;
+        std::string_view readCString();
+        void readTyped(ubyte typecode);
+    };
+
     std::vector<ubyte> to_binary(const dv::value& obj, bool compress = false);
+
+    /// @brief Encode document appending bytes to the caller provided buffer
+    void to_binary(const dv::value& obj, std::vector<ubyte>& dst);
     
-    dv::value from_binary(const ubyte* src, size_t size);
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value from_binary(
+        const ubyte* src,
+        size_t size,
+        const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
 }
@@ -25,6 +25,8 @@ public:
     void putFloat32(float val, bool bigEndian = false);
     /// @brief Write 64 bit floating-point number
     void putFloat64(double val, bool bigEndian = false);
+    /// @brief Write unsigned LEB128 variable-length integer (1-10 bytes)
+    void putVarInt(uint64_t val);
 
     /// @brief Write string (uint32 length + bytes)
     void put(const std::string& s);
@@ -72,6 +74,8 @@ public:
     float getFloat32(bool bigEndian = false);
     /// @brief Read 64 bit floating-point number
     double getFloat64(bool bigEndian = false);
+    /// @brief Read unsigned LEB128 variable-length integer
+    uint64_t getVarInt();
     /// @brief Read C-String
     const char* getCString();
     /// @brief Read string with unsigned 32 bit number before (length)
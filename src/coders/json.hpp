@@ -1,19 +1,24 @@
-#pragma once
-
-#include <string>
-
-#include "data/dv.hpp"
-#include "typedefs.hpp"
-#include "binary_json.hpp"
-
-namespace json {
-    dv::value parse(std::string_view filename, std::string_view source);
-    dv::value parse(std::string_view source);
-
-    std::string stringify(
-        const dv::value& value,
-        bool nice,
-        const std::string& indent = "  ",
-        bool escapeUtf8 = false
-    );
-}
+#pragma once
+
+#include <string>
+
+#include "data/dv.hpp"
+#include "typedefs.hpp"
+#include "binary_json.hpp"
+
+namespace json {
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value parse(
+        std::string_view filename,
+        std::string_view source,
+        const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
+    dv::value parse(std::string_view source);
+
+    std::string stringify(
+        const dv::value& value,
+        bool nice,
+        const std::string& indent = "  ",
+        bool escapeUtf8 = false
+    );
+}
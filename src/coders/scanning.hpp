@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #include <emmintrin.h>
+    #define VC_SCANNING_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define VC_SCANNING_NEON
+#endif
+
+/// @brief Vectorized text scanning used by BasicParser.
+/// Every function returns pointer to the first character not matching
+/// the condition or end.
+namespace scanning {
+    inline bool is_blank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f';
+    }
+
+    inline bool is_string_special(char c, char quote) {
+        return c == quote || c == '\\' || c == '\n';
+    }
+
+#if defined(VC_SCANNING_SSE2)
+    inline int first_set_bit(unsigned mask) {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+    #else
+        return __builtin_ctz(mask);
+    #endif
+    }
+
+    inline __m128i load16(const char* src) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    }
+#elif defined(VC_SCANNING_NEON)
+    /// @return 64 bit mask with 4 bits per byte (0xF for matching bytes)
+    inline uint64_t nibble_mask(uint8x16_t matches) {
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    }
+
+    inline int first_set_nibble(uint64_t mask) {
+        return __builtin_ctzll(mask) >> 2;
+    }
+
+    inline uint8x16_t load16(const char* src) {
+        return vld1q_u8(reinterpret_cast<const uint8_t*>(src));
+    }
+#endif
+
+    /// @brief Skip spaces, tabs, '\r' and '\f'. Stops at '\n'
+    inline const char* skip_blanks(const char* src, const char* end) {
+#if defined(VC_SCANNING_SSE2)
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i ff = _mm_set1_epi8('\f');
+        while (end - src >= 16) {
+            __m128i chunk = load16(src);
+            __m128i blanks = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)
+                ),
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, ff)
+                )
+            );
+            unsigned mask = ~_mm_movemask_epi8(blanks) & 0xFFFF;
+            if (mask) {
+                return src + first_set_bit(mask);
+            }
+            src += 16;
+        }
+#elif defined(VC_SCANNING_NEON)
+        while (end - src >= 16) {
+            uint8x16_t chunk = load16(src);
+            uint8x16_t blanks = vorrq_u8(
+                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')),
+                         vceqq_u8(chunk, vdupq_n_u8('\t'))),
+                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\r')),
+                         vceqq_u8(chunk, vdupq_n_u8('\f')))
+            );
+            uint64_t mask = ~nibble_mask(blanks);
+            if (mask) {
+                return src + first_set_nibble(mask);
+            }
+            src += 16;
+        }
+#endif
+        while (src < end && is_blank(*src)) {
+            src++;
+        }
+        return src;
+    }
+
+    /// @brief Find closing quote, escape character or line break
+    inline const char* find_string_special(
+        const char* src, const char* end, char quote
+    ) {
+#if defined(VC_SCANNING_SSE2)
+        const __m128i quotes = _mm_set1_epi8(quote);
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - src >= 16) {
+            __m128i chunk = load16(src);
+            __m128i special = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, quotes),
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(chunk, backslash),
+                    _mm_cmpeq_epi8(chunk, newline)
+                )
+            );
+            unsigned mask = _mm_movemask_epi8(special);
+            if (mask) {
+                return src + first_set_bit(mask);
+            }
+            src += 16;
+        }
+#elif defined(VC_SCANNING_NEON)
+        while (end - src >= 16) {
+            uint8x16_t chunk = load16(src);
+            uint8x16_t special = vorrq_u8(
+                vceqq_u8(chunk, vdupq_n_u8(static_cast<uint8_t>(quote))),
+                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\\')),
+                         vceqq_u8(chunk, vdupq_n_u8('\n')))
+            );
+            uint64_t mask = nibble_mask(special);
+            if (mask) {
+                return src + first_set_nibble(mask);
+            }
+            src += 16;
+        }
+#endif
+        while (src < end && !is_string_special(*src, quote)) {
+            src++;
+        }
+        return src;
+    }
+
+    /// @brief Skip decimal digits
+    inline const char* skip_digits(const char* src, const char* end) {
+#if defined(VC_SCANNING_SSE2)
+        const __m128i zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        while (end - src >= 16) {
+            // c - '0' <= 9 (unsigned)
+            __m128i offsets = _mm_sub_epi8(load16(src), zero);
+            __m128i digits =
+                _mm_cmpeq_epi8(_mm_min_epu8(offsets, nine), offsets);
+            unsigned mask = ~_mm_movemask_epi8(digits) & 0xFFFF;
+            if (mask) {
+                return src + first_set_bit(mask);
+            }
+            src += 16;
+        }
+#elif defined(VC_SCANNING_NEON)
+        while (end - src >= 16) {
+            uint8x16_t offsets = vsubq_u8(load16(src), vdupq_n_u8('0'));
+            uint64_t mask = ~nibble_mask(vcleq_u8(offsets, vdupq_n_u8(9)));
+            if (mask) {
+                return src + first_set_nibble(mask);
+            }
+            src += 16;
+        }
+#endif
+        while (src < end && *src >= '0' && *src <= '9') {
+            src++;
+        }
+        return src;
+    }
+
+    /// @brief Find character
+    inline const char* find_char(const char* src, const char* end, char c) {
+        auto found = static_cast<const char*>(std::memchr(src, c, end - src));
+        return found ? found : end;
+    }
+}
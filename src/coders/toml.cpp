@@ -14,6 +14,7 @@
 using namespace toml;
 
 class TomlReader : BasicParser<char> {
+    std::shared_ptr<dv::Arena> arena;
     dv::value root;
 
     // modified version of BasicParser.parseString
@@ -108,19 +109,19 @@ class TomlReader : BasicParser<char> {
         } else if (c == '[') {
             // parse array
             pos++;
-            dv::list_t values;
+            auto list = dv::list(arena);
             while (peek() != ']') {
-                values.push_back(parseValue());
+                list.add(parseValue());
                 if (peek() != ']') {
                     expect(',');
                 }
             }
             pos++;
-            return dv::value(std::move(values));
+            return list;
         } else if (c == '{') {
             // parse inline table
             pos++;
-            auto table = dv::object();
+            auto table = dv::object(arena);
             while (peek() != '}') {
                 auto key = parseName();
                 expect('=');
@@ -148,7 +149,7 @@ class TomlReader : BasicParser<char> {
                 name = parseName();
             }
             if (lvalue->getType() == dv::value_type::none) {
-                *lvalue = dv::object();
+                *lvalue = dv::object(arena);
             }
             lvalue = &(*lvalue)[name];
             if (peek() != '.') {
@@ -172,13 +173,13 @@ class TomlReader : BasicParser<char> {
                     // parse list of tables
                     dv::value& list = parseLValue(root);
                     if (list == nullptr) {
-                        list = dv::list();
+                        list = dv::list(arena);
                     } else if (!list.isList()) {
                         throw error("target is not an array");
                     }
                     expect(']');
                     expect(']');
-                    dv::value section = dv::object();
+                    dv::value section = dv::object(arena);
                     readSection(section, root);
                     list.add(std::move(section));
                     return;
@@ -186,7 +187,7 @@ class TomlReader : BasicParser<char> {
                 // parse table
                 dv::value& section = parseLValue(root);
                 if (section == nullptr) {
-                    section = dv::object();
+                    section = dv::object(arena);
                 } else if (!section.isObject()) {
                     throw error("target is not a table");
                 }
@@ -202,8 +203,14 @@ class TomlReader : BasicParser<char> {
         }
     }
 public:
-    TomlReader(std::string_view file, std::string_view source)
-        : BasicParser(file, source), root(dv::object()) {
+    TomlReader(
+        std::string_view file,
+        std::string_view source,
+        std::shared_ptr<dv::Arena> arena
+    )
+        : BasicParser(file, source),
+          arena(std::move(arena)),
+          root(dv::object(this->arena)) {
         hashComment = true;
     }
 
@@ -220,7 +227,7 @@ public:
 void toml::parse(
     SettingsHandler& handler, std::string_view file, std::string_view source
 ) {
-    auto map = parse(file, source);
+    auto map = parse(file, source, nullptr);
     
     for (const auto& [sectionName, sectionMap] : map.asObject()) {
         if (!sectionMap.isObject()) {
@@ -235,8 +242,12 @@ void toml::parse(
     }
 }
 
-dv::value toml::parse(std::string_view file, std::string_view source) {
-    return TomlReader(file, source).read();
+dv::value toml::parse(
+    std::string_view file,
+    std::string_view source,
+    const std::shared_ptr<dv::Arena>& arena
+) {
+    return TomlReader(file, source, arena).read();
 }
 
 static void to_string(std::stringstream& ss, const dv::value& value);
@@ -10,7 +10,12 @@ namespace toml {
     std::string stringify(SettingsHandler& handler);
     std::string stringify(const dv::value& root, const std::string& name = "");
 
-    dv::value parse(std::string_view file, std::string_view source);
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value parse(
+        std::string_view file,
+        std::string_view source,
+        const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
 
     void parse(
         SettingsHandler& handler, std::string_view file, std::string_view source
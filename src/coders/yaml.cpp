@@ -12,7 +12,11 @@ namespace {
 
     class Parser : BasicParser<char> {
     public:
-        Parser(std::string_view filename, std::string_view source);
+        Parser(
+            std::string_view filename,
+            std::string_view source,
+            std::shared_ptr<dv::Arena> arena
+        );
 
         dv::value parseValue();
         dv::value parseFullValue(int indent);
@@ -25,6 +29,8 @@ namespace {
         bool expectIndent(int indent);
         std::string_view readYamlIdentifier();
         std::string readMultilineString(int indent, bool eols, Chomping chomp);
+
+        std::shared_ptr<dv::Arena> arena;
     };
 }
 
@@ -44,8 +50,12 @@ static dv::value perform_literal(std::string_view literal) {
     return std::string(literal);
 }
 
-Parser::Parser(std::string_view filename, std::string_view source)
-    : BasicParser(filename, source) {
+Parser::Parser(
+    std::string_view filename,
+    std::string_view source,
+    std::shared_ptr<dv::Arena> arena
+)
+    : BasicParser(filename, source), arena(std::move(arena)) {
     hashComment = true;
 }
 
@@ -150,7 +160,7 @@ dv::value Parser::parseValue() {
 
 dv::value Parser::parseInlineArray() {
     expect('[');
-    auto list = dv::list();
+    auto list = dv::list(arena);
     while (peek() != ']') {
         if (peek() == '#') {
             skipLine();
@@ -173,7 +183,7 @@ dv::value Parser::parseInlineArray() {
 
 dv::value Parser::parseInlineObject() {
     expect('{');
-    dv::value object = dv::object();
+    dv::value object = dv::object(arena);
     while (peek() != '}') {
         if (peek() == '#') {
             skipLine();
@@ -213,7 +223,7 @@ dv::value Parser::parseFullValue(int indent) {
             return parseArray(next_indent);
         } else {
             pos = init_pos;
-            return parseObject(dv::object(), next_indent);
+            return parseObject(dv::object(arena), next_indent);
         }
     } else if (is_digit(c)) {
         return parseNumber(1);
@@ -243,7 +253,7 @@ dv::value Parser::parseFullValue(int indent) {
 }
 
 dv::value Parser::parseArray(int indent) {
-    dv::value list = dv::list();
+    dv::value list = dv::list(arena);
 
     while (hasNext()) {
         skipEmptyLines();
@@ -267,7 +277,7 @@ dv::value Parser::parseArray(int indent) {
             auto name = readYamlIdentifier();
             expect(':');
             skipWhitespace(false);
-            dv::value object = dv::object();
+            dv::value object = dv::object(arena);
             object[std::string(name)] = parseFullValue(next_indent);
             skipEmptyLines();
             if (!hasNext()) {
@@ -316,8 +326,12 @@ dv::value Parser::parseObject(dv::value&& object, int indent) {
     return std::move(object);
 }
 
-dv::value yaml::parse(std::string_view filename, std::string_view source) {
-    return Parser(filename, source).parseObject(dv::object());
+dv::value yaml::parse(
+    std::string_view filename,
+    std::string_view source,
+    const std::shared_ptr<dv::Arena>& arena
+) {
+    return Parser(filename, source, arena).parseObject(dv::object(arena));
 }
 
 dv::value yaml::parse(std::string_view source) {
@@ -5,7 +5,12 @@
 #include "data/dv.hpp"
 
 namespace yaml {
-    dv::value parse(std::string_view filename, std::string_view source);
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value parse(
+        std::string_view filename,
+        std::string_view source,
+        const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
     dv::value parse(std::string_view source);
 
     std::string stringify(const dv::value& value);
@@ -0,0 +1,162 @@
+#include "ContentCache.hpp"
+
+#include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "debug/Logger.hpp"
+#include "io/io.hpp"
+
+static debug::Logger logger("content-cache");
+
+static constexpr char MAGIC[] = "VCCACHE";
+
+static void put_string(ByteBuilder& builder, const std::string& str) {
+    builder.putVarInt(str.length());
+    builder.put(reinterpret_cast<const ubyte*>(str.data()), str.length());
+}
+
+static const ubyte* get_bytes(ByteReader& reader, size_t length) {
+    if (length > reader.remaining()) {
+        throw std::runtime_error("unexpected end of cache file");
+    }
+    auto bytes = reader.pointer();
+    reader.skip(length);
+    return bytes;
+}
+
+static std::string get_string(ByteReader& reader) {
+    size_t length = reader.getVarInt();
+    auto bytes = get_bytes(reader, length);
+    return std::string(reinterpret_cast<const char*>(bytes), length);
+}
+
+ContentCache::ContentCache(io::path file, std::string source)
+    : file(std::move(file)), source(std::move(source)) {
+    if (io::is_regular_file(this->file)) {
+        try {
+            load();
+        } catch (const std::runtime_error& err) {
+            logger.warning() << "could not read " << this->file.string()
+                             << ": " << err.what();
+            entries.clear();
+        }
+    }
+}
+
+void ContentCache::load() {
+    auto bytes = io::read_bytes(file);
+    ByteReader reader(bytes.data(), bytes.size());
+    reader.checkMagic(MAGIC, sizeof(MAGIC));
+    if (reader.get() != FORMAT_VERSION) {
+        return;
+    }
+    if (get_string(reader) != source) {
+        return;
+    }
+    size_t count = reader.getVarInt();
+    entries.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        auto key = get_string(reader);
+        auto& entry = entries[key];
+        entry.lastWriteTime = reader.getInt64();
+        entry.size = reader.getVarInt();
+        size_t length = reader.getVarInt();
+        auto data = get_bytes(reader, length);
+        entry.data.assign(data, data + length);
+        entry.used = false;
+    }
+}
+
+dv::value ContentCache::read(
+    const io::path& file, const std::shared_ptr<dv::Arena>& arena
+) {
+    auto lastWriteTime = io::last_write_time(file);
+    if (lastWriteTime == io::file_time_type::min()) {
+        // device does not provide modification time
+        misses++;
+        return io::read_object(file, arena);
+    }
+    int64_t timestamp = lastWriteTime.time_since_epoch().count();
+    uint64_t size = io::file_size(file);
+
+    auto key = file.string();
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        auto& entry = found->second;
+        if (entry.lastWriteTime == timestamp && entry.size == size) {
+            try {
+                auto value = json::from_binary(
+                    entry.data.data(), entry.data.size(), arena
+                );
+                entry.used = true;
+                hits++;
+                return value;
+            } catch (const std::runtime_error& err) {
+                logger.warning() << "invalid cache entry " << key << ": "
+                                 << err.what();
+            }
+        }
+        entries.erase(found);
+        modified = true;
+    }
+    misses++;
+    auto value = io::read_object(file, arena);
+    if (value.isObject()) {
+        auto& entry = entries[key];
+        entry.lastWriteTime = timestamp;
+        entry.size = size;
+        json::to_binary(value, entry.data);
+        entry.used = true;
+        modified = true;
+    }
+    return value;
+}
+
+void ContentCache::save() {
+    bool stale = false;
+    for (const auto& [_, entry] : entries) {
+        if (!entry.used) {
+            stale = true;
+            break;
+        }
+    }
+    if (!modified && !stale) {
+        return;
+    }
+    ByteBuilder builder;
+    builder.put(reinterpret_cast<const ubyte*>(MAGIC), sizeof(MAGIC));
+    builder.put(FORMAT_VERSION);
+    put_string(builder, source);
+
+    size_t count = 0;
+    for (const auto& [_, entry] : entries) {
+        count += entry.used;
+    }
+    builder.putVarInt(count);
+    for (const auto& [key, entry] : entries) {
+        if (!entry.used) {
+            continue;
+        }
+        put_string(builder, key);
+        builder.putInt64(entry.lastWriteTime);
+        builder.putVarInt(entry.size);
+        builder.putVarInt(entry.data.size());
+        builder.put(entry.data.data(), entry.data.size());
+    }
+    io::create_directories(file.parent());
+    if (!io::write_bytes(file, builder.data(), builder.size())) {
+        logger.warning() << "could not write " << file.string();
+        return;
+    }
+    modified = false;
+}
+
+dv::value read_cached(
+    ContentCache* cache,
+    const io::path& file,
+    const std::shared_ptr<dv::Arena>& arena
+) {
+    if (cache) {
+        return cache->read(file, arena);
+    }
+    return io::read_object(file, arena);
+}
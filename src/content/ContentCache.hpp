@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "io/path.hpp"
+#include "data/dv.hpp"
+#include "typedefs.hpp"
+
+/// @brief Compiled content cache of a content pack.
+/// Stores pack data files (content.json, definitions, tags etc.) already
+/// parsed, as binary json documents along with the source file last write
+/// time and size. Unchanged files are decoded from the cache without text
+/// parsing, changed files are parsed again and replace their entries.
+class ContentCache {
+public:
+    /// @param file cache file
+    /// @param source pack folder. Cache built for other folder is dropped
+    ContentCache(io::path file, std::string source);
+
+    /// @brief Read data file (json, toml, ...) object
+    /// @param file data file
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value read(
+        const io::path& file, const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
+
+    /// @brief Write cache file if any file was parsed or if some entries
+    /// were not used since loading (removed files)
+    void save();
+
+    /// @return Number of files read from the cache
+    size_t getHits() const {
+        return hits;
+    }
+
+    /// @return Number of files parsed
+    size_t getMisses() const {
+        return misses;
+    }
+
+    static inline const io::path FOLDER = "user:cache/content";
+    static constexpr ubyte FORMAT_VERSION = 1;
+private:
+    struct Entry {
+        int64_t lastWriteTime;
+        uint64_t size;
+        std::vector<ubyte> data;
+        bool used;
+    };
+
+    io::path file;
+    std::string source;
+    std::unordered_map<std::string, Entry> entries;
+    size_t hits = 0;
+    size_t misses = 0;
+    bool modified = false;
+
+    void load();
+};
+
+/// @brief Read data file object using cache if not null
+dv::value read_cached(
+    ContentCache* cache,
+    const io::path& file,
+    const std::shared_ptr<dv::Arena>& arena = nullptr
+);
@@ -5,12 +5,16 @@
 #include "Content.hpp"
 #include "ContentPack.hpp"
 #include "ContentBuilder.hpp"
+#include "ContentCache.hpp"
 #include "ContentLoader.hpp"
 #include "PacksManager.hpp"
 #include "objects/rigging.hpp"
 #include "devtools/Project.hpp"
 #include "logic/scripting/scripting.hpp"
 #include "core_defs.hpp"
+#include "debug/Logger.hpp"
+
+static debug::Logger logger("content-control");
 
 static void load_configs(Input* input, const io::path& root) {
     auto configFolder = root / "config";
@@ -110,7 +114,13 @@ void ContentControl::loadContent() {
     paths.resPaths = ResPaths(resRoots);
     // Load content
     for (auto& pack : allPacks) {
-        ContentLoader(&pack, contentBuilder, paths.resPaths).load();
+        ContentCache cache(
+            ContentCache::FOLDER / (pack.id + ".cache"), pack.folder.string()
+        );
+        ContentLoader(&pack, contentBuilder, paths.resPaths, &cache).load();
+        cache.save();
+        logger.info() << "pack [" << pack.id << "] data files cached: "
+                      << cache.getHits() << ", parsed: " << cache.getMisses();
         load_configs(input, pack.folder);
     }
     content = contentBuilder.build();
@@ -7,6 +7,7 @@
 
 #include "loading/ContentUnitLoader.hpp"
 #include "ContentBuilder.hpp"
+#include "ContentCache.hpp"
 #include "ContentPack.hpp"
 #include "debug/Logger.hpp"
 #include "logic/scripting/scripting.hpp"
@@ -18,9 +19,12 @@
 static debug::Logger logger("content-loader");
 
 ContentLoader::ContentLoader(
-    ContentPack* pack, ContentBuilder& builder, const ResPaths& paths
+    ContentPack* pack,
+    ContentBuilder& builder,
+    const ResPaths& paths,
+    ContentCache* cache
 )
-    : pack(pack), builder(builder), paths(paths) {
+    : pack(pack), builder(builder), paths(paths), cache(cache) {
     auto runtime = std::make_unique<ContentPackRuntime>(
         *pack, scripting::create_pack_environment(*pack)
     );
@@ -186,7 +190,7 @@ void ContentUnitLoader<DefT>::loadUnit(
 void ContentLoader::loadBlockMaterial(
     BlockMaterial& def, const io::path& file
 ) {
-    def.deserialize(io::read_json(file));
+    def.deserialize(read_cached(cache, file));
     if (def.hitSound.empty()) {
         def.hitSound = def.stepsSound;
     }
@@ -205,7 +209,7 @@ void ContentUnitLoader<DefT>::loadDefs(const dv::value& root) {
         auto configFile = pack.folder / (prefix + "/" + name + ".json");
         std::string parent;
         if (io::exists(configFile)) {
-            auto root = io::read_json(configFile);
+            auto root = read_cached(cache, configFile);
             root.at("parent").get(parent);
         }
         return parent;
@@ -295,10 +299,13 @@ void ContentLoader::loadContent(const dv::value& root) {
                 item.emission[j] = def.emission[j];
             }
         }
-    }).loadDefs(root);
+    }, cache).loadDefs(root);
 
-    ContentUnitLoader(*pack, builder.items, "items").loadDefs(root);
-    ContentUnitLoader(*pack, builder.entities, "entities").loadDefs(root);
+    ContentUnitLoader<ItemDef>(*pack, builder.items, "items", nullptr, cache)
+        .loadDefs(root);
+    ContentUnitLoader<EntityDef>(
+        *pack, builder.entities, "entities", nullptr, cache
+    ).loadDefs(root);
 
     stats->totalBlocks = builder.blocks.defs.size() - prevStats.totalBlocks;
     stats->totalItems = builder.items.defs.size() - prevStats.totalItems;
@@ -359,7 +366,7 @@ void ContentLoader::load() {
     // Load pack resources.json
     io::path resourcesFile = folder / "resources.json";
     if (io::exists(resourcesFile)) {
-        auto resRoot = io::read_json(resourcesFile);
+        auto resRoot = read_cached(cache, resourcesFile);
         for (const auto& [key, arr] : resRoot.asObject()) {
             ResourceType type;
             if (ResourceTypeMeta.getItem(key, type)) {
@@ -374,7 +381,7 @@ void ContentLoader::load() {
     // Load pack resources aliases
     io::path aliasesFile = folder / "resource-aliases.json";
     if (io::exists(aliasesFile)) {
-        auto resRoot = io::read_json(aliasesFile);
+        auto resRoot = read_cached(cache, aliasesFile);
         for (const auto& [key, arr] : resRoot.asObject()) {
             ResourceType type;
             if (ResourceTypeMeta.getItem(key, type)) {
@@ -412,13 +419,13 @@ void ContentLoader::load() {
     // Process content.json and load defined content units
     auto contentFile = pack->getContentFile();
     if (io::exists(contentFile)) {
-        loadContent(io::read_json(contentFile));
+        loadContent(read_cached(cache, contentFile));
     }
 
     // Load attached tags
     io::path tagsFile = folder / "tags.toml";
     if (io::exists(tagsFile)) {
-        auto tagsMap = io::read_object(tagsFile);
+        auto tagsMap = read_cached(cache, tagsFile);
         for (const auto& [key, list] : tagsMap.asObject()) {
             for (const auto& id : list) {
                 const auto& stringId = id.asString();
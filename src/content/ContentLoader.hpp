@@ -18,6 +18,7 @@ class ResPaths;
 class Content;
 class ContentBuilder;
 class ContentPackRuntime;
+class ContentCache;
 struct ContentPackStats;
 
 class ContentLoader {
@@ -27,11 +28,12 @@ class ContentLoader {
     ContentBuilder& builder;
     ContentPackStats* stats;
     const ResPaths& paths;
+    ContentCache* cache;
 
     void loadGenerator(
         GeneratorDef& def, const std::string& full, const std::string& name
     );
-    static void loadBlockMaterial(BlockMaterial& def, const io::path& file);
+    void loadBlockMaterial(BlockMaterial& def, const io::path& file);
     void loadResources(ResourceType type, const dv::value& list);
     void loadResourceAliases(ResourceType type, const dv::value& aliases);
 
@@ -40,7 +42,8 @@ public:
     ContentLoader(
         ContentPack* pack,
         ContentBuilder& builder,
-        const ResPaths& paths
+        const ResPaths& paths,
+        ContentCache* cache = nullptr
     );
 
     // Refresh pack content.json
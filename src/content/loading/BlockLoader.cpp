@@ -3,6 +3,7 @@
 #include "ContentLoadingCommons.hpp"
 
 #include "../ContentBuilder.hpp"
+#include "../ContentCache.hpp"
 #include "coders/json.hpp"
 #include "core_defs.hpp"
 #include "data/dv.hpp"
@@ -65,7 +66,7 @@ static void load_variant(
     if (BlockModelTypeMeta.getItem(modelTypeName, model.type)) {
         if (model.type == BlockModelType::CUSTOM && model.customRaw == nullptr) {
             if (root.has("model-primitives")) {
-                model.customRaw = root["model-primitives"];
+                model.customRaw = dv::to_heap(root["model-primitives"]);
             } else if (model.name.empty()) {
                 throw std::runtime_error(
                     name + ": no 'model-primitives' or 'model-name' found"
@@ -87,7 +88,7 @@ static void load_variant(
 template<> void ContentUnitLoader<Block>::loadUnit(
     Block& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = read_cached(cache, file, std::make_shared<dv::Arena>());
     process_properties(def, name, root);
     process_tags(def, root);
 
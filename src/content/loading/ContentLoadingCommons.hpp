@@ -13,12 +13,13 @@ inline void process_properties(T& def, const std::string& name, const dv::value&
     for (auto& [key, value] : root.asObject()) {
         auto pos = key.rfind('@');
         if (pos == std::string::npos) {
-            def.properties[key] = value;
+            // properties outlive the file tree and its arena
+            def.properties[key] = dv::to_heap(value);
             continue;
         }
         auto field = key.substr(0, pos);
         auto suffix = key.substr(pos + 1);
-        process_method(def.properties, suffix, field, value);
+        process_method(def.properties, suffix, field, dv::to_heap(value));
     }
 }
 
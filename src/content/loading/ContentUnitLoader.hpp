@@ -7,6 +7,7 @@
 #include "data/dv_fwd.hpp"
 
 struct ContentPack;
+class ContentCache;
 
 template<typename T> class ContentUnitBuilder;
 
@@ -17,12 +18,14 @@ public:
         const ContentPack& pack,
         ContentUnitBuilder<DefT>& builder,
         const std::string& defsDir,
-        std::function<void(DefT&)> postFunc = nullptr
+        std::function<void(DefT&)> postFunc = nullptr,
+        ContentCache* cache = nullptr
     )
         : pack(pack),
           builder(builder),
           defsDir(defsDir),
-          postFunc(std::move(postFunc)) {
+          postFunc(std::move(postFunc)),
+          cache(cache) {
     }
     void loadUnit(DefT& def, const std::string& full, const std::string& name);
     void loadUnit(DefT& def, const std::string& name, const io::path& file);
@@ -32,6 +35,7 @@ private:
     ContentUnitBuilder<DefT>& builder;
     std::string defsDir;
     std::function<void(DefT&)> postFunc;
+    ContentCache* cache;
 };
 
 void process_method(
@@ -3,6 +3,7 @@
 #include "ContentLoadingCommons.hpp"
 
 #include "../ContentBuilder.hpp"
+#include "../ContentCache.hpp"
 #include "coders/json.hpp"
 #include "core_defs.hpp"
 #include "data/dv.hpp"
@@ -17,7 +18,7 @@ static debug::Logger logger("item-content-loader");
 template<> void ContentUnitLoader<ItemDef>::loadUnit(
     ItemDef& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = read_cached(cache, file, std::make_shared<dv::Arena>());
     process_properties(def, name, root);
     process_tags(def, root);
 
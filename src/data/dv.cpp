@@ -80,25 +80,25 @@ namespace dv {
 
     value& value::object(const key_t& key) {
         reference ref = this->operator[](key);
-        ref = dv::object();
+        ref = dv::object(val.object->get_allocator().getArena());
         return ref;
     }
 
     value& value::list(const key_t& key) {
         reference ref = this->operator[](key);
-        ref = dv::list();
+        ref = dv::list(val.object->get_allocator().getArena());
         return ref;
     }
 
     value& value::object() {
         check_type(type, value_type::list);
-        val.list->push_back(std::make_shared<objects::Object>());
+        val.list->push_back(dv::object(val.list->get_allocator().getArena()));
         return val.list->operator[](val.list->size()-1);
     }
 
     value& value::list() {
         check_type(type, value_type::list);
-        val.list->push_back(std::make_shared<objects::List>());
+        val.list->push_back(dv::list(val.list->get_allocator().getArena()));
         return val.list->operator[](val.list->size()-1);
     }
 
@@ -172,6 +172,17 @@ namespace dv {
         return *val.object;
     }
 
+    std::shared_ptr<Arena> value::getArena() const {
+        switch (type) {
+            case value_type::list:
+                return val.list->get_allocator().getArena();
+            case value_type::object:
+                return val.object->get_allocator().getArena();
+            default:
+                return nullptr;
+        }
+    }
+
     size_t value::size() const noexcept {
         switch (type) {
             case value_type::list:
@@ -201,6 +212,27 @@ namespace dv {
         check_type(type, value_type::list);
         val.list->erase(val.list->begin() + index);
     }
+
+    value to_heap(const value& src) {
+        switch (src.getType()) {
+            case value_type::object: {
+                auto dst = dv::object();
+                for (const auto& [key, elem] : src.asObject()) {
+                    dst[key] = to_heap(elem);
+                }
+                return dst;
+            }
+            case value_type::list: {
+                auto dst = dv::list();
+                for (const auto& elem : src) {
+                    dst.add(to_heap(elem));
+                }
+                return dst;
+            }
+            default:
+                return src;
+        }
+    }
 }
 
 #include "coders/json.hpp"
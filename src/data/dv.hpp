@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <unordered_map>
 
+#include "dv_arena.hpp"
+
 namespace util {
     template<class T> class Buffer;
 }
@@ -47,16 +49,21 @@ namespace dv {
 
     class value;
 
-    using list_t = std::vector<value>;
-    using map_t = std::unordered_map<key_t, value>;
     using pair = std::pair<const key_t, value>;
+    using list_t = std::vector<value, arena_allocator<value>>;
+    using map_t = std::unordered_map<
+        key_t,
+        value,
+        std::hash<key_t>,
+        std::equal_to<key_t>,
+        arena_allocator<pair>>;
 
     using reference = value&;
     using const_reference = const value&;
 
     namespace objects {
-        using Object = std::unordered_map<key_t, value>;
-        using List = std::vector<value>;
+        using Object = map_t;
+        using List = list_t;
         using Bytes = util::Buffer<byte_t>;
     }
 
@@ -416,6 +423,9 @@ namespace dv {
 
         const objects::Object& asObject() const;
 
+        /// @return Arena the object or list is allocated in or nullptr
+        std::shared_ptr<Arena> getArena() const;
+
         inline value_type getType() const {
             return type;
         }
@@ -538,6 +548,31 @@ namespace dv {
         return std::make_shared<objects::List>(std::move(values));
     }
 
+    /// @brief Create object allocated in the arena
+    /// @param arena arena, heap is used if nullptr
+    inline value object(const std::shared_ptr<Arena>& arena) {
+        if (arena == nullptr) {
+            return object();
+        }
+        arena_allocator<objects::Object> allocator(arena);
+        return std::allocate_shared<objects::Object>(allocator, allocator);
+    }
+
+    /// @brief Create list allocated in the arena
+    /// @param arena arena, heap is used if nullptr
+    inline value list(const std::shared_ptr<Arena>& arena) {
+        if (arena == nullptr) {
+            return list();
+        }
+        arena_allocator<objects::List> allocator(arena);
+        return std::allocate_shared<objects::List>(allocator, allocator);
+    }
+
+    /// @brief Deep copy of the value with all objects and lists allocated
+    /// in heap. Use to keep a part of an arena-backed tree without keeping
+    /// the whole arena alive
+    value to_heap(const value& value);
+
     template<typename T> inline bool get_to_int(value* ptr, T& dst) {
         if (ptr) {
             dst = ptr->asInteger();
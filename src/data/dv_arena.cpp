@@ -0,0 +1,32 @@
+#include "dv_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace dv;
+
+Arena::Arena(size_t blockSize) : blockSize(blockSize) {
+}
+
+Arena::~Arena() = default;
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(ptr);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (ptr == nullptr || padding + size > remaining) {
+        size_t newBlockSize = std::max(blockSize, size + alignment);
+        blocks.emplace_back(new unsigned char[newBlockSize]);
+        ptr = blocks.back().get();
+        remaining = newBlockSize;
+        blockSize = std::min(blockSize * 2, MAX_BLOCK_SIZE);
+
+        address = reinterpret_cast<uintptr_t>(ptr);
+        padding = (alignment - address % alignment) % alignment;
+    }
+    void* result = ptr + padding;
+    ptr += padding + size;
+    remaining -= padding + size;
+    allocated += size;
+    allocations++;
+    return result;
+}
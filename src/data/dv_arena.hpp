@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace dv {
+    /// @brief Monotonic memory arena for dv trees. Memory is released only
+    /// when the arena is destroyed, which happens when the last container
+    /// allocated from it is released.
+    /// Arena is not thread-safe: containers sharing an arena must not be
+    /// modified concurrently.
+    class Arena {
+    public:
+        /// @param blockSize size of the first memory block.
+        /// Next blocks are twice as large up to MAX_BLOCK_SIZE
+        explicit Arena(size_t blockSize = 4096);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t size, size_t alignment);
+
+        /// @return Total size of allocations made
+        size_t getAllocated() const {
+            return allocated;
+        }
+
+        /// @return Number of allocations made
+        size_t getAllocations() const {
+            return allocations;
+        }
+
+        /// @return Number of memory blocks allocated from heap
+        size_t getBlocksCount() const {
+            return blocks.size();
+        }
+
+        static constexpr size_t MAX_BLOCK_SIZE = 256 * 1024;
+    private:
+        std::vector<std::unique_ptr<unsigned char[]>> blocks;
+        size_t blockSize;
+        unsigned char* ptr = nullptr;
+        size_t remaining = 0;
+        size_t allocated = 0;
+        size_t allocations = 0;
+    };
+
+    /// @brief Allocator used by dv containers. Uses the arena if provided,
+    /// otherwise the global heap. Containers copied from arena-backed ones
+    /// are allocated in heap, copy assignment keeps the target allocator.
+    template <typename T>
+    class arena_allocator {
+        std::shared_ptr<Arena> arena;
+
+        template <typename U>
+        friend class arena_allocator;
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        arena_allocator() noexcept = default;
+
+        arena_allocator(std::shared_ptr<Arena> arena) noexcept
+            : arena(std::move(arena)) {
+        }
+
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& other) noexcept
+            : arena(other.arena) {
+        }
+
+        T* allocate(size_t n) {
+            if (arena) {
+                return static_cast<T*>(
+                    arena->allocate(n * sizeof(T), alignof(T))
+                );
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            // arena memory is released with the arena
+            if (arena == nullptr) {
+                ::operator delete(ptr);
+            }
+        }
+
+        arena_allocator select_on_container_copy_construction() const {
+            return arena_allocator();
+        }
+
+        const std::shared_ptr<Arena>& getArena() const {
+            return arena;
+        }
+
+        template <typename U>
+        bool operator==(const arena_allocator<U>& other) const noexcept {
+            return arena == other.arena;
+        }
+
+        template <typename U>
+        bool operator!=(const arena_allocator<U>& other) const noexcept {
+            return arena != other.arena;
+        }
+    };
+}
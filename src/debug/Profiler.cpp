@@ -0,0 +1,161 @@
+#include "Profiler.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "util/stringutil.hpp"
+
+using namespace debug;
+
+std::atomic<bool> Profiler::enabled = false;
+
+struct ZoneRecord {
+    const char* name;
+    int64_t begin;
+    int64_t end;
+};
+
+struct OpenZone {
+    const char* name;
+    int64_t begin;
+};
+
+struct ThreadBuffer {
+    uint32_t tid;
+    std::string name;
+    /// @brief Protects records from concurrent export
+    std::mutex mutex;
+    std::vector<ZoneRecord> records;
+    uint64_t recorded = 0;
+    /// @brief Zones begun but not ended yet, accessed by the owner only
+    std::vector<OpenZone> stack;
+};
+
+static std::mutex buffersMutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+static uint32_t nextThreadId = 1;
+static thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+static thread_local std::string threadName;
+
+static std::mutex namesMutex;
+static std::unordered_set<std::string> names;
+
+static const auto epoch = std::chrono::steady_clock::now();
+
+static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - epoch
+    ).count();
+}
+
+static ThreadBuffer& get_buffer() {
+    if (threadBuffer == nullptr) {
+        threadBuffer = std::make_shared<ThreadBuffer>();
+        threadBuffer->name = threadName;
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        threadBuffer->tid = nextThreadId++;
+        buffers.push_back(threadBuffer);
+    }
+    return *threadBuffer;
+}
+
+void Profiler::setEnabled(bool flag) {
+    enabled = flag;
+}
+
+void Profiler::begin(const char* name) {
+    get_buffer().stack.push_back(OpenZone {name, now()});
+}
+
+bool Profiler::end() {
+    auto& buffer = get_buffer();
+    if (buffer.stack.empty()) {
+        return false;
+    }
+    auto zone = buffer.stack.back();
+    buffer.stack.pop_back();
+    ZoneRecord record {zone.name, zone.begin, now()};
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.records.size() < BUFFER_CAPACITY) {
+        buffer.records.push_back(record);
+    } else {
+        buffer.records[buffer.recorded % BUFFER_CAPACITY] = record;
+    }
+    buffer.recorded++;
+    return true;
+}
+
+const char* Profiler::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    // unordered_set elements are not moved on rehash
+    return names.insert(name).first->c_str();
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    // buffer is not created until the thread records a zone
+    threadName = name;
+    if (threadBuffer) {
+        std::lock_guard<std::mutex> lock(threadBuffer->mutex);
+        threadBuffer->name = name;
+    }
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        // buffer of a finished thread
+        if (it->use_count() == 1) {
+            it = buffers.erase(it);
+            continue;
+        }
+        auto& buffer = **it;
+        std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+        buffer.records.clear();
+        buffer.recorded = 0;
+        ++it;
+    }
+}
+
+static void write_time(std::ostream& stream, int64_t nanoseconds) {
+    stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0')
+           << nanoseconds % 1000;
+}
+
+void Profiler::writeTrace(std::ostream& stream) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& bufferPtr : buffers) {
+        auto& buffer = *bufferPtr;
+        std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+
+        std::string name = buffer.name.empty()
+                               ? "thread-" + std::to_string(buffer.tid)
+                               : buffer.name;
+        stream << (first ? "\n" : ",\n");
+        first = false;
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << buffer.tid << ",\"args\":{\"name\":"
+               << util::escape(name, false) << "}}";
+
+        size_t count = buffer.records.size();
+        // the oldest record is overwritten next
+        size_t start = buffer.recorded > count ? buffer.recorded % count : 0;
+        for (size_t i = 0; i < count; i++) {
+            const auto& record = buffer.records[(start + i) % count];
+            stream << ",\n{\"name\":" << util::escape(record.name, false)
+                   << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.tid
+                   << ",\"ts\":";
+            write_time(stream, record.begin);
+            stream << ",\"dur\":";
+            write_time(stream, record.end - record.begin);
+            stream << "}";
+        }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
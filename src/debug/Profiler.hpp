@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+namespace debug {
+    /// @brief Hierarchical zones profiler. Each thread writes completed
+    /// zones to its own ring buffer, overwriting the oldest ones when it's
+    /// full. Nothing is recorded while the profiler is disabled
+    class Profiler {
+        static std::atomic<bool> enabled;
+    public:
+        /// @brief Max number of completed zones stored per thread
+        static constexpr size_t BUFFER_CAPACITY = 1 << 15;
+
+        static bool isEnabled() {
+            return enabled.load(std::memory_order_relaxed);
+        }
+
+        static void setEnabled(bool flag);
+
+        /// @brief Begin zone in the current thread
+        /// @param name zone name, must stay valid while zones are recorded.
+        /// Use intern for dynamic names
+        static void begin(const char* name);
+
+        /// @brief End the last zone begun in the current thread
+        /// @return false if there is no zone to end
+        static bool end();
+
+        /// @brief Get permanent copy of a zone name
+        static const char* intern(const std::string& name);
+
+        /// @brief Set current thread name shown in trace
+        static void setThreadName(const std::string& name);
+
+        /// @brief Remove all recorded zones
+        static void clear();
+
+        /// @brief Write recorded zones in Chrome trace event format
+        /// (supported by chrome://tracing and Perfetto)
+        static void writeTrace(std::ostream& stream);
+    };
+
+    /// @brief Scoped profiler zone. Does nothing if the profiler is disabled
+    class ProfileZone {
+        bool active;
+    public:
+        explicit ProfileZone(const char* name)
+            : active(Profiler::isEnabled()) {
+            if (active) {
+                Profiler::begin(name);
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        ~ProfileZone() {
+            if (active) {
+                Profiler::end();
+            }
+        }
+    };
+}
@@ -3,6 +3,24 @@
 #include <string>
 #include <filesystem>
 
+/// @brief Headless load test with synthetic players
+struct LoadTestParameters {
+    /// @brief Number of synthetic players, 0 disables load test
+    int players = 0;
+    /// @brief Number of simulated ticks
+    int ticks = 6000;
+    /// @brief Players speed (blocks per second)
+    float speed = 10.0f;
+    /// @brief Players trajectory: random, line or circle
+    std::string trajectory = "random";
+    std::string seed = "0";
+    std::string generator = "core:default";
+    /// @brief Optional json report output file
+    std::filesystem::path reportFile;
+    /// @brief Allow to replace existing load test world
+    bool overwrite = false;
+};
+
 struct CoreParameters {
     bool headless = false;
     bool testMode = false;
@@ -11,5 +29,7 @@ struct CoreParameters {
     std::filesystem::path scriptFile;
     std::filesystem::path projectFolder;
     std::string debugServerString;
+    std::filesystem::path profileFile;
     int tps = 20;
+    LoadTestParameters loadTest;
 };
@@ -35,6 +35,7 @@
 #include "window/Window.hpp"
 #include "world/Level.hpp"
 #include "Mainloop.hpp"
+#include "LoadTestMainloop.hpp"
 #include "ServerMainloop.hpp"
 #include "WindowControl.hpp"
 #include "EnginePaths.hpp"
@@ -233,7 +234,9 @@ void Engine::updateHotkeys() {
 }
 
 void Engine::run() {
-    if (params.headless) {
+    if (params.headless && params.loadTest.players > 0) {
+        LoadTestMainloop(*this).run();
+    } else if (params.headless) {
         ServerMainloop(*this).run();
     } else {
         Mainloop(*this).run();
@@ -0,0 +1,242 @@
+#include "LoadTestMainloop.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <glm/gtc/constants.hpp>
+
+#include "Engine.hpp"
+#include "EnginePaths.hpp"
+#include "coders/json.hpp"
+#include "content/ContentControl.hpp"
+#include "content/PacksManager.hpp"
+#include "debug/Logger.hpp"
+#include "io/io.hpp"
+#include "logic/EngineController.hpp"
+#include "logic/LevelController.hpp"
+#include "objects/Player.hpp"
+#include "objects/Players.hpp"
+#include "util/platform.hpp"
+#include "voxels/GlobalChunks.hpp"
+#include "world/Level.hpp"
+#include "world/LevelEvents.hpp"
+#include "world/World.hpp"
+
+using namespace std::chrono;
+
+static debug::Logger logger("load-test");
+
+/// @brief Name of the world created by the load test
+static const std::string WORLD_NAME = "load-test";
+/// @brief Players height, chunks loading does not depend on it
+static constexpr float PLAYER_Y = 100.0f;
+/// @brief Random walk heading change interval (ticks)
+static constexpr int HEADING_CHANGE_INTERVAL = 100;
+static constexpr float CIRCLE_RADIUS = 128.0f;
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static double millis_since(steady_clock::time_point since) {
+    return duration_cast<nanoseconds>(steady_clock::now() - since).count() /
+           1e6;
+}
+
+LoadTestMainloop::LoadTestMainloop(Engine& engine)
+    : engine(engine), params(engine.getCoreParameters().loadTest) {
+}
+
+LoadTestMainloop::~LoadTestMainloop() = default;
+
+void LoadTestMainloop::createWorld() {
+    auto& paths = engine.getPaths();
+    auto folder = paths.getWorldsFolder() / WORLD_NAME;
+    if (io::exists(folder)) {
+        if (!params.overwrite) {
+            throw std::runtime_error(
+                "world '" + WORLD_NAME +
+                "' already exists, use --load-overwrite to replace it"
+            );
+        }
+        logger.info() << "removing previous load test world";
+        io::remove_all(folder);
+    }
+    auto& contentControl = engine.getContentControl();
+    auto& manager = contentControl.scan();
+    contentControl.setContentPacksRaw(manager.getAll(manager.assemble({"base"})));
+
+    engine.setLevelConsumer([this](auto level, auto) {
+        if (level == nullptr) {
+            return;
+        }
+        controller = std::make_unique<LevelController>(
+            &engine, std::move(level), nullptr
+        );
+    });
+    engine.getController()->createWorld(
+        WORLD_NAME, params.seed, params.generator
+    );
+    if (controller == nullptr) {
+        throw std::runtime_error("could not create load test world");
+    }
+}
+
+void LoadTestMainloop::spawnPlayers() {
+    auto& level = *controller->getLevel();
+    uint32_t seed = std::hash<std::string>()(params.seed);
+    std::mt19937 random(seed);
+
+    float spread = 64.0f * std::sqrt(static_cast<float>(params.players));
+    std::uniform_real_distribution<float> position(-spread, spread);
+    std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+    for (int i = 0; i < params.players; i++) {
+        auto player = level.players->create();
+        player->setName("load-test-" + std::to_string(i));
+        player->setFlight(true);
+        player->setNoclip(true);
+
+        glm::vec2 origin(position(random), position(random));
+        float heading = params.trajectory == "line"
+                            ? glm::two_pi<float>() * i / params.players
+                            : angle(random);
+        players.push_back(SyntheticPlayer {
+            player, origin, origin, heading, std::mt19937(seed + i + 1)});
+        player->teleport(glm::vec3(origin.x, PLAYER_Y, origin.y));
+    }
+}
+
+void LoadTestMainloop::movePlayers(float delta, int tick) {
+    float distance = params.speed * delta;
+    for (auto& synthetic : players) {
+        if (params.trajectory == "circle") {
+            synthetic.heading += distance / CIRCLE_RADIUS;
+            synthetic.position =
+                synthetic.origin +
+                glm::vec2(
+                    glm::cos(synthetic.heading), glm::sin(synthetic.heading)
+                ) * CIRCLE_RADIUS;
+        } else {
+            if (params.trajectory == "random" &&
+                tick % HEADING_CHANGE_INTERVAL == 0) {
+                std::uniform_real_distribution<float> turn(
+                    -glm::half_pi<float>(), glm::half_pi<float>()
+                );
+                synthetic.heading += turn(synthetic.random);
+            }
+            synthetic.position +=
+                glm::vec2(
+                    glm::cos(synthetic.heading), glm::sin(synthetic.heading)
+                ) * distance;
+        }
+        synthetic.player->teleport(glm::vec3(
+            synthetic.position.x, PLAYER_Y, synthetic.position.y
+        ));
+    }
+}
+
+void LoadTestMainloop::run() {
+    const auto& coreParams = engine.getCoreParameters();
+    auto& time = engine.getTime();
+
+    if (params.trajectory != "random" && params.trajectory != "line" &&
+        params.trajectory != "circle") {
+        throw std::runtime_error(
+            "unknown load test trajectory '" + params.trajectory + "'"
+        );
+    }
+    createWorld();
+    spawnPlayers();
+
+    auto& level = *controller->getLevel();
+    size_t chunkLoads = 0;
+    size_t chunkUnloads = 0;
+    level.events->listen(
+        LevelEventType::CHUNK_PRESENT,
+        [&chunkLoads](auto, auto) { chunkLoads++; }
+    );
+    level.events->listen(
+        LevelEventType::CHUNK_UNLOAD,
+        [&chunkUnloads](auto, auto) { chunkUnloads++; }
+    );
+    logger.info() << "running " << params.ticks << " ticks with "
+                  << params.players << " players (" << params.trajectory
+                  << ", " << params.speed << " blocks/s)";
+
+    double delta = 1.0 / static_cast<double>(coreParams.tps);
+    std::vector<double> tickTimes;
+    tickTimes.reserve(params.ticks);
+    auto begin = steady_clock::now();
+    for (int tick = 0; tick < params.ticks; tick++) {
+        if (engine.isQuitSignal()) {
+            logger.info() << "load test has been terminated due to quit signal";
+            break;
+        }
+        movePlayers(delta, tick);
+
+        auto tickBegin = steady_clock::now();
+        time.step(delta);
+        level.getWorld()->updateTimers(delta);
+        controller->update(delta, false);
+        engine.applicationTick();
+        engine.postUpdate();
+        tickTimes.push_back(millis_since(tickBegin));
+    }
+    double elapsed = millis_since(begin) / 1e3;
+    double simulated = tickTimes.size() * delta;
+    size_t uniqueChunks = level.chunks->size();
+
+    auto saveBegin = steady_clock::now();
+    controller->processBeforeQuit();
+    controller->saveWorld();
+    double saveTime = millis_since(saveBegin);
+
+    std::vector<double> sorted = tickTimes;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double value : tickTimes) {
+        total += value;
+    }
+
+    auto report = dv::object();
+    report["players"] = params.players;
+    report["ticks"] = static_cast<dv::integer_t>(tickTimes.size());
+    report["tps"] = coreParams.tps;
+    report["speed"] = params.speed;
+    report["trajectory"] = params.trajectory;
+    report["seed"] = params.seed;
+    report["generator"] = params.generator;
+    auto& tickTime = report.object("tick_time_ms");
+    tickTime["mean"] = tickTimes.empty() ? 0.0 : total / tickTimes.size();
+    tickTime["p50"] = percentile(sorted, 0.5);
+    tickTime["p90"] = percentile(sorted, 0.9);
+    tickTime["p99"] = percentile(sorted, 0.99);
+    tickTime["max"] = sorted.empty() ? 0.0 : sorted.back();
+    report["chunk_loads"] = static_cast<dv::integer_t>(chunkLoads);
+    report["chunk_unloads"] = static_cast<dv::integer_t>(chunkUnloads);
+    report["chunk_loads_per_second"] =
+        simulated > 0.0 ? chunkLoads / simulated : 0.0;
+    report["chunk_loads_per_wall_second"] =
+        elapsed > 0.0 ? chunkLoads / elapsed : 0.0;
+    report["unique_chunks"] = static_cast<dv::integer_t>(uniqueChunks);
+    report["peak_memory_bytes"] =
+        static_cast<dv::integer_t>(platform::get_peak_memory_usage());
+    report["save_time_ms"] = saveTime;
+    report["elapsed_seconds"] = elapsed;
+
+    auto text = json::stringify(report, true);
+    logger.info() << "load test report:\n" << text;
+    if (!params.reportFile.empty()) {
+        std::ofstream file(params.reportFile);
+        file << text;
+        logger.info() << "report written to " << params.reportFile.u8string();
+    }
+
+    controller->onWorldQuit();
+    engine.getPaths().setCurrentWorldFolder("");
+    controller = nullptr;
+}
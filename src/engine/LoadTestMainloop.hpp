@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Engine;
+class LevelController;
+class Player;
+struct LoadTestParameters;
+
+/// @brief Headless capacity benchmark. Creates a new world, spawns
+/// synthetic players moving along deterministic trajectories and runs
+/// the regular level update with a fixed delta, then reports tick time
+/// percentiles, chunk loads rate, memory use and world save time
+class LoadTestMainloop {
+    struct SyntheticPlayer {
+        Player* player;
+        glm::vec2 origin;
+        glm::vec2 position;
+        /// @brief Movement direction angle (radians)
+        float heading;
+        std::mt19937 random;
+    };
+
+    Engine& engine;
+    const LoadTestParameters& params;
+    std::unique_ptr<LevelController> controller;
+    std::vector<SyntheticPlayer> players;
+
+    void createWorld();
+    void spawnPlayers();
+    void movePlayers(float delta, int tick);
+public:
+    LoadTestMainloop(Engine& engine);
+    ~LoadTestMainloop();
+
+    void run();
+};
@@ -6,11 +6,13 @@
 #include "logic/LevelController.hpp"
 #include "interfaces/Process.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "util/platform.hpp"
 
 #include <chrono>
+#include <fstream>
 
 using namespace std::chrono;
 
@@ -37,6 +39,12 @@ void ServerMainloop::run() {
         "script:" + coreParams.scriptFile.filename().u8string()
     );
 
+    bool profiling = !coreParams.profileFile.empty();
+    if (profiling) {
+        debug::Profiler::setThreadName("main");
+        debug::Profiler::setEnabled(true);
+    }
+
     double targetDelta = 1.0 / static_cast<double>(coreParams.tps);
     double delta = targetDelta;
     auto begin = system_clock::now();
@@ -56,13 +64,16 @@ void ServerMainloop::run() {
                 duration_cast<microseconds>(now - startupTime).count() / 1e6);
             delta = time.getDelta();
         }
-        process->update();
-        if (controller) {
-            controller->getLevel()->getWorld()->updateTimers(delta);
-            controller->update(glm::min(delta, 0.2), false);
+        {
+            debug::ProfileZone zone("ServerMainloop::tick");
+            process->update();
+            if (controller) {
+                controller->getLevel()->getWorld()->updateTimers(delta);
+                controller->update(glm::min(delta, 0.2), false);
+            }
+            engine.applicationTick();
+            engine.postUpdate();
         }
-        engine.applicationTick();
-        engine.postUpdate();
 
         if (!coreParams.testMode) {
             auto end = system_clock::now();
@@ -75,6 +86,14 @@ void ServerMainloop::run() {
         }
     }
     logger.info() << "script finished";
+
+    if (profiling) {
+        debug::Profiler::setEnabled(false);
+        std::ofstream file(coreParams.profileFile);
+        debug::Profiler::writeTrace(file);
+        logger.info() << "profiling trace written to "
+                      << coreParams.profileFile.u8string();
+    }
 }
 
 void ServerMainloop::setLevel(std::unique_ptr<Level> level) {
@@ -167,6 +167,11 @@ std::shared_ptr<UINode> create_debug_panel(
         bool culling = settings.graphics.frustumCulling.get();
         return L"frustum-culling: " + std::wstring(culling ? L"on" : L"off");
     }));
+    panel->add(create_label(gui, [&engine]() {
+        auto& settings = engine.getSettings();
+        bool culling = settings.graphics.occlusionCulling.get();
+        return L"occlusion-culling: " + std::wstring(culling ? L"on" : L"off");
+    }));
     panel->add(create_label(gui, [=]() {
         return L"particles: " +
                std::to_wstring(ParticlesRenderer::visibleParticles) +
@@ -175,12 +180,25 @@ std::shared_ptr<UINode> create_debug_panel(
     }));
     panel->add(create_label(gui, [&]() {
         return L"chunks: " + std::to_wstring(level.chunks->size()) +
-               L" visible: " + std::to_wstring(ChunksRenderer::visibleChunks);
+               L" visible: " + std::to_wstring(ChunksRenderer::visibleChunks) +
+               L" occluded: " + std::to_wstring(ChunksRenderer::occludedChunks);
+    }));
+    panel->add(create_label(gui, [&]() {
+        const auto& cache = level.chunks->getEncodedChunks();
+        return L"encoded-chunks: " + std::to_wstring(cache.size()) +
+               L" hits: " + std::to_wstring(cache.getHits()) +
+               L" misses: " + std::to_wstring(cache.getMisses());
     }));
     panel->add(create_label(gui, [&]() {
         return L"entities: " + std::to_wstring(level.entities->size()) +
                L" next: " + std::to_wstring(level.entities->peekNextID());
     }));
+    panel->add(create_label(gui, [&]() {
+        return L"bodies: " +
+               std::to_wstring(level.entities->getActiveBodiesCount()) +
+               L" sleeping: " +
+               std::to_wstring(level.entities->getSleepingBodiesCount());
+    }));
     panel->add(create_label(gui, [&]() {
         return L"players: " + std::to_wstring(level.players->size()) +
                L" local: " + std::to_wstring(player.getId());
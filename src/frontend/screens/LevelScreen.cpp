@@ -82,6 +82,8 @@ LevelScreen::LevelScreen(
     };
     keepAlive(settings.graphics.backlight.observe(resetChunks));
     keepAlive(settings.graphics.softLighting.observe(resetChunks));
+    keepAlive(settings.graphics.greedyMeshing.observe(resetChunks));
+    keepAlive(settings.graphics.packedChunkVertices.observe(resetChunks));
     keepAlive(settings.graphics.denseRender.observe([=](bool flag) {
         resetChunks(flag);
         frontend->getContentGfxCache().refresh();
@@ -208,6 +210,8 @@ void LevelScreen::updateHotkeys() {
             renderer->toggleLightsDebug();
         } else if (input.jpressed(Keycode::O)) {
             settings.graphics.frustumCulling.toggle();
+        } else if (input.jpressed(Keycode::C)) {
+            settings.graphics.occlusionCulling.toggle();
         }
     }
 }
@@ -55,6 +55,15 @@ public:
         reload(vertexBuffer, vertexCount, indices);
     }
 
+    /// @brief Update single index buffer data keeping vertices. Existing
+    /// GL buffer is reused if indices count is not changed
+    /// @param iboIndex index of the element buffer, created if not exists
+    /// @param indices indices buffer
+    /// @param indicesCount number of indices
+    void reloadIndices(
+        size_t iboIndex, const uint32_t* indices, size_t indicesCount
+    );
+
     /// @brief Draw mesh with specified primitives type
     /// @param iboIndex index of used element buffer
     void draw(unsigned int primitive, int iboIndex = 0) const;
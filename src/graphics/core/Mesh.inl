@@ -119,6 +119,33 @@ void Mesh<VertexStructure>::reload(
     glBindVertexArray(0);
 }
 
+template <typename VertexStructure>
+void Mesh<VertexStructure>::reloadIndices(
+    size_t iboIndex, const uint32_t* indices, size_t indicesCount
+) {
+    glBindVertexArray(vao);
+    while (ibos.size() <= iboIndex) {
+        ibos.push_back(IndexBuffer {0, 0});
+        glGenBuffers(1, &ibos.back().ibo);
+    }
+    auto& buffer = ibos[iboIndex];
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.ibo);
+    if (buffer.indexCount == indicesCount && indicesCount != 0) {
+        glBufferSubData(
+            GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(uint32_t) * indicesCount, indices
+        );
+    } else {
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            sizeof(uint32_t) * indicesCount,
+            indices,
+            GL_DYNAMIC_DRAW
+        );
+        buffer.indexCount = indicesCount;
+    }
+    glBindVertexArray(0);
+}
+
 template <typename VertexStructure>
 void Mesh<VertexStructure>::draw(unsigned int primitive, int iboIndex) const {
     MeshStats::drawCalls++;
@@ -9,9 +9,39 @@
 #include "lighting/Lightmap.hpp"
 #include "frontend/ContentGfxCache.hpp"
 
+#include <algorithm>
+
 const glm::vec3 BlocksRenderer::SUN_VECTOR(0.528265, 0.833149, -0.163704);
 const float DIRECTIONAL_LIGHT_FACTOR = 0.3f;
 
+static inline std::array<uint8_t, 4> pack_color(const glm::vec4& light) {
+    return {
+        static_cast<uint8_t>(light.r * 255),
+        static_cast<uint8_t>(light.g * 255),
+        static_cast<uint8_t>(light.b * 255),
+        static_cast<uint8_t>(light.a * 255),
+    };
+}
+
+static inline std::array<uint8_t, 4> pack_normal(
+    const glm::vec3& normal, uint8_t emission
+) {
+    return {
+        static_cast<uint8_t>(normal.r * 127 + 128),
+        static_cast<uint8_t>(normal.g * 127 + 128),
+        static_cast<uint8_t>(normal.b * 127 + 128),
+        emission,
+    };
+}
+
+static inline uint16_t pack_uv(float value) {
+    return static_cast<uint16_t>(std::round(value * 0xFFFF));
+}
+
+static inline int axis_index(const glm::ivec3& axis) {
+    return axis.x ? 0 : (axis.y ? 1 : 2);
+}
+
 BlocksRenderer::BlocksRenderer(
     size_t capacity,
     const Content& content,
@@ -29,6 +59,7 @@ BlocksRenderer::BlocksRenderer(
     settings(settings)
 {
     blockDefsCache = content.getIndices()->blocks.getDefs();
+    greedyPlane.resize(CHUNK_H * std::max(CHUNK_W, CHUNK_D), -1);
 }
 
 BlocksRenderer::~BlocksRenderer() = default;
@@ -42,23 +73,38 @@ void BlocksRenderer::vertex(
     const glm::vec3& normal,
     float emission
 ) {
-    vertexBuffer[vertexCount].position = coord;
-
-    vertexBuffer[vertexCount].uv = {u,v};
-
-    vertexBuffer[vertexCount].normal[0] = static_cast<uint8_t>(normal.r * 127 + 128);
-    vertexBuffer[vertexCount].normal[1] = static_cast<uint8_t>(normal.g * 127 + 128);
-    vertexBuffer[vertexCount].normal[2] = static_cast<uint8_t>(normal.b * 127 + 128);
-    vertexBuffer[vertexCount].normal[3] = static_cast<uint8_t>(emission * 255);
-
-    vertexBuffer[vertexCount].color[0] = static_cast<uint8_t>(light.r * 255);
-    vertexBuffer[vertexCount].color[1] = static_cast<uint8_t>(light.g * 255);
-    vertexBuffer[vertexCount].color[2] = static_cast<uint8_t>(light.b * 255);
-    vertexBuffer[vertexCount].color[3] = static_cast<uint8_t>(light.a * 255);
+    auto& vertex = vertexBuffer[vertexCount];
+    vertex.position = coord;
+    vertex.uv = {u,v};
+    vertex.normal = pack_normal(normal, static_cast<uint8_t>(emission * 255));
+    vertex.color = pack_color(light);
 
     vertexCount++;
 }
 
+/// @brief Vertex of a merged face with repeated texture region
+void BlocksRenderer::tiledVertex(
+    const glm::vec3& coord,
+    float u,
+    float v,
+    const GreedyFace& face,
+    const glm::vec3& normal
+) {
+    TiledChunkVertex tiled;
+    auto& vertex = tiled.vertex;
+    vertex.position = coord;
+    vertex.uv = {u, v};
+    vertex.normal = pack_normal(normal, face.emission);
+    vertex.color = face.color;
+    tiled.region = {
+        pack_uv(face.region.u1),
+        pack_uv(face.region.v1),
+        pack_uv(face.region.u2),
+        pack_uv(face.region.v2),
+    };
+    tiledVertices.push_back(tiled);
+}
+
 void BlocksRenderer::index(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e, uint32_t f) {
     indexBuffer[indexCount++] = static_cast<uint32_t>(vertexOffset + a);
     indexBuffer[indexCount++] = static_cast<uint32_t>(vertexOffset + b);
@@ -377,6 +423,169 @@ void BlocksRenderer::blockCustomModel(
     }
 }
 
+void BlocksRenderer::greedyFace(
+    const glm::ivec3& coord,
+    int faceIndex,
+    const UVRegion& region,
+    bool lights,
+    bool ao
+) {
+    const auto& axes = CUBE_FACE_AXES[faceIndex];
+    glm::vec3 X(axes[0]);
+    glm::vec3 Y(axes[1]);
+    glm::vec3 Z(axes[2]);
+
+    float s = 0.5f;
+    const glm::vec3 corners[4] {
+        glm::vec3(coord) + (-X - Y + Z) * s,
+        glm::vec3(coord) + ( X - Y + Z) * s,
+        glm::vec3(coord) + ( X + Y + Z) * s,
+        glm::vec3(coord) + (-X + Y + Z) * s,
+    };
+    // same lights as calculated by faceAO and face
+    glm::vec4 colors[4];
+    if (lights) {
+        float d = glm::dot(Z, SUN_VECTOR);
+        d = (1.0f - DIRECTIONAL_LIGHT_FACTOR) + d * DIRECTIONAL_LIGHT_FACTOR;
+        if (ao) {
+            glm::vec4 tint(d);
+            for (int i = 0; i < 4; i++) {
+                auto pos = corners[i] + Z * 0.5f + (X + Y) * 0.5f;
+                colors[i] = pickSoftLight(
+                    glm::ivec3(
+                        std::round(pos.x), std::round(pos.y), std::round(pos.z)
+                    ),
+                    axes[0],
+                    axes[1]
+                ) * tint;
+            }
+        } else {
+            std::fill_n(colors, 4, pickLight(coord + axes[2]) * d);
+        }
+    } else {
+        std::fill_n(colors, 4, ao ? glm::vec4(1.0f) : glm::vec4(1, 1, 1, 0));
+    }
+    float emission = lights ? 0.0f : 1.0f;
+
+    auto color = pack_color(colors[0]);
+    if (color == pack_color(colors[1]) && color == pack_color(colors[2]) &&
+        color == pack_color(colors[3])) {
+        uint32_t layer = coord[axis_index(axes[2])];
+        uint32_t row = coord[axis_index(axes[1])];
+        uint32_t column = coord[axis_index(axes[0])];
+        greedyFaces[faceIndex].push_back(GreedyFace {
+            layer << 16 | row << 8 | column,
+            color,
+            static_cast<uint8_t>(emission * 255),
+            region
+        });
+        return;
+    }
+    if (vertexCount + 4 >= capacity || indexCount + 6 >= capacity) {
+        overflow = true;
+        return;
+    }
+    vertex(corners[0], region.u1, region.v1, colors[0], Z, emission);
+    vertex(corners[1], region.u2, region.v1, colors[1], Z, emission);
+    vertex(corners[2], region.u2, region.v2, colors[2], Z, emission);
+    vertex(corners[3], region.u1, region.v2, colors[3], Z, emission);
+    index(0, 1, 2, 0, 2, 3);
+}
+
+void BlocksRenderer::flushGreedyFaces() {
+    const int sizes[3] {CHUNK_W, CHUNK_H, CHUNK_D};
+    for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
+        auto& faces = greedyFaces[faceIndex];
+        if (faces.empty()) {
+            continue;
+        }
+        const auto& axes = CUBE_FACE_AXES[faceIndex];
+        glm::vec3 X(axes[0]);
+        glm::vec3 Y(axes[1]);
+        glm::vec3 Z(axes[2]);
+        int columnAxis = axis_index(axes[0]);
+        int rowAxis = axis_index(axes[1]);
+        int layerAxis = axis_index(axes[2]);
+        int width = sizes[columnAxis];
+        int height = sizes[rowAxis];
+
+        std::sort(faces.begin(), faces.end(), [](const auto& a, const auto& b) {
+            return a.position < b.position;
+        });
+        size_t layerStart = 0;
+        while (layerStart < faces.size()) {
+            uint32_t layer = faces[layerStart].position >> 16;
+            size_t layerEnd = layerStart;
+            for (; layerEnd < faces.size() &&
+                   (faces[layerEnd].position >> 16) == layer;
+                 layerEnd++) {
+                uint32_t position = faces[layerEnd].position;
+                int row = (position >> 8) & 0xFF;
+                int column = position & 0xFF;
+                greedyPlane[row * width + column] = layerEnd;
+            }
+            // faces are sorted by row and column so the first face not
+            // merged yet is a corner of the next quad
+            for (size_t i = layerStart; i < layerEnd; i++) {
+                const auto& face = faces[i];
+                int row = (face.position >> 8) & 0xFF;
+                int column = face.position & 0xFF;
+                if (greedyPlane[row * width + column] == -1) {
+                    continue;
+                }
+                auto matches = [&](int c, int r) {
+                    int index = greedyPlane[r * width + c];
+                    return index != -1 && faces[index].canMerge(face);
+                };
+                int w = 1;
+                while (column + w < width && matches(column + w, row)) {
+                    w++;
+                }
+                int h = 1;
+                for (; row + h < height; h++) {
+                    bool fullRow = true;
+                    for (int c = column; c < column + w; c++) {
+                        if (!matches(c, row + h)) {
+                            fullRow = false;
+                            break;
+                        }
+                    }
+                    if (!fullRow) {
+                        break;
+                    }
+                }
+                for (int r = row; r < row + h; r++) {
+                    std::fill_n(greedyPlane.begin() + r * width + column, w, -1);
+                }
+                if (tiledVertices.size() + 4 >= capacity ||
+                    tiledIndices.size() + 6 >= capacity) {
+                    overflow = true;
+                    continue;
+                }
+                glm::vec3 center;
+                center[layerAxis] = layer;
+                center[rowAxis] = row + (h - 1) * 0.5f;
+                center[columnAxis] = column + (w - 1) * 0.5f;
+
+                auto dx = X * (w * 0.5f);
+                auto dy = Y * (h * 0.5f);
+                auto dz = Z * 0.5f;
+                // texture coordinates are in texture repeats
+                uint32_t base = tiledVertices.size();
+                tiledVertex(center - dx - dy + dz, 0, 0, face, Z);
+                tiledVertex(center + dx - dy + dz, w, 0, face, Z);
+                tiledVertex(center + dx + dy + dz, w, h, face, Z);
+                tiledVertex(center - dx + dy + dz, 0, h, face, Z);
+                for (uint32_t i : {0, 1, 2, 0, 2, 3}) {
+                    tiledIndices.push_back(base + i);
+                }
+            }
+            layerStart = layerEnd;
+        }
+        faces.clear();
+    }
+}
+
 /* Fastest solid shaded blocks render method */
 void BlocksRenderer::blockCube(
     const glm::ivec3& coord,
@@ -397,6 +606,13 @@ void BlocksRenderer::blockCube(
         X = orient.axes[0];
         Y = orient.axes[1];
         Z = orient.axes[2];
+    } else if (greedy) {
+        for (int i = 0; i < 6; i++) {
+            if (isOpen(coord + CUBE_FACE_AXES[i][2], block, variant)) {
+                greedyFace(coord, i, texfaces[i], lights, ao);
+            }
+        }
+        return;
     }
 
     if (ao) {
@@ -493,6 +709,10 @@ void BlocksRenderer::render(
     bool denseRender = this->denseRender;
     bool densePass = this->densePass;
     bool enableAO = settings.graphics.softLighting.get();
+    greedy = settings.graphics.greedyMeshing.get();
+    for (auto& faces : greedyFaces) {
+        faces.clear();
+    }
     for (const auto drawGroup : *content.drawGroups) {
         int begin = beginEnds[drawGroup][0];
         if (begin == 0) {
@@ -558,10 +778,15 @@ void BlocksRenderer::render(
                     break;
             }
             if (overflow) {
+                greedy = false;
                 return;
             }
         }
     }
+    if (greedy) {
+        flushGreedyFaces();
+        greedy = false;
+    }
 }
 
 SortingMeshData BlocksRenderer::renderTranslucent(
@@ -648,7 +873,7 @@ SortingMeshData BlocksRenderer::renderTranslucent(
                     y + 0.5f,
                     z + chunk->z * CHUNK_D + 0.5f
                 ),
-                util::Buffer<ChunkVertex>(indexCount), 0};
+                util::Buffer<ChunkVertex>(indexCount)};
 
             totalSize += entry.vertexData.size();
 
@@ -683,8 +908,7 @@ SortingMeshData BlocksRenderer::renderTranslucent(
          sortingMesh.entries.size() > 1) {
         SortingMeshEntry newEntry {
             sortingMesh.entries[0].position,
-            util::Buffer<ChunkVertex>(totalSize),
-            0
+            util::Buffer<ChunkVertex>(totalSize)
         };
         size_t offset = 0;
         for (const auto& entry : sortingMesh.entries) {
@@ -715,11 +939,15 @@ void BlocksRenderer::build(const Chunk* chunk, const VoxelsVolume& volume) {
     int totalEnd = chunk->top * (CHUNK_W * CHUNK_D);
 
     int beginEnds[256][2] {};
+    occluders.reset();
     for (int i = totalBegin; i < totalEnd; i++) {
         const voxel& vox = voxels[i];
         blockid_t id = vox.id;
         const auto& def = *blockDefsCache[id];
         const auto& variant = def.getVariantByBits(vox.state.userbits);
+        occluders[i] = variant.rt.solid && variant.drawGroup == 0 &&
+                       variant.culling == CullingMode::DEFAULT &&
+                       !def.translucent;
 
         if (beginEnds[variant.drawGroup][0] == 0) {
             beginEnds[variant.drawGroup][0] = i+1;
@@ -742,12 +970,15 @@ void BlocksRenderer::build(const Chunk* chunk, const VoxelsVolume& volume) {
     vertexOffset = 0;
     indexCount = 0;
     denseIndexCount = 0;
+    tiledVertices.clear();
+    tiledIndices.clear();
 
     denseRender = false;
     densePass = false;
     render(voxels, beginEnds);
 
     size_t endIndex = indexCount;
+    size_t tiledEndIndex = tiledIndices.size();
     
     denseRender = true;
     densePass = true;
@@ -757,14 +988,130 @@ void BlocksRenderer::build(const Chunk* chunk, const VoxelsVolume& volume) {
     for (size_t i = 0; i < denseIndexCount; i++) {
         denseIndexBuffer[i] = indexBuffer[i];
     }
+    tiledDenseIndices = tiledIndices;
 
     indexCount = endIndex;
+    tiledIndices.resize(tiledEndIndex);
     densePass = false;
     render(voxels, beginEnds);
+
+    visibility.build(occluders);
+    lod = 0;
+
+    packVertices();
+}
+
+void BlocksRenderer::buildLod(
+    const Chunk* chunk, const VoxelsVolume& volume, int level
+) {
+    this->chunk = chunk;
+    this->voxelsBuffer = nullptr;
+    if (lodBlocks.empty()) {
+        size_t count = content.getIndices()->blocks.count();
+        lodBlocks.resize(count);
+        for (size_t id = 0; id < count; id++) {
+            const auto& def = *blockDefsCache[id];
+            auto& info = lodBlocks[id];
+            info.solid = def.defaults.model.type == BlockModelType::BLOCK &&
+                         !def.translucent;
+            for (int side = 0; side < 6; side++) {
+                info.faces[side] = cache.getRegion(id, 0, side, false);
+            }
+        }
+    }
+    lodBuilder.build(
+        volume.getVoxels(), volume.getLights(), lodBlocks.data(), level
+    );
+    const auto& vertices = lodBuilder.getVertices();
+    const auto& indices = lodBuilder.getIndices();
+    // LOD faces repeat textures, whole quads only
+    size_t quads = std::min(vertices.size() / 4, (capacity - 1) / 6);
+    overflow = quads < vertices.size() / 4;
+    vertexCount = 0;
+    vertexOffset = 0;
+    indexCount = 0;
+    tiledVertices.assign(vertices.begin(), vertices.begin() + quads * 4);
+    tiledIndices.assign(indices.begin(), indices.begin() + quads * 6);
+    // no transparency in LOD meshes
+    denseIndexCount = 0;
+    tiledDenseIndices = tiledIndices;
+
+    sortingMesh = SortingMeshData {};
+    visibility = ChunkVisibility();
+    cancelled = false;
+    lod = level;
+
+    packVertices();
+}
+
+/// @brief Append indices shifted by offset
+static void append_indices(
+    std::vector<uint32_t>& dst,
+    const uint32_t* indices,
+    size_t count,
+    uint32_t offset
+) {
+    for (size_t i = 0; i < count; i++) {
+        dst.push_back(indices[i] + offset);
+    }
+}
+
+void BlocksRenderer::packVertices() {
+    packed = settings.graphics.packedChunkVertices.get();
+    if (!packed) {
+        return;
+    }
+    // packed format has the same size for both kinds of faces,
+    // so they are drawn as a single mesh
+    packedVertices.clear();
+    packedIndices.clear();
+    packedDenseIndices.clear();
+    for (size_t i = 0; i < vertexCount; i++) {
+        packedVertices.push_back(PackedChunkVertex::pack(vertexBuffer[i]));
+    }
+    for (const auto& vertex : tiledVertices) {
+        packedVertices.push_back(PackedChunkVertex::pack(vertex));
+    }
+    append_indices(packedIndices, indexBuffer.get(), indexCount, 0);
+    append_indices(
+        packedIndices, tiledIndices.data(), tiledIndices.size(), vertexCount
+    );
+    append_indices(
+        packedDenseIndices, denseIndexBuffer.get(), denseIndexCount, 0
+    );
+    append_indices(
+        packedDenseIndices,
+        tiledDenseIndices.data(),
+        tiledDenseIndices.size(),
+        vertexCount
+    );
 }
 
 ChunkMeshData BlocksRenderer::createMesh() {
-    return ChunkMeshData {
+    if (packed) {
+        return ChunkMeshData {
+            {},
+            std::move(sortingMesh),
+            MeshData(
+                util::Buffer(packedVertices.data(), packedVertices.size()),
+                std::vector<util::Buffer<uint32_t>> {
+                    util::Buffer(packedIndices.data(), packedIndices.size()),
+                    util::Buffer(
+                        packedDenseIndices.data(), packedDenseIndices.size()
+                    ),
+                },
+                util::Buffer(
+                    PackedChunkVertex::ATTRIBUTES,
+                    sizeof(PackedChunkVertex::ATTRIBUTES) /
+                        sizeof(VertexAttribute)
+                )
+            ),
+            true,
+            visibility,
+            lod
+        };
+    }
+    ChunkMeshData data {
         MeshData(
             util::Buffer(vertexBuffer.get(), vertexCount),
             std::vector<util::Buffer<uint32_t>> {
@@ -776,8 +1123,28 @@ ChunkMeshData BlocksRenderer::createMesh() {
                 sizeof(ChunkVertex::ATTRIBUTES) / sizeof(VertexAttribute)
             )
         ),
-        std::move(sortingMesh)
+        std::move(sortingMesh),
+        {},
+        false,
+        visibility,
+        lod
     };
+    if (!tiledVertices.empty()) {
+        data.tiledMesh = MeshData(
+            util::Buffer(tiledVertices.data(), tiledVertices.size()),
+            std::vector<util::Buffer<uint32_t>> {
+                util::Buffer(tiledIndices.data(), tiledIndices.size()),
+                util::Buffer(
+                    tiledDenseIndices.data(), tiledDenseIndices.size()
+                ),
+            },
+            util::Buffer(
+                TiledChunkVertex::ATTRIBUTES,
+                sizeof(TiledChunkVertex::ATTRIBUTES) / sizeof(VertexAttribute)
+            )
+        );
+    }
+    return data;
 }
 
 ChunkMesh BlocksRenderer::render(
@@ -789,15 +1156,45 @@ ChunkMesh BlocksRenderer::render(
     assert(indexCount <= capacity);
     assert(denseIndexCount <= capacity);
 
-    return ChunkMesh{std::make_unique<Mesh<ChunkVertex>>(
-        vertexBuffer.get(), vertexCount, 
-        std::vector<IndexBufferData> {
-            IndexBufferData {indexBuffer.get(), indexCount},
-            IndexBufferData {denseIndexBuffer.get(), denseIndexCount},
+    std::vector<IndexBufferData> indices {
+        IndexBufferData {indexBuffer.get(), indexCount},
+        IndexBufferData {denseIndexBuffer.get(), denseIndexCount},
+    };
+    ChunkMesh mesh {nullptr, std::move(sortingMesh)};
+    if (packed) {
+        mesh.packedMesh = std::make_unique<Mesh<PackedChunkVertex>>(
+            packedVertices.data(),
+            packedVertices.size(),
+            std::vector<IndexBufferData> {
+                {packedIndices.data(), packedIndices.size()},
+                {packedDenseIndices.data(), packedDenseIndices.size()},
+            }
+        );
+    } else {
+        mesh.mesh = std::make_unique<Mesh<ChunkVertex>>(
+            vertexBuffer.get(), vertexCount, std::move(indices)
+        );
+        if (!tiledVertices.empty()) {
+            mesh.tiledMesh = std::make_unique<Mesh<TiledChunkVertex>>(
+                tiledVertices.data(),
+                tiledVertices.size(),
+                std::vector<IndexBufferData> {
+                    {tiledIndices.data(), tiledIndices.size()},
+                    {tiledDenseIndices.data(), tiledDenseIndices.size()},
+                }
+            );
         }
-    ), std::move(sortingMesh)};
+    }
+    mesh.visibility = visibility;
+    return mesh;
 }
 
 size_t BlocksRenderer::getMemoryConsumption() const {
-    return capacity * (sizeof(ChunkVertex) + sizeof(uint32_t) * 2);
+    size_t size = capacity * (sizeof(ChunkVertex) + sizeof(uint32_t) * 2);
+    size += tiledVertices.capacity() * sizeof(TiledChunkVertex);
+    size += (tiledIndices.capacity() + tiledDenseIndices.capacity() +
+             packedIndices.capacity() + packedDenseIndices.capacity()) *
+            sizeof(uint32_t);
+    size += packedVertices.capacity() * sizeof(PackedChunkVertex);
+    return size;
 }
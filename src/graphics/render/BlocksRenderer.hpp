@@ -1,183 +1,255 @@
-#pragma once
-
-#include <memory>
-#include <glm/glm.hpp>
-#include "voxels/voxel.hpp"
-#include "typedefs.hpp"
-
-#include "voxels/Block.hpp"
-#include "voxels/Chunk.hpp"
-#include "voxels/VoxelsVolume.hpp"
-#include "maths/util.hpp"
-#include "commons.hpp"
-#include "settings.hpp"
-
-template<typename VertexStructure> class Mesh;
-class Content;
-class Block;
-class Chunk;
-class Chunks;
-class VoxelsVolume;
-class ContentGfxCache;
-struct UVRegion;
-
-class BlocksRenderer {
-    static const glm::vec3 SUN_VECTOR;
-    const Content& content;
-    std::unique_ptr<ChunkVertex[]> vertexBuffer;
-    std::unique_ptr<uint32_t[]> indexBuffer;
-    std::unique_ptr<uint32_t[]> denseIndexBuffer;
-    size_t vertexCount;
-    size_t vertexOffset;
-    size_t indexCount;
-    size_t denseIndexCount;
-    size_t capacity;
-    bool overflow = false;
-    bool cancelled = false;
-    bool densePass = false;
-    bool denseRender = false;
-    const Chunk* chunk = nullptr;
-    const VoxelsVolume* voxelsBuffer = nullptr;
-
-    const Block* const* blockDefsCache;
-    const ContentGfxCache& cache;
-    const EngineSettings& settings;
-    
-    util::PseudoRandom randomizer;
-
-    SortingMeshData sortingMesh;
-
-    void vertex(
-        const glm::vec3& coord,
-        float u,
-        float v,
-        const glm::vec4& light,
-        const glm::vec3& normal,
-        float emission
-    );
-    void index(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e, uint32_t f);
-
-    void vertexAO(
-        const glm::vec3& coord, float u, float v, 
-        const glm::vec4& brightness,
-        const glm::vec3& axisX,
-        const glm::vec3& axisY,
-        const glm::vec3& axisZ
-    );
-    void face(
-        const glm::vec3& coord, 
-        float w, float h, float d,
-        const glm::vec3& axisX,
-        const glm::vec3& axisY,
-        const glm::vec3& axisZ,
-        const UVRegion& region,
-        const glm::vec4(&lights)[4],
-        const glm::vec4& tint
-    );
-    void face(
-        const glm::vec3& coord,
-        const glm::vec3& X,
-        const glm::vec3& Y,
-        const glm::vec3& Z,
-        const UVRegion& region,
-        glm::vec4 tint,
-        bool lights
-    );
-    void faceAO(
-        const glm::vec3& coord,
-        const glm::vec3& axisX,
-        const glm::vec3& axisY,
-        const glm::vec3& axisZ,
-        const UVRegion& region,
-        bool lights
-    );
-    void blockCube(
-        const glm::ivec3& coord,
-        const UVRegion(&faces)[6], 
-        const Block& block, 
-        blockstate states, 
-        bool lights,
-        bool ao
-    );
-    void blockAABB(
-        const glm::ivec3& coord,
-        const UVRegion(&faces)[6], 
-        const Block* block, 
-        ubyte rotation,
-        bool lights,
-        bool ambientOcclusion
-    );
-    void blockXSprite(
-        int x, int y, int z, 
-        const glm::vec3& size, 
-        const UVRegion& face1, 
-        const UVRegion& face2, 
-        float spread
-    );
-    void blockCustomModel(
-        const glm::ivec3& icoord,
-        const Block& block, 
-        blockstate states,
-        bool lights,
-        bool ao
-    );
-
-    bool isOpenForLight(int x, int y, int z) const;
-
-    // Does block allow to see other blocks sides (is it transparent)
-    inline bool isOpen(const glm::ivec3& pos, const Block& def, const Variant& variant) const {
-        auto vox = voxelsBuffer->pickBlock(
-            chunk->x * CHUNK_W + pos.x, pos.y, chunk->z * CHUNK_D + pos.z
-        );
-        if (vox.id == BLOCK_VOID) {
-            return false;
-        }
-        const auto& block = *blockDefsCache[vox.id];
-        const auto& blockVariant = block.getVariantByBits(vox.state.userbits);
-        uint8_t otherDrawGroup = blockVariant.drawGroup;
-        if ((otherDrawGroup && (otherDrawGroup != variant.drawGroup)) || !blockVariant.rt.solid) {
-            return true;
-        }
-        if (densePass) {
-            return variant.culling == CullingMode::OPTIONAL;
-        } else if (variant.culling == CullingMode::OPTIONAL) {
-            return false;
-        }
-        if (variant.culling == CullingMode::DISABLED && vox.id == def.rt.id) {
-            return true;
-        }
-        return !vox.id;
-    }
-
-    glm::vec4 pickLight(int x, int y, int z) const;
-    glm::vec4 pickLight(const glm::ivec3& coord) const;
-    glm::vec4 pickSoftLight(
-        const glm::ivec3& coord, const glm::ivec3& right, const glm::ivec3& up
-    ) const;
-    glm::vec4 pickSoftLight(
-        float x, float y, float z, const glm::ivec3& right, const glm::ivec3& up
-    ) const;
-
-    void render(const voxel* voxels, const int beginEnds[256][2]);
-    SortingMeshData renderTranslucent(const voxel* voxels, int beginEnds[256][2]);
-public:
-    BlocksRenderer(
-        size_t capacity,
-        const Content& content,
-        const ContentGfxCache& cache,
-        const EngineSettings& settings
-    );
-    virtual ~BlocksRenderer();
-
-    void build(const Chunk* chunk, const VoxelsVolume& volume);
-    ChunkMesh render(
-        const Chunk* chunk, const VoxelsVolume& volume
-    );
-    ChunkMeshData createMesh();
-
-    size_t getMemoryConsumption() const;
-
-    bool isCancelled() const {
-        return cancelled;
-    }
-};
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "voxels/voxel.hpp"
+#include "typedefs.hpp"
+
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/VoxelsVolume.hpp"
+#include "maths/util.hpp"
+#include "maths/UVRegion.hpp"
+#include "commons.hpp"
+#include "LodMeshBuilder.hpp"
+#include "settings.hpp"
+
+template<typename VertexStructure> class Mesh;
+class Content;
+class Block;
+class Chunk;
+class Chunks;
+class VoxelsVolume;
+class ContentGfxCache;
+
+class BlocksRenderer {
+    /// @brief Evenly lit cube face waiting for greedy meshing
+    struct GreedyFace {
+        /// @brief layer << 16 | row << 8 | column in the face plane
+        uint32_t position;
+        std::array<uint8_t, 4> color;
+        uint8_t emission;
+        UVRegion region;
+
+        bool canMerge(const GreedyFace& other) const {
+            return color == other.color && emission == other.emission &&
+                   region.u1 == other.region.u1 &&
+                   region.v1 == other.region.v1 &&
+                   region.u2 == other.region.u2 &&
+                   region.v2 == other.region.v2;
+        }
+    };
+
+    static const glm::vec3 SUN_VECTOR;
+    const Content& content;
+    std::unique_ptr<ChunkVertex[]> vertexBuffer;
+    std::unique_ptr<uint32_t[]> indexBuffer;
+    std::unique_ptr<uint32_t[]> denseIndexBuffer;
+    /// @brief Merged faces (greedy meshing, LOD) with two index buffers
+    /// like the main ones, grown on demand up to capacity
+    std::vector<TiledChunkVertex> tiledVertices;
+    std::vector<uint32_t> tiledIndices;
+    std::vector<uint32_t> tiledDenseIndices;
+    /// @brief Main and tiled vertices in packed format, filled if packed
+    /// vertices are enabled
+    std::vector<PackedChunkVertex> packedVertices;
+    std::vector<uint32_t> packedIndices;
+    std::vector<uint32_t> packedDenseIndices;
+    size_t vertexCount;
+    size_t vertexOffset;
+    size_t indexCount;
+    size_t denseIndexCount;
+    size_t capacity;
+    bool overflow = false;
+    bool cancelled = false;
+    bool densePass = false;
+    bool denseRender = false;
+    bool greedy = false;
+    bool packed = false;
+    const Chunk* chunk = nullptr;
+    const VoxelsVolume* voxelsBuffer = nullptr;
+
+    const Block* const* blockDefsCache;
+    const ContentGfxCache& cache;
+    const EngineSettings& settings;
+    
+    util::PseudoRandom randomizer;
+
+    SortingMeshData sortingMesh;
+
+    /// @brief Blocks hiding anything behind them
+    std::bitset<CHUNK_VOL> occluders;
+    ChunkVisibility visibility;
+
+    LodMeshBuilder lodBuilder;
+    /// @brief Blocks appearance in LOD meshes, filled on first LOD build
+    std::vector<LodMeshBuilder::BlockInfo> lodBlocks;
+    /// @brief Detail level of the last built mesh
+    int lod = 0;
+
+    /// @brief Greedy meshing faces by cube face index
+    std::vector<GreedyFace> greedyFaces[6];
+    /// @brief Face plane of greedy faces indices (-1 if empty)
+    std::vector<int> greedyPlane;
+
+    void vertex(
+        const glm::vec3& coord,
+        float u,
+        float v,
+        const glm::vec4& light,
+        const glm::vec3& normal,
+        float emission
+    );
+    void tiledVertex(
+        const glm::vec3& coord,
+        float u,
+        float v,
+        const GreedyFace& face,
+        const glm::vec3& normal
+    );
+    void index(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t e, uint32_t f);
+
+    void vertexAO(
+        const glm::vec3& coord, float u, float v, 
+        const glm::vec4& brightness,
+        const glm::vec3& axisX,
+        const glm::vec3& axisY,
+        const glm::vec3& axisZ
+    );
+    void face(
+        const glm::vec3& coord, 
+        float w, float h, float d,
+        const glm::vec3& axisX,
+        const glm::vec3& axisY,
+        const glm::vec3& axisZ,
+        const UVRegion& region,
+        const glm::vec4(&lights)[4],
+        const glm::vec4& tint
+    );
+    void face(
+        const glm::vec3& coord,
+        const glm::vec3& X,
+        const glm::vec3& Y,
+        const glm::vec3& Z,
+        const UVRegion& region,
+        glm::vec4 tint,
+        bool lights
+    );
+    void faceAO(
+        const glm::vec3& coord,
+        const glm::vec3& axisX,
+        const glm::vec3& axisY,
+        const glm::vec3& axisZ,
+        const UVRegion& region,
+        bool lights
+    );
+    /// @brief Add full cube face or defer it to greedy meshing if evenly lit
+    /// @param faceIndex cube face index (texture faces order)
+    void greedyFace(
+        const glm::ivec3& coord,
+        int faceIndex,
+        const UVRegion& region,
+        bool lights,
+        bool ao
+    );
+    /// @brief Merge deferred faces into quads with repeated texture
+    void flushGreedyFaces();
+    void blockCube(
+        const glm::ivec3& coord,
+        const UVRegion(&faces)[6], 
+        const Block& block, 
+        blockstate states, 
+        bool lights,
+        bool ao
+    );
+    void blockAABB(
+        const glm::ivec3& coord,
+        const UVRegion(&faces)[6], 
+        const Block* block, 
+        ubyte rotation,
+        bool lights,
+        bool ambientOcclusion
+    );
+    void blockXSprite(
+        int x, int y, int z, 
+        const glm::vec3& size, 
+        const UVRegion& face1, 
+        const UVRegion& face2, 
+        float spread
+    );
+    void blockCustomModel(
+        const glm::ivec3& icoord,
+        const Block& block, 
+        blockstate states,
+        bool lights,
+        bool ao
+    );
+
+    bool isOpenForLight(int x, int y, int z) const;
+
+    // Does block allow to see other blocks sides (is it transparent)
+    inline bool isOpen(const glm::ivec3& pos, const Block& def, const Variant& variant) const {
+        auto vox = voxelsBuffer->pickBlock(
+            chunk->x * CHUNK_W + pos.x, pos.y, chunk->z * CHUNK_D + pos.z
+        );
+        if (vox.id == BLOCK_VOID) {
+            return false;
+        }
+        const auto& block = *blockDefsCache[vox.id];
+        const auto& blockVariant = block.getVariantByBits(vox.state.userbits);
+        uint8_t otherDrawGroup = blockVariant.drawGroup;
+        if ((otherDrawGroup && (otherDrawGroup != variant.drawGroup)) || !blockVariant.rt.solid) {
+            return true;
+        }
+        if (densePass) {
+            return variant.culling == CullingMode::OPTIONAL;
+        } else if (variant.culling == CullingMode::OPTIONAL) {
+            return false;
+        }
+        if (variant.culling == CullingMode::DISABLED && vox.id == def.rt.id) {
+            return true;
+        }
+        return !vox.id;
+    }
+
+    glm::vec4 pickLight(int x, int y, int z) const;
+    glm::vec4 pickLight(const glm::ivec3& coord) const;
+    glm::vec4 pickSoftLight(
+        const glm::ivec3& coord, const glm::ivec3& right, const glm::ivec3& up
+    ) const;
+    glm::vec4 pickSoftLight(
+        float x, float y, float z, const glm::ivec3& right, const glm::ivec3& up
+    ) const;
+
+    void render(const voxel* voxels, const int beginEnds[256][2]);
+    /// @brief Convert built vertices to packed format if enabled
+    void packVertices();
+    SortingMeshData renderTranslucent(const voxel* voxels, int beginEnds[256][2]);
+public:
+    BlocksRenderer(
+        size_t capacity,
+        const Content& content,
+        const ContentGfxCache& cache,
+        const EngineSettings& settings
+    );
+    virtual ~BlocksRenderer();
+
+    void build(const Chunk* chunk, const VoxelsVolume& volume);
+    /// @brief Build downsampled mesh of a distant chunk
+    /// @param volume chunk voxels and lights snapshot of chunk size
+    /// @param level detail level [1, LodMeshBuilder::MAX_LEVEL]
+    void buildLod(const Chunk* chunk, const VoxelsVolume& volume, int level);
+    ChunkMesh render(
+        const Chunk* chunk, const VoxelsVolume& volume
+    );
+    ChunkMeshData createMesh();
+
+    size_t getMemoryConsumption() const;
+
+    bool isCancelled() const {
+        return cancelled;
+    }
+};
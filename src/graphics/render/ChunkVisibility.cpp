@@ -0,0 +1,186 @@
+#include "ChunkVisibility.hpp"
+
+#include <cmath>
+
+#include "maths/FrustumCulling.hpp"
+
+static constexpr int DIRECTIONS[ChunkVisibility::FACES_COUNT][3] {
+    {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+};
+
+static constexpr uint16_t ALL_CONNECTED = 0x7FFF;
+
+ChunkVisibility::ChunkVisibility() {
+    sections.fill(ALL_CONNECTED);
+}
+
+uint16_t ChunkVisibility::connect_faces(uint8_t faces) {
+    uint16_t connections = 0;
+    for (int a = 0; a < FACES_COUNT; a++) {
+        if (!(faces & (1 << a))) {
+            continue;
+        }
+        for (int b = a + 1; b < FACES_COUNT; b++) {
+            if (faces & (1 << b)) {
+                connections |= 1 << pair_bit(a, b);
+            }
+        }
+    }
+    return connections;
+}
+
+static inline uint8_t cell_faces(int x, int y, int z) {
+    uint8_t faces = 0;
+    if (x == 0) faces |= 1 << ChunkVisibility::NEG_X;
+    if (x == CHUNK_W - 1) faces |= 1 << ChunkVisibility::POS_X;
+    if (y == 0) faces |= 1 << ChunkVisibility::NEG_Y;
+    if (y == VISIBILITY_SECTION_H - 1) faces |= 1 << ChunkVisibility::POS_Y;
+    if (z == 0) faces |= 1 << ChunkVisibility::NEG_Z;
+    if (z == CHUNK_D - 1) faces |= 1 << ChunkVisibility::POS_Z;
+    return faces;
+}
+
+void ChunkVisibility::build(const std::bitset<CHUNK_VOL>& occluders) {
+    std::bitset<VISIBILITY_SECTION_VOL> visited;
+    std::vector<int> stack;
+    stack.reserve(VISIBILITY_SECTION_VOL);
+
+    for (int section = 0; section < VISIBILITY_SECTIONS; section++) {
+        int base = section * VISIBILITY_SECTION_VOL;
+        int occludersCount = 0;
+        for (int i = 0; i < VISIBILITY_SECTION_VOL; i++) {
+            bool occluder = occluders[base + i];
+            visited[i] = occluder;
+            occludersCount += occluder;
+        }
+        if (occludersCount == 0) {
+            sections[section] = ALL_CONNECTED;
+            continue;
+        }
+        uint16_t connections = 0;
+        for (int start = 0; start < VISIBILITY_SECTION_VOL; start++) {
+            if (visited[start]) {
+                continue;
+            }
+            // flood fill of a cavity, collecting faces it touches
+            uint8_t faces = 0;
+            visited[start] = true;
+            stack.push_back(start);
+            while (!stack.empty()) {
+                int index = stack.back();
+                stack.pop_back();
+                int x = index % CHUNK_W;
+                int z = index / CHUNK_W % CHUNK_D;
+                int y = index / (CHUNK_W * CHUNK_D);
+                faces |= cell_faces(x, y, z);
+                for (const auto& dir : DIRECTIONS) {
+                    int nx = x + dir[0];
+                    int ny = y + dir[1];
+                    int nz = z + dir[2];
+                    if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_W ||
+                        ny >= VISIBILITY_SECTION_H || nz >= CHUNK_D) {
+                        continue;
+                    }
+                    int neighbour = vox_index(nx, ny, nz);
+                    if (!visited[neighbour]) {
+                        visited[neighbour] = true;
+                        stack.push_back(neighbour);
+                    }
+                }
+            }
+            connections |= connect_faces(faces);
+        }
+        sections[section] = connections;
+    }
+}
+
+void OcclusionCulling::update(
+    int width,
+    int depth,
+    int offsetX,
+    int offsetZ,
+    const glm::vec3& cameraPosition,
+    const Frustum* frustum,
+    const GraphSupplier& supplier
+) {
+    size_t chunksCount = width * depth;
+    visibleChunks.assign(chunksCount, false);
+    visited.assign(chunksCount * VISIBILITY_SECTIONS, false);
+    queue.clear();
+    visibleCount = 0;
+
+    int cx = static_cast<int>(std::floor(cameraPosition.x / CHUNK_W)) - offsetX;
+    int cz = static_cast<int>(std::floor(cameraPosition.z / CHUNK_D)) - offsetZ;
+    if (cx < 0 || cz < 0 || cx >= width || cz >= depth) {
+        // camera is outside of the area, nothing to start from
+        visibleChunks.assign(chunksCount, true);
+        visibleCount = chunksCount;
+        return;
+    }
+    int cy = static_cast<int>(
+        std::floor(cameraPosition.y / VISIBILITY_SECTION_H)
+    );
+    if (cy < 0) {
+        cy = 0;
+    } else if (cy >= VISIBILITY_SECTIONS) {
+        cy = VISIBILITY_SECTIONS - 1;
+    }
+
+    auto visit = [this, width](int x, int y, int z) {
+        int index = z * width + x;
+        visited[index * VISIBILITY_SECTIONS + y] = true;
+        if (!visibleChunks[index]) {
+            visibleChunks[index] = true;
+            visibleCount++;
+        }
+    };
+    visit(cx, cy, cz);
+    queue.push_back(Step {cx, cy, cz, -1, 0});
+
+    for (size_t i = 0; i < queue.size(); i++) {
+        Step step = queue[i];
+        int index = step.z * width + step.x;
+        const ChunkVisibility* graph = supplier(index);
+
+        for (int face = 0; face < ChunkVisibility::FACES_COUNT; face++) {
+            // never go back towards the camera
+            if (step.directions & (1 << ChunkVisibility::opposite(face))) {
+                continue;
+            }
+            if (graph && step.from != -1 &&
+                !graph->isConnected(step.y, step.from, face)) {
+                continue;
+            }
+            int nx = step.x + DIRECTIONS[face][0];
+            int ny = step.y + DIRECTIONS[face][1];
+            int nz = step.z + DIRECTIONS[face][2];
+            if (nx < 0 || ny < 0 || nz < 0 || nx >= width ||
+                ny >= VISIBILITY_SECTIONS || nz >= depth) {
+                continue;
+            }
+            int neighbour = nz * width + nx;
+            if (visited[neighbour * VISIBILITY_SECTIONS + ny]) {
+                continue;
+            }
+            if (frustum) {
+                glm::vec3 min(
+                    (nx + offsetX) * CHUNK_W,
+                    ny * VISIBILITY_SECTION_H,
+                    (nz + offsetZ) * CHUNK_D
+                );
+                glm::vec3 max =
+                    min + glm::vec3(CHUNK_W, VISIBILITY_SECTION_H, CHUNK_D);
+                if (!frustum->isBoxVisible(min, max)) {
+                    continue;
+                }
+            }
+            visit(nx, ny, nz);
+            queue.push_back(Step {
+                nx,
+                ny,
+                nz,
+                ChunkVisibility::opposite(face),
+                static_cast<uint8_t>(step.directions | (1 << face))});
+        }
+    }
+}
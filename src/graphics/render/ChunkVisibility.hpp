@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <functional>
+#include <vector>
+#include <glm/vec3.hpp>
+
+#include "constants.hpp"
+
+class Frustum;
+
+/// @brief Chunk column is split into sections of the height for occlusion
+/// culling
+inline constexpr int VISIBILITY_SECTION_H = 16;
+inline constexpr int VISIBILITY_SECTIONS = CHUNK_H / VISIBILITY_SECTION_H;
+inline constexpr int VISIBILITY_SECTION_VOL =
+    CHUNK_W * VISIBILITY_SECTION_H * CHUNK_D;
+
+/// @brief Faces connectivity graph of chunk sections. Two faces of a section
+/// are connected if there is a path between them through not occluding
+/// blocks, so the section does not hide blocks behind one face from a
+/// viewer looking through another one.
+class ChunkVisibility {
+public:
+    /// @brief Section faces in the block texture faces order
+    enum Face { NEG_X, POS_X, NEG_Y, POS_Y, NEG_Z, POS_Z, FACES_COUNT };
+
+    /// @brief Create graph with all faces connected
+    ChunkVisibility();
+
+    /// @brief Calculate faces connectivity of all sections
+    /// @param occluders flags of blocks hiding anything behind them,
+    /// indexed with vox_index
+    void build(const std::bitset<CHUNK_VOL>& occluders);
+
+    /// @brief Check if two different faces of the section are connected
+    bool isConnected(int section, int a, int b) const {
+        return sections[section] & (1 << pair_bit(a, b));
+    }
+
+    static constexpr int opposite(int face) {
+        return face ^ 1;
+    }
+private:
+    /// @brief 15 bits per section, one per faces pair
+    std::array<uint16_t, VISIBILITY_SECTIONS> sections;
+
+    static constexpr int pair_bit(int a, int b) {
+        if (a > b) {
+            return pair_bit(b, a);
+        }
+        return a * (9 - a) / 2 + b - 1;
+    }
+
+    static uint16_t connect_faces(uint8_t faces);
+};
+
+/// @brief Breadth-first traversal of chunk sections visible from the camera
+/// section over the loaded chunks area
+class OcclusionCulling {
+public:
+    /// @brief Graph provider by chunk index in area.
+    /// nullptr means unknown graph (all faces are connected)
+    using GraphSupplier = std::function<const ChunkVisibility*(int index)>;
+
+    /// @param width area width (chunks)
+    /// @param depth area depth (chunks)
+    /// @param offsetX area offset along x axis (chunks)
+    /// @param offsetZ area offset along z axis (chunks)
+    /// @param cameraPosition camera position (blocks)
+    /// @param frustum optional frustum to skip invisible sections
+    /// @param supplier chunks graph provider
+    void update(
+        int width,
+        int depth,
+        int offsetX,
+        int offsetZ,
+        const glm::vec3& cameraPosition,
+        const Frustum* frustum,
+        const GraphSupplier& supplier
+    );
+
+    /// @brief Check if any section of the chunk was reached in the last
+    /// update
+    /// @param index chunk index in area (z * width + x)
+    bool isVisible(int index) const {
+        return index < static_cast<int>(visibleChunks.size()) &&
+               visibleChunks[index];
+    }
+
+    /// @return Number of chunks reached in the last update
+    size_t countVisible() const {
+        return visibleCount;
+    }
+private:
+    struct Step {
+        int x;
+        int y;
+        int z;
+        /// @brief face the section was entered through or -1
+        int from;
+        /// @brief mask of directions made along the path
+        uint8_t directions;
+    };
+    std::vector<bool> visited;
+    std::vector<bool> visibleChunks;
+    std::vector<Step> queue;
+    size_t visibleCount = 0;
+};
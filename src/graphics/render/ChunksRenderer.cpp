@@ -1,5 +1,6 @@
 #include "ChunksRenderer.hpp"
 #include "BlocksRenderer.hpp"
+#include "LodMeshBuilder.hpp"
 #include "debug/Logger.hpp"
 #include "assets/Assets.hpp"
 #include "graphics/core/Mesh.hpp"
@@ -18,6 +19,7 @@
 static debug::Logger logger("chunks-render");
 
 size_t ChunksRenderer::visibleChunks = 0;
+size_t ChunksRenderer::occludedChunks = 0;
 
 class RendererWorker : public util::Worker<RendererJob, RendererResult> {
     BlocksRenderer renderer;
@@ -39,8 +41,11 @@ public:
 
     RendererResult operator()(const RendererJob& job) override {
         auto chunk = job.chunk;
-        auto volume = job.volume;
-        renderer.build(chunk.get(), *volume);
+        if (job.lod > 0) {
+            renderer.buildLod(chunk.get(), *job.volume, job.lod);
+        } else {
+            renderer.build(chunk.get(), *job.volume);
+        }
         if (renderer.isCancelled()) {
             return RendererResult {
                 glm::ivec2(chunk->x, chunk->z), true, ChunkMeshData {}};
@@ -51,9 +56,37 @@ public:
     }
 };
 
+class TranslucentSortWorker
+    : public util::Worker<TranslucentSortJob, TranslucentSortResult> {
+    TranslucentSorter sorter;
+public:
+    TranslucentSortResult operator()(const TranslucentSortJob& job) override {
+        TranslucentSortResult result {
+            job.key, job.entries, job.cameraPosition, job.order, {}};
+        sorter.sort(*job.entries, job.cameraPosition, result.order);
+        TranslucentSorter::writeIndices(
+            *job.entries, result.order, result.indices
+        );
+        return result;
+    }
+};
+
 static util::ObjectsPool<VoxelsVolume> voxelsVolumesPool {};
 static inline const int VOXELS_BUFFER_PADDING = 2;
 
+static void draw_chunk_mesh(const ChunkMesh& mesh, bool dense) {
+    if (mesh.packedMesh) {
+        mesh.packedMesh->draw(GL_TRIANGLES, dense);
+        return;
+    }
+    if (mesh.mesh) {
+        mesh.mesh->draw(GL_TRIANGLES, dense);
+    }
+    if (mesh.tiledMesh) {
+        mesh.tiledMesh->draw(GL_TRIANGLES, dense);
+    }
+}
+
 ChunksRenderer::ChunksRenderer(
     const Level* level,
     const Chunks& chunks,
@@ -74,15 +107,53 @@ ChunksRenderer::ChunksRenderer(
               );
           },
           [&](RendererResult& result) {
-              if (!result.cancelled) {
-                  auto meshData = std::move(result.meshData);
-                  meshes[result.key] = ChunkMesh {
-                      std::make_unique<Mesh<ChunkVertex>>(meshData.mesh),
-                      std::move(meshData.sortingMesh)};
+              auto& meshData = result.meshData;
+              bool packed = meshData.packed;
+              // skip meshes built before vertex format change
+              if (!result.cancelled &&
+                  packed == settings.graphics.packedChunkVertices.get()) {
+                  ChunkMesh mesh {nullptr, std::move(meshData.sortingMesh)};
+                  mesh.visibility = meshData.visibility;
+                  mesh.lod = meshData.lod;
+                  if (packed) {
+                      mesh.packedMesh =
+                          std::make_unique<Mesh<PackedChunkVertex>>(
+                              meshData.packedMesh
+                          );
+                  } else {
+                      mesh.mesh =
+                          std::make_unique<Mesh<ChunkVertex>>(meshData.mesh);
+                      if (meshData.tiledMesh.vertices != nullptr) {
+                          mesh.tiledMesh =
+                              std::make_unique<Mesh<TiledChunkVertex>>(
+                                  meshData.tiledMesh
+                              );
+                      }
+                  }
+                  meshes[result.key] = std::move(mesh);
               }
               inwork.erase(result.key);
           },
           settings.graphics.chunkMaxRenderers.get()
+      ),
+      sortingPool(
+          "translucent-sort-pool",
+          []() { return std::make_shared<TranslucentSortWorker>(); },
+          [&](TranslucentSortResult& result) {
+              auto found = meshes.find(result.key);
+              if (found == meshes.end() ||
+                  found->second.translucent != result.entries) {
+                  return;
+              }
+              auto& mesh = found->second;
+              mesh.sortedMesh->reloadIndices(
+                  0, result.indices.data(), result.indices.size()
+              );
+              mesh.translucentOrder = std::move(result.order);
+              mesh.sortPosition = result.cameraPosition;
+              mesh.sortPending = false;
+          },
+          1
       ) {
     threadPool.setStopOnFail(false);
     renderer = std::make_unique<BlocksRenderer>(
@@ -121,24 +192,31 @@ std::shared_ptr<VoxelsVolume> ChunksRenderer::prepareVoxelsVolume(
     return voxelsBuffer;
 }
 
-const Mesh<ChunkVertex>* ChunksRenderer::render(
-    const std::shared_ptr<Chunk>& chunk, bool important
+const ChunkMesh* ChunksRenderer::render(
+    const std::shared_ptr<Chunk>& chunk, bool important, int lod
 ) {
     glm::ivec2 key(chunk->x, chunk->z);
     chunk->flags.modified = false;
     if (important) {
         auto voxelsBuffer = prepareVoxelsVolume(*chunk);
 
-        auto mesh = renderer->render(chunk.get(), *voxelsBuffer);
-        meshes[key] =
-            ChunkMesh {std::move(mesh.mesh), std::move(mesh.sortingMeshData)};
-        return meshes[key].mesh.get();
+        meshes[key] = renderer->render(chunk.get(), *voxelsBuffer);
+        return &meshes[key];
     }
     if (inwork.find(key) != inwork.end()) {
         return nullptr;
     }
-    auto voxelsBuffer = prepareVoxelsVolume(*chunk);
     inwork[key] = true;
+    if (lod > 0) {
+        // LOD meshes are built from the chunk data only, the snapshot is
+        // taken here as chunk may be modified while the mesh is built
+        auto voxelsBuffer = voxelsVolumesPool.create(CHUNK_W, CHUNK_H, CHUNK_D);
+        voxelsBuffer->setPosition(chunk->x * CHUNK_W, 0, chunk->z * CHUNK_D);
+        chunks.getVoxels(*voxelsBuffer, false, CHUNK_H);
+        threadPool.enqueueJob({chunk, std::move(voxelsBuffer), lod});
+        return nullptr;
+    }
+    auto voxelsBuffer = prepareVoxelsVolume(*chunk);
     chunks.getVoxels(
         *voxelsBuffer, settings.graphics.backlight.get(), chunk->top + 1
     );
@@ -158,26 +236,42 @@ void ChunksRenderer::clear() {
     meshes.clear();
     inwork.clear();
     threadPool.clearQueue();
+    sortingPool.clearQueue();
 }
 
-const Mesh<ChunkVertex>* ChunksRenderer::getOrRender(
-    const std::shared_ptr<Chunk>& chunk, bool important
+const ChunkMesh* ChunksRenderer::getOrRender(
+    const std::shared_ptr<Chunk>& chunk, bool important, int lod
 ) {
     auto found = meshes.find(glm::ivec2(chunk->x, chunk->z));
     if (found == meshes.end()) {
-        return render(chunk, important);
+        return render(chunk, important, lod);
     }
-    if (chunk->flags.modified && chunk->flags.lighted) {
-        render(chunk, important);
+    // previous mesh is drawn until the new level one is built
+    if ((chunk->flags.modified && chunk->flags.lighted) ||
+        found->second.lod != lod) {
+        render(chunk, important, lod);
+    }
+    return &found->second;
+}
+
+int ChunksRenderer::selectLod(const Chunk& chunk, float distance) const {
+    int lodDistance = settings.graphics.lodDistance.get();
+    if (lodDistance == 0) {
+        return 0;
     }
-    return found->second.mesh.get();
+    const auto& found = meshes.find({chunk.x, chunk.z});
+    int current = found == meshes.end() ? 0 : found->second.lod;
+    return LodMeshBuilder::selectLevel(
+        distance / CHUNK_W, lodDistance, current
+    );
 }
 
 void ChunksRenderer::update() {
     threadPool.update();
+    sortingPool.update();
 }
 
-const Mesh<ChunkVertex>* ChunksRenderer::retrieveChunk(
+const ChunkMesh* ChunksRenderer::retrieveChunk(
     size_t index, const Camera& camera, bool culling
 ) {
     auto chunk = chunks.getChunks()[index];
@@ -189,7 +283,7 @@ const Mesh<ChunkVertex>* ChunksRenderer::retrieveChunk(
         if (found == meshes.end()) {
             return nullptr;
         } else {
-            return found->second.mesh.get();
+            return &found->second;
         }
     }
     float distance = glm::distance(
@@ -200,7 +294,8 @@ const Mesh<ChunkVertex>* ChunksRenderer::retrieveChunk(
             (chunk->z + 0.5f) * CHUNK_D
         )
     );
-    auto mesh = getOrRender(chunk, distance < CHUNK_W * 1.5f);
+    int lod = selectLod(*chunk, distance);
+    auto mesh = getOrRender(chunk, distance < CHUNK_W * 1.5f && lod == 0, lod);
     if (mesh == nullptr) {
         return nullptr;
     }
@@ -259,12 +354,35 @@ void ChunksRenderer::drawShadowsPass(
         }
         glm::mat4 model = glm::translate(glm::mat4(1.0f), coord);
         shader.uniformMatrix("u_model", model);
-        found->second.mesh->draw(GL_TRIANGLES, 
+        draw_chunk_mesh(found->second,
             glm::distance2(playerCamera.position * glm::vec3(1, 0, 1), 
                            (min + max) * 0.5f * glm::vec3(1, 0, 1)) < denseDistance2);
     }
 }
 
+void ChunksRenderer::updateOcclusion(const Camera& camera, bool culling) {
+    const auto& chunksList = chunks.getChunks();
+    occlusionCulling.update(
+        chunks.getWidth(),
+        chunks.getHeight(),
+        chunks.getOffsetX(),
+        chunks.getOffsetY(),
+        camera.position,
+        culling ? &frustum : nullptr,
+        [this, &chunksList](int index) -> const ChunkVisibility* {
+            const auto& chunk = chunksList[index];
+            if (chunk == nullptr) {
+                return nullptr;
+            }
+            const auto& found = meshes.find({chunk->x, chunk->z});
+            if (found == meshes.end()) {
+                return nullptr;
+            }
+            return &found->second.visibility;
+        }
+    );
+}
+
 void ChunksRenderer::drawChunks(
     const Camera& camera, Shader& shader
 ) {
@@ -294,8 +412,13 @@ void ChunksRenderer::drawChunks(
     util::insertion_sort(indices.begin(), indices.end());
 
     bool culling = settings.graphics.frustumCulling.get();
+    bool occlusion = settings.graphics.occlusionCulling.get();
+    if (occlusion) {
+        updateOcclusion(camera, culling);
+    }
 
     visibleChunks = 0;
+    occludedChunks = 0;
     shader.uniform1i("u_alphaClip", true);
 
     auto denseDistance = settings.graphics.denseRenderDistance.get();
@@ -306,13 +429,17 @@ void ChunksRenderer::drawChunks(
         auto& chunk = chunks.getChunks()[indices[i].index];
         auto mesh = retrieveChunk(indices[i].index, camera, culling);
 
+        if (mesh && occlusion && !occlusionCulling.isVisible(indices[i].index)) {
+            occludedChunks++;
+            continue;
+        }
         if (mesh) {
             glm::vec3 coord(
                 chunk->x * CHUNK_W + 0.5f, 0.5f, chunk->z * CHUNK_D + 0.5f
             );
             glm::mat4 model = glm::translate(glm::mat4(1.0f), coord);
             shader.uniformMatrix("u_model", model);
-            mesh->draw(GL_TRIANGLES, glm::distance2(camera.position * glm::vec3(1, 0, 1), 
+            draw_chunk_mesh(*mesh, glm::distance2(camera.position * glm::vec3(1, 0, 1), 
                 (coord + glm::vec3(CHUNK_W * 0.5f, 0.0f, CHUNK_D * 0.5f))) < denseDistance2);
             visibleChunks++;
         }
@@ -333,12 +460,50 @@ static inline void write_sorting_mesh_entries(
     }
 }
 
+void ChunksRenderer::buildSortedMesh(
+    ChunkMesh& mesh, const glm::vec3& cameraPosition
+) {
+    const auto& chunkEntries = mesh.sortingMeshData.entries;
+    auto translucent = std::make_shared<TranslucentEntries>();
+    size_t size = 0;
+    for (const auto& entry : chunkEntries) {
+        translucent->entries.push_back(TranslucentEntries::Entry {
+            entry.position,
+            static_cast<uint32_t>(size),
+            static_cast<uint32_t>(entry.vertexData.size())});
+        size += entry.vertexData.size();
+    }
+    translucent->vertexCount = size;
+
+    static util::Buffer<ChunkVertex> buffer;
+    if (buffer.size() < size) {
+        buffer = util::Buffer<ChunkVertex>(size);
+    }
+    write_sorting_mesh_entries(buffer.data(), chunkEntries);
+
+    sorter.sort(*translucent, cameraPosition, mesh.translucentOrder);
+    TranslucentSorter::writeIndices(
+        *translucent, mesh.translucentOrder, sortedIndices
+    );
+    mesh.sortedMesh = std::make_unique<Mesh<ChunkVertex>>(
+        buffer.data(),
+        size,
+        std::vector<IndexBufferData> {
+            {sortedIndices.data(), sortedIndices.size()}}
+    );
+    mesh.translucent = std::move(translucent);
+    mesh.sortPosition = cameraPosition;
+    // vertices are stored in the mesh buffer now
+    mesh.sortingMeshData = {};
+}
+
 void ChunksRenderer::drawSortedMeshes(const Camera& camera, Shader& shader) {
     const int sortInterval = TRANSLUCENT_BLOCKS_SORT_INTERVAL;
     static int frameid = 0;
     frameid++;
 
     bool culling = settings.graphics.frustumCulling.get();
+    bool occlusion = settings.graphics.occlusionCulling.get();
     const auto& chunks = this->chunks.getChunks();
     const auto& cameraPos = camera.position;
     const auto& atlas = assets.require<Atlas>("blocks");
@@ -353,8 +518,16 @@ void ChunksRenderer::drawSortedMeshes(const Camera& camera, Shader& shader) {
         if (chunk == nullptr || !chunk->flags.lighted) {
             continue;
         }
+        if (occlusion && !occlusionCulling.isVisible(index.index)) {
+            continue;
+        }
         const auto& found = meshes.find(glm::ivec2(chunk->x, chunk->z));
-        if (found == meshes.end() || found->second.sortingMeshData.entries.empty()) {
+        if (found == meshes.end()) {
+            continue;
+        }
+        auto& mesh = found->second;
+        if (mesh.sortedMesh == nullptr &&
+            mesh.sortingMeshData.entries.empty()) {
             continue;
         }
 
@@ -369,40 +542,17 @@ void ChunksRenderer::drawSortedMeshes(const Camera& camera, Shader& shader) {
             if (!frustum.isBoxVisible(min, max)) continue;
         }
 
-        auto& chunkEntries = found->second.sortingMeshData.entries;
-
-        if (chunkEntries.size() == 1) {
-            auto& entry = chunkEntries.at(0);
-            if (found->second.sortedMesh == nullptr) {
-                found->second.sortedMesh = std::make_unique<Mesh<ChunkVertex>>(
-                    entry.vertexData.data(), entry.vertexData.size()
-                );
-            }
-            found->second.sortedMesh->draw();
-            continue;
-        }
-        for (auto& entry : chunkEntries) {
-            entry.distance = static_cast<long long>(
-                glm::distance2(entry.position, cameraPos)
-            );
-        }
-        if (found->second.sortedMesh == nullptr ||
-            (frameid + chunk->x) % sortInterval == 0) {
-            std::sort(chunkEntries.begin(), chunkEntries.end());
-            size_t size = 0;
-            for (const auto& entry : chunkEntries) {
-                size += entry.vertexData.size();
-            }
-
-            static util::Buffer<ChunkVertex> buffer;
-            if (buffer.size() < size) {
-                buffer = util::Buffer<ChunkVertex>(size);
-            }
-            write_sorting_mesh_entries(buffer.data(), chunkEntries);
-            found->second.sortedMesh = std::make_unique<Mesh<ChunkVertex>>(
-                buffer.data(), size
-            );
+        if (mesh.sortedMesh == nullptr) {
+            buildSortedMesh(mesh, cameraPos);
+        } else if (!mesh.sortPending && mesh.translucent->entries.size() > 1 &&
+                   (frameid + chunk->x) % sortInterval == 0 &&
+                   mesh.sortPosition != cameraPos) {
+            // indices are re-sorted in background, previous order is drawn
+            mesh.sortPending = true;
+            sortingPool.enqueueJob(TranslucentSortJob {
+                found->first, mesh.translucent, cameraPos, mesh.translucentOrder
+            });
         }
-        found->second.sortedMesh->draw();
+        mesh.sortedMesh->draw();
     }
 }
@@ -10,6 +10,7 @@
 
 #include "util/ThreadPool.hpp"
 #include "commons.hpp"
+#include "TranslucentSorter.hpp"
 
 template<typename VertexStructure> class Mesh;
 class Chunk;
@@ -41,7 +42,28 @@ struct RendererResult {
 
 struct RendererJob {
     std::shared_ptr<Chunk> chunk;
+    /// @brief Chunk voxels with neighbours, only the chunk itself
+    /// for LOD meshes
     std::shared_ptr<VoxelsVolume> volume;
+    /// @brief Mesh detail level, 0 is full resolution
+    int lod = 0;
+};
+
+struct TranslucentSortJob {
+    glm::ivec2 key;
+    std::shared_ptr<const TranslucentEntries> entries;
+    glm::vec3 cameraPosition;
+    /// @brief Previous entries order
+    std::vector<uint32_t> order;
+};
+
+struct TranslucentSortResult {
+    glm::ivec2 key;
+    /// @brief Sorted entries, result is skipped if the mesh was rebuilt
+    std::shared_ptr<const TranslucentEntries> entries;
+    glm::vec3 cameraPosition;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> indices;
 };
 
 class ChunksRenderer {
@@ -55,10 +77,19 @@ class ChunksRenderer {
     std::unordered_map<glm::ivec2, bool> inwork;
     std::vector<ChunksSortEntry> indices;
     util::ThreadPool<RendererJob, RendererResult> threadPool;
-    const Mesh<ChunkVertex>* retrieveChunk(
+    util::ThreadPool<TranslucentSortJob, TranslucentSortResult> sortingPool;
+    /// @brief Used for the first sort of a new sorted mesh
+    TranslucentSorter sorter;
+    std::vector<uint32_t> sortedIndices;
+    OcclusionCulling occlusionCulling;
+    const ChunkMesh* retrieveChunk(
         size_t index, const Camera& camera, bool culling
     );
     std::shared_ptr<VoxelsVolume> prepareVoxelsVolume(const Chunk& chunk);
+    void updateOcclusion(const Camera& camera, bool culling);
+    void buildSortedMesh(ChunkMesh& mesh, const glm::vec3& cameraPosition);
+    /// @param distance horizontal distance from camera (blocks)
+    int selectLod(const Chunk& chunk, float distance) const;
 public:
     ChunksRenderer(
         const Level* level,
@@ -70,14 +101,15 @@ public:
     );
     virtual ~ChunksRenderer();
 
-    const Mesh<ChunkVertex>* render(
-        const std::shared_ptr<Chunk>& chunk, bool important
+    /// @param lod mesh detail level, not used for important chunks
+    const ChunkMesh* render(
+        const std::shared_ptr<Chunk>& chunk, bool important, int lod = 0
     );
     void unload(const Chunk* chunk);
     void clear();
 
-    const Mesh<ChunkVertex>* getOrRender(
-        const std::shared_ptr<Chunk>& chunk, bool important
+    const ChunkMesh* getOrRender(
+        const std::shared_ptr<Chunk>& chunk, bool important, int lod = 0
     );
 
     void drawShadowsPass(
@@ -91,4 +123,6 @@ public:
     void update();
 
     static size_t visibleChunks;
+    /// @brief Chunks passed frustum culling but hidden by other chunks
+    static size_t occludedChunks;
 };
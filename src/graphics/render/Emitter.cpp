@@ -51,7 +51,7 @@ static inline glm::vec3 generate_coord(ParticleSpawnShape shape) {
 void Emitter::update(
     float delta,
     const glm::vec3& cameraPosition,
-    std::vector<Particle>& particles
+    ParticlesData& particles
 ) {
     const float spawnInterval = preset.spawnInterval;
     if (count == 0 || (count == -1 && spawnInterval < FLT_EPSILON)) {
@@ -116,7 +116,7 @@ void Emitter::update(
                 random.randFloat()
             );
         }
-        particles.push_back(std::move(particle));
+        particles.add(particle);
         timer -= spawnInterval;
         if (count > 0) {
             count--;
@@ -125,6 +125,14 @@ void Emitter::update(
     }
 }
 
+void Emitter::setFrames(std::vector<std::optional<UVRegion>> frames) {
+    this->frames = std::move(frames);
+}
+
+const std::vector<std::optional<UVRegion>>& Emitter::getFrames() const {
+    return frames;
+}
+
 void Emitter::stop() {
     this->count = 0;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <optional>
 #include <variant>
 #include <glm/glm.hpp>
 
@@ -9,30 +10,9 @@
 #include "maths/UVRegion.hpp"
 #include "maths/util.hpp"
 #include "presets/ParticlesPreset.hpp"
+#include "Particles.hpp"
 
 class Level;
-class Emitter;
-
-struct Particle {
-    /// @brief Pointer used to access common behaviour.
-    /// Emitter must be utilized after all related particles despawn.
-    Emitter* emitter;
-    /// @brief Some random integer for visuals configuration.
-    int random;
-    /// @brief Global position
-    glm::vec3 position;
-    /// @brief Linear velocity
-    glm::vec3 velocity;
-    /// @brief Remaining life time
-    float lifetime;
-    /// @brief UV region
-    UVRegion region;
-    /// @brief Current rotation angle
-    float angle;
-    /// @brief Angular velocity
-    float angularVelocity;
-};
-
 class Texture;
 
 using EmitterOrigin = std::variant<glm::vec3, entityid_t>;
@@ -53,6 +33,9 @@ class Emitter {
     float timer = 0.0f;
 
     util::PseudoRandom random;
+    /// @brief Animation frames regions, nullopt if frame texture differs
+    /// from the emitter texture
+    std::vector<std::optional<UVRegion>> frames;
 public:
     /// @brief Number of references (alive particles)
     int refCount = 0;
@@ -76,13 +59,18 @@ public:
     /// @brief Update emitter and spawn particles
     /// @param delta delta time
     /// @param cameraPosition current camera global position
-    /// @param particles destination particles vector
+    /// @param particles destination particles storage
     void update(
         float delta,
         const glm::vec3& cameraPosition,
-        std::vector<Particle>& particles
+        ParticlesData& particles
     );
 
+    /// @brief Set animation frames regions resolved from preset.frames
+    void setFrames(std::vector<std::optional<UVRegion>> frames);
+
+    const std::vector<std::optional<UVRegion>>& getFrames() const;
+
     /// @brief Set remaining particles count to 0
     void stop();
 
@@ -0,0 +1,198 @@
+#include "LodMeshBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lighting/Lightmap.hpp"
+
+static inline uint16_t pack_uv(float value) {
+    return static_cast<uint16_t>(std::round(value * 0xFFFF));
+}
+
+static inline uint8_t pack_light(int value) {
+    return static_cast<uint8_t>(value * 255 / 15);
+}
+
+/// @brief Get max lights of blocks layer adjacent to the cell face
+/// @param origin cell first block
+static std::array<uint8_t, 4> pick_face_light(
+    const light_t* lights,
+    const voxel* voxels,
+    const LodMeshBuilder::BlockInfo* blocks,
+    const glm::ivec3& origin,
+    int size,
+    int faceIndex
+) {
+    const auto& axes = CUBE_FACE_AXES[faceIndex];
+    const glm::ivec3& normal = axes[2];
+    glm::ivec3 layer = origin;
+    for (int i = 0; i < 3; i++) {
+        if (normal[i] > 0) {
+            layer[i] += size;
+        } else if (normal[i] < 0) {
+            layer[i] -= 1;
+        }
+    }
+    if (lights == nullptr || layer.x < 0 || layer.y < 0 || layer.z < 0 ||
+        layer.x >= CHUNK_W || layer.y >= CHUNK_H || layer.z >= CHUNK_D) {
+        return {0, 0, 0, 255};
+    }
+    glm::ivec3 stepX = axes[0] * axes[0];
+    glm::ivec3 stepY = axes[1] * axes[1];
+    int light[4] {};
+    for (int a = 0; a < size; a++) {
+        for (int b = 0; b < size; b++) {
+            glm::ivec3 pos = layer + stepX * a + stepY * b;
+            if (blocks[voxels[vox_index(pos.x, pos.y, pos.z)].id].solid) {
+                continue;
+            }
+            for (int channel = 0; channel < 4; channel++) {
+                light[channel] = std::max(
+                    light[channel],
+                    static_cast<int>(Lightmap::extract(
+                        lights[vox_index(pos.x, pos.y, pos.z)], channel
+                    ))
+                );
+            }
+        }
+    }
+    return {
+        pack_light(light[0]),
+        pack_light(light[1]),
+        pack_light(light[2]),
+        pack_light(light[3]),
+    };
+}
+
+void LodMeshBuilder::build(
+    const voxel* voxels,
+    const light_t* lights,
+    const BlockInfo* blocks,
+    int level
+) {
+    const int size = 1 << level;
+    const int width = CHUNK_W / size;
+    const int height = CHUNK_H / size;
+    const int depth = CHUNK_D / size;
+    const int cellVolume = size * size * size;
+
+    vertices.clear();
+    indices.clear();
+    cells.assign(width * height * depth, BLOCK_AIR);
+
+    for (int cy = 0; cy < height; cy++) {
+        for (int cz = 0; cz < depth; cz++) {
+            for (int cx = 0; cx < width; cx++) {
+                int solidCount = 0;
+                blockid_t top = BLOCK_AIR;
+                for (int y = cy * size; y < (cy + 1) * size; y++) {
+                    for (int z = cz * size; z < (cz + 1) * size; z++) {
+                        for (int x = cx * size; x < (cx + 1) * size; x++) {
+                            blockid_t id = voxels[vox_index(x, y, z)].id;
+                            if (blocks[id].solid) {
+                                solidCount++;
+                                top = id;
+                            }
+                        }
+                    }
+                }
+                if (solidCount * 2 >= cellVolume) {
+                    cells[vox_index(cx, cy, cz, width, depth)] = top;
+                }
+            }
+        }
+    }
+
+    auto cellAt = [this, width, height, depth](const glm::ivec3& pos) {
+        if (pos.x < 0 || pos.y < 0 || pos.z < 0 || pos.x >= width ||
+            pos.y >= height || pos.z >= depth) {
+            return BLOCK_VOID;
+        }
+        return cells[vox_index(pos.x, pos.y, pos.z, width, depth)];
+    };
+    for (int cy = 0; cy < height; cy++) {
+        for (int cz = 0; cz < depth; cz++) {
+            for (int cx = 0; cx < width; cx++) {
+                glm::ivec3 cell(cx, cy, cz);
+                blockid_t id = cellAt(cell);
+                if (id == BLOCK_AIR) {
+                    continue;
+                }
+                const auto& block = blocks[id];
+                for (int faceIndex = 0; faceIndex < 6; faceIndex++) {
+                    const auto& axes = CUBE_FACE_AXES[faceIndex];
+                    glm::ivec3 neighbour = cell + axes[2];
+                    if (neighbour.y < 0) {
+                        continue;
+                    }
+                    // faces on chunk borders (void) are kept as skirts
+                    blockid_t other = cellAt(neighbour);
+                    if (other != BLOCK_AIR && other != BLOCK_VOID) {
+                        continue;
+                    }
+                    glm::ivec3 origin = cell * size;
+                    auto color = pick_face_light(
+                        lights, voxels, blocks, origin, size, faceIndex
+                    );
+                    glm::vec3 X(axes[0]);
+                    glm::vec3 Y(axes[1]);
+                    glm::vec3 Z(axes[2]);
+                    // block centers are at integer coordinates
+                    glm::vec3 center =
+                        glm::vec3(origin) + glm::vec3((size - 1) * 0.5f);
+                    float s = size * 0.5f;
+
+                    const auto& region = block.faces[faceIndex];
+                    TiledChunkVertex tiled {};
+                    auto& vertex = tiled.vertex;
+                    vertex.color = color;
+                    vertex.normal = {
+                        static_cast<uint8_t>(Z.x * 127 + 128),
+                        static_cast<uint8_t>(Z.y * 127 + 128),
+                        static_cast<uint8_t>(Z.z * 127 + 128),
+                        0,
+                    };
+                    tiled.region = {
+                        pack_uv(region.u1),
+                        pack_uv(region.v1),
+                        pack_uv(region.u2),
+                        pack_uv(region.v2),
+                    };
+                    // texture coordinates are in texture repeats
+                    const glm::vec2 corners[4] {
+                        {-1, -1}, {1, -1}, {1, 1}, {-1, 1}
+                    };
+                    uint32_t base = vertices.size();
+                    for (const auto& corner : corners) {
+                        vertex.position =
+                            center + (X * corner.x + Y * corner.y + Z) * s;
+                        vertex.uv = (corner + 1.0f) * s;
+                        vertices.push_back(tiled);
+                    }
+                    for (uint32_t i : {0, 1, 2, 0, 2, 3}) {
+                        indices.push_back(base + i);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int LodMeshBuilder::selectLevel(
+    float distance, float lodDistance, int current
+) {
+    if (lodDistance <= 0.0f) {
+        return 0;
+    }
+    auto levelAt = [lodDistance](float distance) {
+        int level = 0;
+        while (level < MAX_LEVEL && distance >= lodDistance * (1 << level)) {
+            level++;
+        }
+        return level;
+    };
+    // keep current level while it's valid for a close distance
+    return std::clamp(
+        current, levelAt(distance - HYSTERESIS), levelAt(distance + HYSTERESIS)
+    );
+}
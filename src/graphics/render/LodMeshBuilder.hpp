@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+#include "commons.hpp"
+#include "constants.hpp"
+#include "maths/UVRegion.hpp"
+#include "voxels/voxel.hpp"
+
+/// @brief Builds downsampled meshes of distant chunks. A chunk is split into
+/// cells of (1 << level) blocks, cells filled by solid blocks at least
+/// half are drawn as cubes textured with the topmost solid block faces.
+/// Faces on the chunk borders are always generated (skirts) so no holes
+/// appear between chunks meshed at different levels.
+class LodMeshBuilder {
+public:
+    /// @brief Block appearance in LOD meshes
+    struct BlockInfo {
+        /// @brief Does the block fill a cell
+        bool solid = false;
+        /// @brief Faces texture regions in the block texture faces order
+        UVRegion faces[6] {};
+    };
+
+    static constexpr int MAX_LEVEL = 3;
+
+    /// @brief Distance (chunks) the camera must move past a level
+    /// threshold before level changes
+    static constexpr float HYSTERESIS = 0.5f;
+
+    /// @param voxels chunk voxels
+    /// @param lights chunk lights (chunk voxels layout)
+    /// or nullptr for full sky light
+    /// @param blocks appearance table indexed by block id
+    /// @param level detail level [1, MAX_LEVEL]
+    void build(
+        const voxel* voxels,
+        const light_t* lights,
+        const BlockInfo* blocks,
+        int level
+    );
+
+    const std::vector<TiledChunkVertex>& getVertices() const {
+        return vertices;
+    }
+
+    const std::vector<uint32_t>& getIndices() const {
+        return indices;
+    }
+
+    /// @brief Select chunk mesh detail level.
+    /// Level N is used from lodDistance * 2^(N-1) chunks
+    /// @param distance distance from camera to chunk (chunks)
+    /// @param lodDistance first LOD level distance (chunks), 0 to disable
+    /// @param current current chunk mesh level
+    static int selectLevel(float distance, float lodDistance, int current);
+private:
+    std::vector<TiledChunkVertex> vertices;
+    std::vector<uint32_t> indices;
+    /// @brief Representative block id of cells, BLOCK_AIR if empty
+    std::vector<blockid_t> cells;
+};
@@ -0,0 +1,52 @@
+#include "Particles.hpp"
+
+#include "Emitter.hpp"
+
+void ParticlesData::add(const Particle& particle) {
+    const auto& preset = particle.emitter->preset;
+    emitters.push_back(particle.emitter);
+    randoms.push_back(particle.random);
+    positions.push_back(particle.position);
+    velocities.push_back(particle.velocity);
+    lifetimes.push_back(particle.lifetime);
+    regions.push_back(particle.region);
+    angles.push_back(particle.angle);
+    angularVelocities.push_back(particle.angularVelocity);
+    scales.push_back(
+        1.0f + ((particle.random ^ 2628172) % 1000) * 0.001f * preset.sizeSpread
+    );
+    lights.emplace_back(1.0f, 1.0f, 1.0f, 0.0f);
+}
+
+void ParticlesData::removeDead() {
+    size_t count = size();
+    for (size_t i = 0; i < count;) {
+        if (lifetimes[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        emitters[i]->refCount--;
+        // move the last particle in place of the removed one
+        count--;
+        emitters[i] = emitters[count];
+        randoms[i] = randoms[count];
+        positions[i] = positions[count];
+        velocities[i] = velocities[count];
+        lifetimes[i] = lifetimes[count];
+        regions[i] = regions[count];
+        angles[i] = angles[count];
+        angularVelocities[i] = angularVelocities[count];
+        scales[i] = scales[count];
+        lights[i] = lights[count];
+    }
+    emitters.resize(count);
+    randoms.resize(count);
+    positions.resize(count);
+    velocities.resize(count);
+    lifetimes.resize(count);
+    regions.resize(count);
+    angles.resize(count);
+    angularVelocities.resize(count);
+    scales.resize(count);
+    lights.resize(count);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "maths/UVRegion.hpp"
+
+class Emitter;
+
+struct Particle {
+    /// @brief Pointer used to access common behaviour.
+    /// Emitter must be utilized after all related particles despawn.
+    Emitter* emitter;
+    /// @brief Some random integer for visuals configuration.
+    int random;
+    /// @brief Global position
+    glm::vec3 position;
+    /// @brief Linear velocity
+    glm::vec3 velocity;
+    /// @brief Remaining life time
+    float lifetime;
+    /// @brief UV region
+    UVRegion region;
+    /// @brief Current rotation angle
+    float angle;
+    /// @brief Angular velocity
+    float angularVelocity;
+};
+
+/// @brief Particles stored as structure of arrays (see Particle fields)
+struct ParticlesData {
+    std::vector<Emitter*> emitters;
+    std::vector<int> randoms;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> velocities;
+    std::vector<float> lifetimes;
+    std::vector<UVRegion> regions;
+    std::vector<float> angles;
+    std::vector<float> angularVelocities;
+    /// @brief Size multiplier calculated from random and preset size spread
+    std::vector<float> scales;
+    /// @brief Lights calculated by the last simulation step
+    std::vector<glm::vec4> lights;
+
+    size_t size() const {
+        return positions.size();
+    }
+
+    bool empty() const {
+        return positions.empty();
+    }
+
+    void add(const Particle& particle);
+
+    /// @brief Remove particles with expired life time and release
+    /// their emitters references. Order of particles is not preserved
+    void removeDead();
+};
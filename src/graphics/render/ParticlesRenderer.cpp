@@ -24,102 +24,42 @@ ParticlesRenderer::ParticlesRenderer(
     : chunks(chunks),
       assets(assets),
       settings(settings),
-      batch(std::make_unique<MainBatch>(4096)) {
+      batch(std::make_unique<MainBatch>(4096)),
+      lightField([&chunks](int cx, int cz) {
+          return chunks.getChunk(cx, cz);
+      }) {
 }
 
 ParticlesRenderer::~ParticlesRenderer() = default;
 
-static inline void update_particle(
-    Particle& particle, float delta, const Chunks& chunks
-) {
-    const auto& preset = particle.emitter->preset;
-    auto& pos = particle.position;
-    auto& vel = particle.velocity;
-    auto& angle = particle.angle;
-
-    vel += delta * preset.acceleration;
-    if (preset.collision && chunks.isObstacleAt(pos + vel * delta)) {
-        vel *= 0.0f;
-    }
-    pos += vel * delta;
-    angle += particle.angularVelocity * delta;
-    particle.lifetime -= delta;
-}
-
 void ParticlesRenderer::renderParticles(const Camera& camera, float delta) {
     const auto& right = camera.right;
     const auto& up = camera.up;
 
-    bool backlight = settings->backlight.get();
+    lightField.reset(settings->backlight.get());
+    auto isObstacle = [this](const glm::vec3& pos) {
+        return chunks.isObstacleAt(pos) != nullptr;
+    };
 
     std::vector<const Texture*> unusedTextures;
 
-    for (auto& [texture, vec] : particles) {
-        if (vec.empty()) {
+    for (auto& [texture, data] : particles) {
+        if (data.empty()) {
             unusedTextures.push_back(texture);
             continue;
         }
         batch->setTexture(texture);
 
-        visibleParticles += vec.size();
-
-        auto iter = vec.begin();
-        while (iter != vec.end()) {
-            auto& particle = *iter;
-            auto& emitter = *particle.emitter;
-            auto& preset = emitter.preset;
-
-            if (!preset.frames.empty()) {
-                float time = preset.lifetime - particle.lifetime;
-                int framesCount = preset.frames.size();
-                int frameid = time / preset.lifetime * framesCount;
-                int frameid2 = glm::min(
-                    (time + delta) / preset.lifetime * framesCount,
-                    framesCount - 1.0f
-                );
-                if (frameid2 != frameid) {
-                    auto tregion = util::get_texture_region(
-                        assets, preset.frames.at(frameid2), ""
-                    );
-                    if (tregion.texture == texture) {
-                        particle.region = tregion.region;
-                    }
-                }
-            }
-            update_particle(particle, delta, chunks);
-
-            float scale = 1.0f + ((particle.random ^ 2628172) % 1000) *
-                0.001f * preset.sizeSpread;
-
-            glm::vec4 light(1, 1, 1, 0);
-            if (preset.lighting) {
-                light = MainBatch::sampleLight(
-                    particle.position,
-                    chunks,
-                    backlight
-                );
-                auto size = glm::max(glm::vec3(0.5f), preset.size * scale);
-                for (int x = -1; x <= 1; x++) {
-                    for (int y = -1; y <= 1; y++) {
-                        for (int z = -1; z <= 1; z++) {
-                            light = glm::max(
-                                light,
-                                MainBatch::sampleLight(
-                                    particle.position -
-                                        size * glm::vec3(x, y, z),
-                                    chunks,
-                                    backlight
-                                )
-                            );
-                        }
-                    }
-                }
-                light *= 0.9f + (particle.random % 100) * 0.001f;
-            }
+        visibleParticles += data.size();
+
+        simulate_particles(data, delta, isObstacle, lightField);
+
+        for (size_t i = 0; i < data.size(); i++) {
+            const auto& preset = data.emitters[i]->preset;
 
             glm::vec3 localRight = right;
             glm::vec3 localUp = preset.globalUpVector ? glm::vec3(0, 1, 0) : up;
-            float angle = particle.angle;
+            float angle = data.angles[i];
             if (glm::abs(angle) >= 0.005f) {
                 glm::vec3 rotatedRight(glm::cos(angle), -glm::sin(angle), 0.0f);
                 glm::vec3 rotatedUp(glm::sin(angle), glm::cos(angle), 0.0f);
@@ -130,23 +70,18 @@ void ParticlesRenderer::renderParticles(const Camera& camera, float delta) {
                         camera.front * rotatedUp.z;
             }
             batch->quad(
-                particle.position,
+                data.positions[i],
                 localRight,
                 localUp,
                 -camera.front,
-                preset.size * scale,
-                light,
+                preset.size * data.scales[i],
+                data.lights[i],
                 glm::vec3(1.0f),
-                particle.region,
+                data.regions[i],
                 preset.lighting ? 0.0f : 1.0f
             );
-            if (particle.lifetime <= 0.0f) {
-                iter = vec.erase(iter);
-                emitter.refCount--;
-            } else {
-                iter++;
-            }
         }
+        data.removeDead();
     }
     batch->flush();
     for (const auto& texture : unusedTextures) {
@@ -171,9 +106,7 @@ void ParticlesRenderer::render(const Camera& camera, float delta) {
             continue;
         }
         auto texture = emitter.getTexture();
-        std::vector<Particle>* vec;
-        vec = &particles[texture];
-        emitter.update(delta, camera.position, *vec);
+        emitter.update(delta, camera.position, particles[texture]);
         iter++;
     }
 }
@@ -187,6 +120,20 @@ Emitter* ParticlesRenderer::getEmitter(u64id_t id) const {
 }
 
 u64id_t ParticlesRenderer::add(std::unique_ptr<Emitter> emitter) {
+    // frames regions are resolved once instead of every frame switch
+    const auto& names = emitter->preset.frames;
+    if (!names.empty()) {
+        std::vector<std::optional<UVRegion>> frames;
+        for (const auto& name : names) {
+            auto tregion = util::get_texture_region(assets, name, "");
+            if (tregion.texture == emitter->getTexture()) {
+                frames.push_back(tregion.region);
+            } else {
+                frames.push_back(std::nullopt);
+            }
+        }
+        emitter->setFrames(std::move(frames));
+    }
     u64id_t uid = nextEmitter++;
     emitters[uid] = std::move(emitter);
     return uid;
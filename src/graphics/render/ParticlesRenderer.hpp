@@ -5,6 +5,7 @@
 #include <unordered_map>
 
 #include "Emitter.hpp"
+#include "ParticlesSimulation.hpp"
 #include "typedefs.hpp"
 
 class Texture;
@@ -19,8 +20,9 @@ class ParticlesRenderer {
     const Chunks& chunks;
     const Assets& assets;
     const GraphicsSettings* settings;
-    std::unordered_map<const Texture*, std::vector<Particle>> particles;
+    std::unordered_map<const Texture*, ParticlesData> particles;
     std::unique_ptr<MainBatch> batch;
+    ParticlesLightField lightField;
 
     std::unordered_map<u64id_t, std::unique_ptr<Emitter>> emitters;
     u64id_t nextEmitter = 1;
@@ -0,0 +1,144 @@
+#include "ParticlesSimulation.hpp"
+
+#include <cmath>
+
+#include "constants.hpp"
+#include "maths/voxmaths.hpp"
+#include "lighting/Lightmap.hpp"
+#include "voxels/Chunk.hpp"
+#include "Emitter.hpp"
+
+ParticlesLightField::ParticlesLightField(ChunkSupplier supplier)
+    : supplier(std::move(supplier)) {
+}
+
+void ParticlesLightField::reset(bool backlight) {
+    this->backlight = backlight;
+    for (auto& entry : cache) {
+        entry.valid = false;
+    }
+}
+
+const Lightmap* ParticlesLightField::getLightmap(int cx, int cz) {
+    auto& entry = cache[(cz & (CACHE_SIDE - 1)) * CACHE_SIDE +
+                        (cx & (CACHE_SIDE - 1))];
+    if (!entry.valid || entry.x != cx || entry.z != cz) {
+        const Chunk* chunk = supplier(cx, cz);
+        entry = CacheEntry {
+            cx, cz, chunk ? chunk->lightmap.get() : nullptr, true};
+    }
+    return entry.lightmap;
+}
+
+light_t ParticlesLightField::get(int x, int y, int z) {
+    if (y < 0 || y >= CHUNK_H) {
+        return 0;
+    }
+    int cx = floordiv<CHUNK_W>(x);
+    int cz = floordiv<CHUNK_D>(z);
+    const Lightmap* lightmap = getLightmap(cx, cz);
+    if (lightmap == nullptr) {
+        return 0;
+    }
+    return lightmap->get(x - cx * CHUNK_W, y, z - cz * CHUNK_D);
+}
+
+/// @brief Collect distinct blocks coordinates of an axis samples
+static inline int axis_blocks(float center, float size, float max, int* dst) {
+    int count = 0;
+    for (float value : {center - size, center, center + size}) {
+        int coord = static_cast<int>(std::floor(std::min(max, value)));
+        bool found = false;
+        for (int i = 0; i < count; i++) {
+            found |= dst[i] == coord;
+        }
+        if (!found) {
+            dst[count++] = coord;
+        }
+    }
+    return count;
+}
+
+glm::vec4 ParticlesLightField::sample(
+    const glm::vec3& position, const glm::vec3& size
+) {
+    int xs[3], ys[3], zs[3];
+    int countX = axis_blocks(position.x, size.x, INFINITY, xs);
+    int countY = axis_blocks(position.y, size.y, CHUNK_H - 1.0f, ys);
+    int countZ = axis_blocks(position.z, size.z, INFINITY, zs);
+
+    int channels[4] {};
+    for (int y = 0; y < countY; y++) {
+        for (int z = 0; z < countZ; z++) {
+            for (int x = 0; x < countX; x++) {
+                light_t light = get(xs[x], ys[y], zs[z]);
+                for (int c = 0; c < 4; c++) {
+                    channels[c] = std::max(
+                        channels[c],
+                        static_cast<int>(Lightmap::extract(light, c))
+                    );
+                }
+            }
+        }
+    }
+    int minIntensity = backlight ? 1 : 0;
+    return glm::vec4(
+        std::max(channels[0], minIntensity),
+        std::max(channels[1], minIntensity),
+        std::max(channels[2], minIntensity),
+        std::max(channels[3], minIntensity)
+    ) / 15.0f;
+}
+
+static inline void update_frame(
+    ParticlesData& particles, size_t index, float delta
+) {
+    const auto& emitter = *particles.emitters[index];
+    const auto& preset = emitter.preset;
+    const auto& frames = emitter.getFrames();
+    if (frames.empty()) {
+        return;
+    }
+    float time = preset.lifetime - particles.lifetimes[index];
+    int framesCount = frames.size();
+    int frameid = time / preset.lifetime * framesCount;
+    int frameid2 = glm::min(
+        (time + delta) / preset.lifetime * framesCount, framesCount - 1.0f
+    );
+    if (frameid2 != frameid && frameid2 >= 0 && frames[frameid2]) {
+        particles.regions[index] = *frames[frameid2];
+    }
+}
+
+void simulate_particles(
+    ParticlesData& particles,
+    float delta,
+    const std::function<bool(const glm::vec3&)>& isObstacle,
+    ParticlesLightField& lightField
+) {
+    size_t count = particles.size();
+    for (size_t i = 0; i < count; i++) {
+        const auto& preset = particles.emitters[i]->preset;
+        update_frame(particles, i, delta);
+
+        auto& pos = particles.positions[i];
+        auto& vel = particles.velocities[i];
+        vel += delta * preset.acceleration;
+        if (preset.collision && isObstacle(pos + vel * delta)) {
+            vel *= 0.0f;
+        }
+        pos += vel * delta;
+        particles.angles[i] += particles.angularVelocities[i] * delta;
+        particles.lifetimes[i] -= delta;
+
+        if (preset.lighting) {
+            auto size = glm::max(
+                glm::vec3(0.5f), preset.size * particles.scales[i]
+            );
+            particles.lights[i] = lightField.sample(pos, size) *
+                (0.9f + (particles.randoms[i] % 100) * 0.001f);
+        } else {
+            particles.lights[i] = glm::vec4(1, 1, 1, 0);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <glm/glm.hpp>
+
+#include "typedefs.hpp"
+#include "voxels/voxel.hpp"
+#include "Particles.hpp"
+
+class Chunk;
+class Lightmap;
+
+/// @brief Chunks lightmaps cache for particles lighting. Chunks are looked
+/// up once per simulation step instead of on every light sample
+class ParticlesLightField {
+public:
+    using ChunkSupplier = std::function<const Chunk*(int cx, int cz)>;
+
+    explicit ParticlesLightField(ChunkSupplier supplier);
+
+    /// @brief Forget cached chunks, must be called before each step
+    /// as chunks may be unloaded
+    void reset(bool backlight);
+
+    /// @brief Get block light, 0 if chunk is not loaded
+    light_t get(int x, int y, int z);
+
+    /// @brief Get max normalized light of blocks at the position and
+    /// at the position shifted by size in each direction
+    /// (3x3x3 neighbourhood)
+    glm::vec4 sample(const glm::vec3& position, const glm::vec3& size);
+private:
+    struct CacheEntry {
+        int x;
+        int z;
+        const Lightmap* lightmap;
+        bool valid;
+    };
+    static constexpr int CACHE_SIDE = 8;
+
+    ChunkSupplier supplier;
+    std::array<CacheEntry, CACHE_SIDE * CACHE_SIDE> cache {};
+    bool backlight = false;
+
+    const Lightmap* getLightmap(int cx, int cz);
+};
+
+/// @brief Particles simulation step: animation frames, movement and lights.
+/// Does not use assets and graphics API so may run on a worker thread
+/// @param isObstacle collision check used by presets with collision enabled
+void simulate_particles(
+    ParticlesData& particles,
+    float delta,
+    const std::function<bool(const glm::vec3&)>& isObstacle,
+    ParticlesLightField& lightField
+);
@@ -0,0 +1,106 @@
+#include "TranslucentSorter.hpp"
+
+#include <cstring>
+#include <numeric>
+
+/// @brief Quantize squared distance so the farthest entry has the least key.
+/// Bits of a non-negative float are ordered as the float itself
+static inline uint32_t distance_key(const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 delta = a - b;
+    float distance2 =
+        delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+    uint32_t bits;
+    std::memcpy(&bits, &distance2, sizeof(bits));
+    return ~bits;
+}
+
+bool TranslucentSorter::sort(
+    const TranslucentEntries& translucent,
+    const glm::vec3& cameraPosition,
+    std::vector<uint32_t>& order
+) {
+    const auto& entries = translucent.entries;
+    size_t count = entries.size();
+    keys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = distance_key(entries[i].position, cameraPosition);
+    }
+    if (order.size() != count) {
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0);
+        radixSort(order);
+        return true;
+    }
+    size_t maxMoves = count * MAX_MOVES_PER_ENTRY;
+    size_t moves = 0;
+    for (size_t i = 1; i < count; i++) {
+        uint32_t index = order[i];
+        uint32_t key = keys[index];
+        size_t j = i;
+        for (; j > 0 && keys[order[j - 1]] > key; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = index;
+        moves += i - j;
+        if (moves > maxMoves) {
+            // order is still a valid permutation
+            radixSort(order);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranslucentSorter::radixSort(std::vector<uint32_t>& order) {
+    size_t count = order.size();
+    if (count == 0) {
+        return;
+    }
+    items.resize(count);
+    itemsBuffer.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        items[i] = static_cast<uint64_t>(keys[order[i]]) << 32 | order[i];
+    }
+    // LSD radix sort by 8 bits of the key per pass
+    for (int shift = 32; shift < 64; shift += 8) {
+        size_t offsets[256] {};
+        for (uint64_t item : items) {
+            offsets[(item >> shift) & 0xFF]++;
+        }
+        if (offsets[(items[0] >> shift) & 0xFF] == count) {
+            // all items have the same digit
+            continue;
+        }
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            size_t digitCount = offset;
+            offset = sum;
+            sum += digitCount;
+        }
+        for (uint64_t item : items) {
+            itemsBuffer[offsets[(item >> shift) & 0xFF]++] = item;
+        }
+        items.swap(itemsBuffer);
+    }
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(items[i]);
+    }
+}
+
+void TranslucentSorter::writeIndices(
+    const TranslucentEntries& translucent,
+    const std::vector<uint32_t>& order,
+    std::vector<uint32_t>& indices
+) {
+    indices.resize(translucent.vertexCount);
+    size_t offset = 0;
+    for (uint32_t index : order) {
+        const auto& entry = translucent.entries[index];
+        std::iota(
+            indices.begin() + offset,
+            indices.begin() + offset + entry.vertexCount,
+            entry.firstVertex
+        );
+        offset += entry.vertexCount;
+    }
+}
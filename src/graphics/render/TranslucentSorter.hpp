@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/vec3.hpp>
+
+/// @brief Translucent blocks of a chunk sorted mesh. Vertices of entries
+/// are stored in the mesh vertex buffer once, only indices are reordered
+struct TranslucentEntries {
+    struct Entry {
+        /// @brief Entry center used to calculate distance to camera
+        glm::vec3 position;
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+    };
+    std::vector<Entry> entries;
+    size_t vertexCount = 0;
+};
+
+/// @brief Sorts translucent entries back-to-front by quantized squared
+/// distance to camera. Previous order is sorted with insertion sort as it's
+/// nearly sorted after a small camera movement, radix sort is used if too
+/// many entries have moved. Not thread-safe, use a sorter per thread
+class TranslucentSorter {
+public:
+    /// @brief Max average number of insertion sort moves per entry
+    /// before switching to radix sort
+    static constexpr size_t MAX_MOVES_PER_ENTRY = 4;
+
+    /// @brief Sort entries
+    /// @param order previous order, replaced with identity if size
+    /// does not match entries count
+    /// @return true if radix sort was used
+    bool sort(
+        const TranslucentEntries& entries,
+        const glm::vec3& cameraPosition,
+        std::vector<uint32_t>& order
+    );
+
+    /// @brief Write triangles indices of entries in the given order
+    static void writeIndices(
+        const TranslucentEntries& entries,
+        const std::vector<uint32_t>& order,
+        std::vector<uint32_t>& indices
+    );
+private:
+    std::vector<uint32_t> keys;
+    std::vector<uint64_t> items;
+    std::vector<uint64_t> itemsBuffer;
+
+    void radixSort(std::vector<uint32_t>& order);
+};
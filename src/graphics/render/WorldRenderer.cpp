@@ -299,10 +299,12 @@ void WorldRenderer::renderFrame(
     auto& entityShader = assets.require<Shader>("entity");
     auto& translucentShader = assets.require<Shader>("translucent");
     auto& deferredShader = assets.require<PostEffect>("deferred_lighting").getShader();
+    auto& shadowsShader = assets.require<Shader>("shadows");
     const auto& settings = engine.getSettings();
 
     Shader* affectedShaders[] {
-        &mainShader, &entityShader, &translucentShader, &deferredShader
+        &mainShader, &entityShader, &translucentShader, &deferredShader,
+        &shadowsShader
     };
 
     gbufferPipeline = settings.graphics.advancedRender.get();
@@ -312,17 +314,20 @@ void WorldRenderer::renderFrame(
     CompileTimeShaderSettings currentSettings {
         gbufferPipeline,
         shadowsQuality != 0,
-        settings.graphics.ssao.get() && gbufferPipeline
+        settings.graphics.ssao.get() && gbufferPipeline,
+        settings.graphics.packedChunkVertices.get()
     };
     if (
         prevCTShaderSettings.advancedRender != currentSettings.advancedRender ||
         prevCTShaderSettings.shadows != currentSettings.shadows ||
-        prevCTShaderSettings.ssao != currentSettings.ssao
+        prevCTShaderSettings.ssao != currentSettings.ssao ||
+        prevCTShaderSettings.packedChunkVertices != currentSettings.packedChunkVertices
     ) {
         std::vector<std::string> defines;
         if (currentSettings.shadows) defines.emplace_back("ENABLE_SHADOWS");
         if (currentSettings.ssao) defines.emplace_back("ENABLE_SSAO");
         if (currentSettings.advancedRender) defines.emplace_back("ADVANCED_RENDER");
+        if (currentSettings.packedChunkVertices) defines.emplace_back("PACKED_CHUNK_VERTEX");
 
         for (auto shader : affectedShaders) {
             shader->recompile(defines);
@@ -0,0 +1,84 @@
+#include "commons.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+static inline uint16_t pack_unorm16(float value) {
+    return static_cast<uint16_t>(
+        std::round(std::clamp(value, 0.0f, 1.0f) * 0xFFFF)
+    );
+}
+
+PackedChunkVertex PackedChunkVertex::pack(const ChunkVertex& vertex) {
+    PackedChunkVertex packed;
+    for (int i = 0; i < 3; i++) {
+        float value = std::round(
+            (vertex.position[i] + POSITION_OFFSET) * POSITION_SCALE
+        );
+        packed.position[i] =
+            static_cast<uint16_t>(std::clamp(value, 0.0f, 65535.0f));
+    }
+    uint16_t bits = 0;
+    for (int i = 0; i < 3; i++) {
+        float n = (vertex.normal[i] - 128) / 127.0f;
+        int value = static_cast<int>(std::round(n * 15.0f + 15.0f));
+        bits |= std::clamp(value, 0, 30) << (i * 5);
+    }
+    if (vertex.normal[3] >= 128) {
+        bits |= 0x8000;
+    }
+    packed.position[3] = bits;
+    packed.color = vertex.color;
+    packed.uv = {pack_unorm16(vertex.uv.x), pack_unorm16(vertex.uv.y)};
+    packed.regionEnd = {0, 0};
+    return packed;
+}
+
+PackedChunkVertex PackedChunkVertex::pack(const TiledChunkVertex& vertex) {
+    auto packed = pack(vertex.vertex);
+    // uv is derived from the position
+    const auto& region = vertex.region;
+    packed.uv = {region[0], region[1]};
+    packed.regionEnd = {region[2], region[3]};
+    return packed;
+}
+
+TiledChunkVertex PackedChunkVertex::unpack() const {
+    TiledChunkVertex tiled {};
+    auto& vertex = tiled.vertex;
+    for (int i = 0; i < 3; i++) {
+        vertex.position[i] = position[i] / POSITION_SCALE - POSITION_OFFSET;
+    }
+    glm::vec3 normal;
+    for (int i = 0; i < 3; i++) {
+        normal[i] = ((position[3] >> (i * 5)) & 0x1F) / 15.0f - 1.0f;
+        vertex.normal[i] =
+            static_cast<uint8_t>(std::round(normal[i] * 127 + 128));
+    }
+    vertex.normal[3] = (position[3] & 0x8000) ? 255 : 0;
+    vertex.color = color;
+
+    if (regionEnd[0] == 0 && regionEnd[1] == 0) {
+        vertex.uv = {uv[0] / 65535.0f, uv[1] / 65535.0f};
+        return tiled;
+    }
+    tiled.region = {uv[0], uv[1], regionEnd[0], regionEnd[1]};
+
+    // repeated region faces are axis-aligned, texture repeats are
+    // measured along face axes from block edges
+    glm::vec3 axisX;
+    if (std::abs(normal.x) > 0.5f) {
+        axisX = {0.0f, 0.0f, -normal.x};
+    } else if (std::abs(normal.y) > 0.5f) {
+        axisX = {1.0f, 0.0f, 0.0f};
+    } else {
+        axisX = {normal.z, 0.0f, 0.0f};
+    }
+    glm::vec3 axisY = std::abs(normal.y) > 0.5f
+                          ? glm::vec3(0.0f, 0.0f, -normal.y)
+                          : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 pos = vertex.position + 0.5f;
+    vertex.uv = {glm::dot(pos, axisX), glm::dot(pos, axisY)};
+    return tiled;
+}
@@ -7,8 +7,19 @@
 #include <glm/vec3.hpp>
 
 #include "graphics/core/MeshData.hpp"
+#include "ChunkVisibility.hpp"
 #include "util/Buffer.hpp"
 
+/// @brief Cube face X, Y and normal axes (texture faces order)
+inline const glm::ivec3 CUBE_FACE_AXES[6][3] {
+    {{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}},
+    {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}},
+    {{1, 0, 0}, {0, 0, 1}, {0, -1, 0}},
+    {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},
+    {{-1, 0, 0}, {0, 1, 0}, {0, 0, -1}},
+    {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+};
+
 /// @brief Chunk mesh vertex format
 struct ChunkVertex {
     glm::vec3 position;
@@ -24,17 +35,64 @@ struct ChunkVertex {
         {{}, 0}};
 };
 
+/// @brief Vertex format of merged faces repeating a texture region
+/// (greedy meshing and LOD meshes), kept in a separate mesh
+struct TiledChunkVertex {
+    /// @brief uv is in texture repeats
+    ChunkVertex vertex;
+    /// @brief Atlas region (u1, v1, u2, v2) repeated over the face
+    std::array<uint16_t, 4> region;
+
+    static constexpr VertexAttribute ATTRIBUTES[] = {
+        {VertexAttribute::Type::FLOAT, false, 3},
+        {VertexAttribute::Type::FLOAT, false, 2},
+        {VertexAttribute::Type::UNSIGNED_BYTE, true, 4},
+        {VertexAttribute::Type::UNSIGNED_BYTE, true, 4},
+        {VertexAttribute::Type::UNSIGNED_SHORT, true, 4},
+        {{}, 0}};
+};
+
+/// @brief Compact chunk mesh vertex format (20 bytes), used for both
+/// ordinary and repeated region faces
+struct PackedChunkVertex {
+    /// @brief x, y, z in fixed point relative to the chunk mesh origin,
+    /// normal (5 bits per axis) and emission flag (the highest bit)
+    std::array<uint16_t, 4> position;
+    /// @brief Atlas coordinate or first corner of a repeated region
+    std::array<uint16_t, 2> uv;
+    std::array<uint8_t, 4> color;
+    /// @brief Second corner of a repeated region or zero
+    std::array<uint16_t, 2> regionEnd;
+
+    static constexpr VertexAttribute ATTRIBUTES[] = {
+        {VertexAttribute::Type::UNSIGNED_SHORT, false, 4},
+        {VertexAttribute::Type::UNSIGNED_SHORT, true, 2},
+        {VertexAttribute::Type::UNSIGNED_BYTE, true, 4},
+        {VertexAttribute::Type::UNSIGNED_SHORT, true, 2},
+        {{}, 0}};
+
+    /// @brief Positions precision is 1 / POSITION_SCALE
+    static constexpr float POSITION_SCALE = 128.0f;
+    /// @brief Positions range is [-POSITION_OFFSET, 512 - POSITION_OFFSET)
+    static constexpr float POSITION_OFFSET = 128.0f;
+
+    static PackedChunkVertex pack(const ChunkVertex& vertex);
+    static PackedChunkVertex pack(const TiledChunkVertex& vertex);
+
+    /// @brief Decode vertex the same way as chunk shaders do.
+    /// uv of a repeated region face is calculated from the position,
+    /// region is zero for ordinary faces
+    TiledChunkVertex unpack() const;
+};
+
 template<typename VertexStructure>
 class Mesh;
 
+struct TranslucentEntries;
+
 struct SortingMeshEntry {
     glm::vec3 position;
     util::Buffer<ChunkVertex> vertexData;
-    long long distance;
-
-    inline bool operator<(const SortingMeshEntry &o) const noexcept {
-        return distance > o.distance;
-    }
 };
 
 struct SortingMeshData {
@@ -44,10 +102,40 @@ struct SortingMeshData {
 struct ChunkMeshData {
     MeshData<ChunkVertex> mesh;
     SortingMeshData sortingMesh;
+    /// @brief Used instead of mesh and tiledMesh if vertices are packed
+    MeshData<PackedChunkVertex> packedMesh {};
+    bool packed = false;
+    ChunkVisibility visibility {};
+    /// @brief Detail level, 0 is full resolution
+    int lod = 0;
+    /// @brief Merged faces, drawn with the same index buffer number as mesh
+    MeshData<TiledChunkVertex> tiledMesh {};
 };
 
 struct ChunkMesh {
     std::unique_ptr<Mesh<ChunkVertex>> mesh;
     SortingMeshData sortingMeshData;
-    std::unique_ptr<Mesh<ChunkVertex> > sortedMesh = nullptr;
+    /// @brief Translucent blocks mesh, built from sortingMeshData on first
+    /// draw. Only the index buffer is updated when entries are re-sorted
+    std::unique_ptr<Mesh<ChunkVertex>> sortedMesh {};
+    /// @brief sortedMesh entries, shared with sorting jobs
+    std::shared_ptr<const TranslucentEntries> translucent {};
+    /// @brief Current back-to-front order of translucent entries
+    std::vector<uint32_t> translucentOrder {};
+    /// @brief Camera position translucent entries were sorted for
+    glm::vec3 sortPosition {};
+    /// @brief Is a sorting job in progress
+    bool sortPending = false;
+    /// @brief Used instead of mesh and tiledMesh if vertices are packed
+    std::unique_ptr<Mesh<PackedChunkVertex>> packedMesh {};
+    /// @brief Merged faces mesh or nullptr if there are no merged faces
+    std::unique_ptr<Mesh<TiledChunkVertex>> tiledMesh {};
+    /// @brief Sections faces connectivity used for occlusion culling
+    ChunkVisibility visibility {};
+    /// @brief Detail level, 0 is full resolution
+    int lod = 0;
+
+    bool isPacked() const {
+        return packedMesh != nullptr;
+    }
 };
@@ -172,19 +172,25 @@ bool io::write_binary_json(
     return io::write_bytes(file, bytes.data(), bytes.size());
 }
 
-dv::value io::read_json(const path& filename) {
+dv::value io::read_json(
+    const path& filename, const std::shared_ptr<dv::Arena>& arena
+) {
     std::string text = io::read_string(filename);
-    return json::parse(filename.string(), text);
+    return json::parse(filename.string(), text, arena);
 }
 
-dv::value io::read_binary_json(const path& file) {
+dv::value io::read_binary_json(
+    const path& file, const std::shared_ptr<dv::Arena>& arena
+) {
     size_t size;
     auto bytes = io::read_bytes(file, size);
-    return json::from_binary(bytes.get(), size);
+    return json::from_binary(bytes.get(), size, arena);
 }
 
-dv::value io::read_toml(const path& file) {
-    return toml::parse(file.string(), io::read_string(file));
+dv::value io::read_toml(
+    const path& file, const std::shared_ptr<dv::Arena>& arena
+) {
+    return toml::parse(file.string(), io::read_string(file), arena);
 }
 
 std::vector<std::string> io::read_list(const io::path& filename) {
@@ -333,7 +339,9 @@ std::filesystem::path io::resolve(const io::path& file) {
 #include "coders/json.hpp"
 #include "coders/toml.hpp"
 
-using DecodeFunc = dv::value(*)(std::string_view, std::string_view);
+using DecodeFunc = dv::value (*)(
+    std::string_view, std::string_view, const std::shared_ptr<dv::Arena>&
+);
 
 static std::map<fs::path, DecodeFunc> data_decoders {
     {fs::u8path(".json"), json::parse},
@@ -348,14 +356,16 @@ bool io::is_data_interchange_format(const std::string& ext) {
     return data_decoders.find(ext) != data_decoders.end();
 }
 
-dv::value io::read_object(const path& file) {
+dv::value io::read_object(
+    const path& file, const std::shared_ptr<dv::Arena>& arena
+) {
     const auto& found = data_decoders.find(file.extension());
     if (found == data_decoders.end()) {
         throw std::runtime_error("unknown file format");
     }
     auto text = read_string(file);
     try {
-        return found->second(file.string(), text);
+        return found->second(file.string(), text, arena);
     } catch (const parsing_error& err) {
         throw std::runtime_error(err.errorLog());
     }
@@ -161,14 +161,21 @@ namespace io {
 
     /// @brief Read JSON or BJSON file
     /// @param file *.json or *.bjson file
-    dv::value read_json(const path& file);
+    /// @param arena optional arena to allocate the tree objects and lists in
+    dv::value read_json(
+        const path& file, const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
     
     /// @brief Read BJSON file
-    dv::value read_binary_json(const path& file);
+    dv::value read_binary_json(
+        const path& file, const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
     
     /// @brief Read TOML file
     /// @param file *.toml file
-    dv::value read_toml(const path& file);
+    dv::value read_toml(
+        const path& file, const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
 
     /// @brief Read list of strings from the file
     std::vector<std::string> read_list(const io::path& file);
@@ -217,5 +224,7 @@ namespace io {
     /// @brief Check if file extension is one of the supported data interchange formats
     bool is_data_interchange_format(const std::string& ext);
     
-    dv::value read_object(const path& file);
+    dv::value read_object(
+        const path& file, const std::shared_ptr<dv::Arena>& arena = nullptr
+    );
 }
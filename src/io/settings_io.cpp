@@ -72,6 +72,7 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.add("dense-render", &settings.graphics.denseRender);
     builder.add("gamma", &settings.graphics.gamma);
     builder.add("frustum-culling", &settings.graphics.frustumCulling);
+    builder.add("occlusion-culling", &settings.graphics.occlusionCulling);
     builder.add("skybox-resolution", &settings.graphics.skyboxResolution);
     builder.add("chunk-max-vertices", &settings.graphics.chunkMaxVertices);
     builder.add("chunk-max-vertices-dense", &settings.graphics.chunkMaxVerticesDense);
@@ -81,14 +82,14 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.add("shadows-quality", &settings.graphics.shadowsQuality);
     builder.add("dense-render-distance", &settings.graphics.denseRenderDistance);
     builder.add("soft-lighting", &settings.graphics.softLighting);
+    builder.add("greedy-meshing", &settings.graphics.greedyMeshing);
+    builder.add("packed-chunk-vertices", &settings.graphics.packedChunkVertices);
+    builder.add("lod-distance", &settings.graphics.lodDistance);
 
     builder.addSection("ui");
     builder.add("language", &settings.ui.language);
     builder.add("world-preview-size", &settings.ui.worldPreviewSize);
 
-    builder.addSection("pathfinding");
-    builder.add("steps-per-async-agent", &settings.pathfinding.stepsPerAsyncAgent);
-
     builder.addSection("debug");
     builder.add("generator-test-mode", &settings.debug.generatorTestMode);
     builder.add("do-write-lights", &settings.debug.doWriteLights);
@@ -1,5 +1,8 @@
 #include "Inventory.hpp"
 
+#include <stdexcept>
+
+#include "coders/binary_json.hpp"
 #include "content/ContentReport.hpp"
 #include "debug/Logger.hpp"
 
@@ -84,6 +87,53 @@ void Inventory::deserialize(const dv::value& src) {
     }
 }
 
+static void deserialize_slot(json::BjsonReader& reader, ItemStack& slot) {
+    using Token = json::BjsonReader::Token;
+    if (reader.token() != Token::BEGIN_OBJECT) {
+        throw std::runtime_error("inventory slot document expected");
+    }
+    itemid_t id = 0;
+    itemcount_t count = 0;
+    dv::value fields = nullptr;
+    while (reader.next() != Token::END) {
+        auto key = reader.key();
+        if (key == "id") {
+            id = reader.getInteger();
+        } else if (key == "count") {
+            count = reader.getInteger();
+        } else if (key == "fields") {
+            fields = reader.readValue();
+        } else {
+            reader.skip();
+        }
+    }
+    slot.set(ItemStack(id, count, fields));
+}
+
+void Inventory::deserialize(json::BjsonReader& reader) {
+    using Token = json::BjsonReader::Token;
+    if (reader.token() != Token::BEGIN_OBJECT) {
+        throw std::runtime_error("inventory document expected");
+    }
+    id = 1;
+    while (reader.next() != Token::END) {
+        auto key = reader.key();
+        if (key == "id") {
+            id = reader.getInteger();
+        } else if (key == "slots" && reader.token() == Token::BEGIN_LIST) {
+            size_t index = 0;
+            while (reader.next() != Token::END) {
+                if (index == slots.size()) {
+                    slots.emplace_back();
+                }
+                deserialize_slot(reader, slots[index++]);
+            }
+        } else {
+            reader.skip();
+        }
+    }
+}
+
 dv::value Inventory::serialize() const {
     auto map = dv::object();
     map["id"] = id;
@@ -10,6 +10,10 @@
 class ContentReport;
 class ContentIndices;
 
+namespace json {
+    class BjsonReader;
+}
+
 class Inventory : public Serializable {
     int64_t id;
     std::vector<ItemStack> slots;
@@ -37,6 +41,11 @@ public:
 
     void deserialize(const dv::value& src) override;
 
+    /// @brief Read inventory from bjson document without building
+    /// an intermediate dv::value tree
+    /// @param reader reader at the document BEGIN_OBJECT token
+    void deserialize(json::BjsonReader& reader);
+
     dv::value serialize() const override;
 
     void check(const ContentIndices& indices);
@@ -32,6 +32,9 @@ void LightSolver::add(int x, int y, int z, int emission) {
     addqueue.push(lightentry {x, y, z, ubyte(emission)});
 
     chunk->flags.modified = true;
+    if (emission > light) {
+        chunk->flags.unsavedLights = true;
+    }
     lightmap.set(x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, channel, emission);
 }
 
@@ -52,6 +55,7 @@ void LightSolver::remove(int x, int y, int z) {
         return;
     }
     remqueue.push(lightentry {x, y, z, light});
+    chunk->flags.unsavedLights = true;
     lightmap.set(x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, channel, 0);
 }
 
@@ -86,6 +90,7 @@ void LightSolver::solve(){
 
                 ubyte light = lightmap.get(lx,y,lz, channel);
                 if (light != 0 && light == entry.light-1){
+                    chunk->flags.unsavedLights = true;
                     voxel* vox = chunks.get(x, y, z);
                     if (vox && vox->id != 0) {
                         const Block* block = blockDefs[vox->id];
@@ -129,6 +134,7 @@ void LightSolver::solve(){
             voxel& v = chunk->voxels[vox_index(lx, y, lz)];
             const Block* block = blockDefs[v.id];
             if (block->lightPassing && light+2 <= entry.light){
+                chunk->flags.unsavedLights = true;
                 lightmap.set(
                     x-chunk->x*CHUNK_W, y, z-chunk->z*CHUNK_D, 
                     channel, 
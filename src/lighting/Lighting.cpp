@@ -9,8 +9,10 @@
 #include "constants.hpp"
 #include "util/timeutil.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 
 #include <memory>
+#include <vector>
 
 static debug::Logger logger("lighting");
 
@@ -70,6 +72,7 @@ void Lighting::prebuildSkyLight(Chunk& chunk, const ContentIndices& indices) {
 }
 
 void Lighting::buildSkyLight(int cx, int cz){
+    debug::ProfileZone zone("Lighting::buildSkyLight");
     const auto blockDefs = content.getIndices()->blocks.getDefs();
 
     Chunk* chunk = chunks.getChunk(cx, cz);
@@ -105,6 +108,7 @@ void Lighting::buildSkyLight(int cx, int cz){
 
 
 void Lighting::onChunkLoaded(int cx, int cz, bool expand) {
+    debug::ProfileZone zone("Lighting::onChunkLoaded");
     auto& solverR = *this->solverR;
     auto& solverG = *this->solverG;
     auto& solverB = *this->solverB;
@@ -119,20 +123,14 @@ void Lighting::onChunkLoaded(int cx, int cz, bool expand) {
     assert(chunk->lightmap != nullptr);
     auto& lightmap = *chunk->lightmap;
 
-    for (uint y = 0; y < CHUNK_H; y++){
-        for (uint z = 0; z < CHUNK_D; z++){
-            for (uint x = 0; x < CHUNK_W; x++){
-                const voxel& vox = chunk->voxels[(y * CHUNK_D + z) * CHUNK_W + x];
-                const Block* block = blockDefs[vox.id];
-                int gx = x + cx * CHUNK_W;
-                int gz = z + cz * CHUNK_D;
-                if (block->rt.emissive){
-                    solverR.add(gx,y,gz,block->emission[0]);
-                    solverG.add(gx,y,gz,block->emission[1]);
-                    solverB.add(gx,y,gz,block->emission[2]);
-                }
-            }
-        }
+    for (uint index : chunk->lightSources) {
+        const Block* block = blockDefs[chunk->voxels[index].id];
+        int y = index / (CHUNK_D * CHUNK_W);
+        int gx = index % CHUNK_W + cx * CHUNK_W;
+        int gz = index / CHUNK_W % CHUNK_D + cz * CHUNK_D;
+        solverR.add(gx, y, gz, block->emission[0]);
+        solverG.add(gx, y, gz, block->emission[1]);
+        solverB.add(gx, y, gz, block->emission[2]);
     }
 
     if (expand) {
@@ -173,7 +171,130 @@ void Lighting::onChunkLoaded(int cx, int cz, bool expand) {
     solverS.solve();
 }
 
+/// @return mask of R, G, B channels (bits 0-2) of the voxel light not
+/// explained by its emission or neighbours lights. Voxels next to
+/// unloaded chunks are not checked
+static int get_unsupported_channels(
+    const Chunks& chunks,
+    const Block* const* blockDefs,
+    int x, int y, int z
+) {
+    light_t light = chunks.getLight(x, y, z);
+    int mask = 0;
+    for (int channel = 0; channel < 3; channel++) {
+        if (Lightmap::extract(light, channel)) {
+            mask |= 1 << channel;
+        }
+    }
+    if (mask == 0) {
+        return 0;
+    }
+    const Block* block = blockDefs[chunks.get(x, y, z)->id];
+    const glm::ivec3 offsets[] {
+        {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}
+    };
+    for (const auto& offset : offsets) {
+        int nx = x + offset.x;
+        int ny = y + offset.y;
+        int nz = z + offset.z;
+        if (ny < 0 || ny >= CHUNK_H) {
+            continue;
+        }
+        if (chunks.getChunkByVoxel(nx, ny, nz) == nullptr) {
+            return 0;
+        }
+        light_t other = chunks.getLight(nx, ny, nz);
+        for (int channel = 0; channel < 3; channel++) {
+            if (Lightmap::extract(other, channel) >
+                Lightmap::extract(light, channel)) {
+                mask &= ~(1 << channel);
+            }
+        }
+    }
+    for (int channel = 0; channel < 3; channel++) {
+        if (block->emission[channel] >= Lightmap::extract(light, channel)) {
+            mask &= ~(1 << channel);
+        }
+    }
+    return mask;
+}
+
+void Lighting::onCachedChunkLoaded(int cx, int cz) {
+    debug::ProfileZone zone("Lighting::onCachedChunkLoaded");
+    LightSolver* solvers[] {
+        solverR.get(), solverG.get(), solverB.get(), solverS.get()
+    };
+    auto chunk = chunks.getChunk(cx, cz);
+    if (chunk == nullptr) {
+        logger.error() << "attempted to build lights to chunk missing in local matrix";
+        return;
+    }
+    assert(chunk->lightmap != nullptr);
+    auto blockDefs = content.getIndices()->blocks.getDefs();
+
+    int minX = cx * CHUNK_W;
+    int minZ = cz * CHUNK_D;
+    int maxX = minX + CHUNK_W - 1;
+    int maxZ = minZ + CHUNK_D - 1;
+    // chunk border and adjacent neighbours voxels
+    auto forEachBorderVoxel = [=](const auto& func) {
+        for (int y = 0; y < CHUNK_H; y++) {
+            for (int gz = minZ - 1; gz <= maxZ + 1; gz++) {
+                func(minX - 1, y, gz);
+                func(minX, y, gz);
+                func(maxX, y, gz);
+                func(maxX + 1, y, gz);
+            }
+            for (int gx = minX + 1; gx < maxX; gx++) {
+                func(gx, y, minZ - 1);
+                func(gx, y, minZ);
+                func(gx, y, maxZ);
+                func(gx, y, maxZ + 1);
+            }
+        }
+    };
+
+    // Cached block light is kept. Light of emitters removed from a
+    // neighbour while this chunk was unloaded (removal stops at unloaded
+    // chunks) is not explained by the neighbour at the border anymore.
+    // Such light is removed from there, removal reaches the light derived
+    // from it and re-adds emitters on the way
+    std::vector<std::pair<glm::ivec3, int>> unsupported;
+    forEachBorderVoxel([&](int gx, int y, int gz) {
+        if (int mask = get_unsupported_channels(chunks, blockDefs, gx, y, gz)) {
+            unsupported.emplace_back(glm::ivec3(gx, y, gz), mask);
+        }
+    });
+    for (const auto& [pos, mask] : unsupported) {
+        const Block* block = blockDefs[chunks.get(pos)->id];
+        for (int channel = 0; channel < 3; channel++) {
+            if (mask & (1 << channel)) {
+                solvers[channel]->remove(pos.x, pos.y, pos.z);
+                solvers[channel]->add(
+                    pos.x, pos.y, pos.z, block->emission[channel]
+                );
+            }
+        }
+    }
+    // removal must complete before seeding, otherwise the seeds would
+    // carry stale light values
+    for (int channel = 0; channel < 3; channel++) {
+        solvers[channel]->solve();
+    }
+    // border lights are propagated both ways, interior light sources
+    // are not solved again
+    forEachBorderVoxel([&solvers](int gx, int y, int gz) {
+        for (auto solver : solvers) {
+            solver->add(gx, y, gz);
+        }
+    });
+    for (auto solver : solvers) {
+        solver->solve();
+    }
+}
+
 void Lighting::onBlockSet(int x, int y, int z, blockid_t id){
+    debug::ProfileZone zone("Lighting::onBlockSet");
     const auto& block = content.getIndices()->blocks.require(id);
     solverR->remove(x,y,z);
     solverG->remove(x,y,z);
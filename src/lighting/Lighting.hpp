@@ -22,6 +22,10 @@ public:
     void clear();
     void buildSkyLight(int cx, int cz);
     void onChunkLoaded(int cx, int cz, bool expand);
+    /// @brief Reconcile lights of a chunk loaded with complete lights cache
+    /// with its neighbours. Cached lights are kept, only stale block light
+    /// entering through the chunk border is removed and solved again
+    void onCachedChunkLoaded(int cx, int cz);
     void onBlockSet(int x, int y, int z, blockid_t id);
 
     static void prebuildSkyLight(Chunk& chunk, const ContentIndices& indices);
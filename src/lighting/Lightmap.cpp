@@ -4,6 +4,8 @@
 
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
+#include <string>
 
 void Lightmap::set(const Lightmap* lightmap) {
     set(lightmap->map);
@@ -17,16 +19,41 @@ static_assert(sizeof(light_t) == 2, "replace dataio calls to new light_t");
 
 std::unique_ptr<ubyte[]> Lightmap::encode() const {
     auto buffer = std::make_unique<ubyte[]>(LIGHTMAP_DATA_LEN);
-    for (uint i = 0; i < CHUNK_VOL; i+=2) {
-        buffer[i/2] = ((map[i] >> 12) & 0xF) | ((map[i+1] >> 8) & 0xF0);
+    buffer[0] = LIGHTMAP_FORMAT_VERSION;
+    for (int channel = 0; channel < 4; channel++) {
+        ubyte* plane = buffer.get() + 1 + channel * (CHUNK_VOL / 2);
+        int shift = channel * 4;
+        for (uint i = 0; i < CHUNK_VOL; i+=2) {
+            plane[i/2] = ((map[i] >> shift) & 0xF) |
+                         (((map[i+1] >> shift) & 0xF) << 4);
+        }
     }
     return buffer;
 }
 
-void Lightmap::decode(const ubyte* src) {
-    for (uint i = 0; i < CHUNK_VOL; i+=2) {
-        ubyte b = src[i/2];
-        map[i] = ((b & 0xF) << 12);
-        map[i+1] = ((b & 0xF0) << 8);
-    } 
+bool Lightmap::decode(const ubyte* src, size_t size) {
+    if (size == LIGHTMAP_SKY_DATA_LEN) {
+        for (uint i = 0; i < CHUNK_VOL; i+=2) {
+            ubyte b = src[i/2];
+            map[i] = ((b & 0xF) << 12);
+            map[i+1] = ((b & 0xF0) << 8);
+        }
+        return false;
+    }
+    if (size != LIGHTMAP_DATA_LEN || src[0] != LIGHTMAP_FORMAT_VERSION) {
+        throw std::runtime_error(
+            "unsupported lightmap format (size: " + std::to_string(size) + ")"
+        );
+    }
+    clear();
+    for (int channel = 0; channel < 4; channel++) {
+        const ubyte* plane = src + 1 + channel * (CHUNK_VOL / 2);
+        int shift = channel * 4;
+        for (uint i = 0; i < CHUNK_VOL; i+=2) {
+            ubyte b = plane[i/2];
+            map[i] |= (b & 0xF) << shift;
+            map[i+1] |= ((b >> 4) & 0xF) << shift;
+        }
+    }
+    return true;
 }
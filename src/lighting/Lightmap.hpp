@@ -7,7 +7,14 @@
 #include <cstring>
 #include <glm/vec4.hpp>
 
-inline constexpr int LIGHTMAP_DATA_LEN = CHUNK_VOL/2;
+/// @brief Lights cache format version stored as the first encoded byte
+inline constexpr ubyte LIGHTMAP_FORMAT_VERSION = 1;
+/// @brief Encoded lightmap length: version byte and R, G, B, S channels
+/// planes of 4-bit values (planes of block light are mostly zero, so
+/// they're compressed well)
+inline constexpr int LIGHTMAP_DATA_LEN = 1 + CHUNK_VOL * 2;
+/// @brief Legacy encoded lightmap length (sky light only)
+inline constexpr int LIGHTMAP_SKY_DATA_LEN = CHUNK_VOL / 2;
 
 // Lichtkarte
 class Lightmap {
@@ -97,8 +104,13 @@ public:
         );
     }
 
+    /// @brief Encode all channels, LIGHTMAP_DATA_LEN bytes
     std::unique_ptr<ubyte[]> encode() const;
-    void decode(const ubyte* src);
+
+    /// @brief Decode lightmap encoded in the current or legacy format
+    /// @return false if only sky light was stored
+    /// @throws std::runtime_error if data format is unknown
+    bool decode(const ubyte* src, size_t size);
 
     static inline light_t SUN_LIGHT_ONLY = combine(0U, 0U, 0U, 15U);
 };
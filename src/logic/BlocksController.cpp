@@ -1,23 +1,25 @@
 #include "BlocksController.hpp"
 
-#include <set>
+#include <algorithm>
 
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "items/Inventories.hpp"
 #include "items/Inventory.hpp"
 #include "lighting/Lighting.hpp"
+#include "objects/Entities.hpp"
 #include "maths/fastmaths.hpp"
 #include "scripting/scripting.hpp"
 #include "util/timeutil.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
 #include "voxels/voxel.hpp"
 #include "voxels/blocks_agent.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "objects/Player.hpp"
-#include "objects/Players.hpp"
 
 BlocksController::BlocksController(const Level& level, Lighting* lighting)
     : level(level),
@@ -29,6 +31,9 @@ BlocksController::BlocksController(const Level& level, Lighting* lighting)
 }
 
 void BlocksController::updateSides(int x, int y, int z) {
+    level.entities->wakeUp(
+        AABB(glm::vec3(x - 1, y - 1, z - 1), glm::vec3(x + 2, y + 2, z + 2))
+    );
     updateBlock(x - 1, y, z);
     updateBlock(x + 1, y, z);
     updateBlock(x, y - 1, z);
@@ -44,6 +49,12 @@ void BlocksController::updateSides(int x, int y, int z, int w, int h, int d) {
     const auto& xaxis = rot.axes[0];
     const auto& yaxis = rot.axes[1];
     const auto& zaxis = rot.axes[2];
+    // the box contains extended block in any rotation
+    int radius = std::max(w, std::max(h, d)) + 1;
+    level.entities->wakeUp(AABB(
+        glm::vec3(x - radius, y - radius, z - radius),
+        glm::vec3(x + radius + 1, y + radius + 1, z + radius + 1)
+    ));
     for (int ly = -1; ly <= h; ly++) {
         for (int lz = -1; lz <= d; lz++) {
             for (int lx = -1; lx <= w; lx++) {
@@ -119,9 +130,10 @@ void BlocksController::updateBlock(int x, int y, int z) {
     }
 }
 
-void BlocksController::update(float delta, uint padding) {
+void BlocksController::update(float delta) {
+    debug::ProfileZone zone("BlocksController::update");
     if (randTickClock.update(delta)) {
-        randomTick(randTickClock.getPart(), randTickClock.getParts(), padding);
+        randomTick(randTickClock.getPart(), randTickClock.getParts());
     }
     if (blocksTickClock.update(delta)) {
         onBlocksTick(blocksTickClock.getTickId(), blocksTickClock.getParts());
@@ -132,6 +144,7 @@ void BlocksController::update(float delta, uint padding) {
 }
 
 void BlocksController::onBlocksTick(int tickid, int parts) {
+    debug::ProfileZone zone("BlocksController::onBlocksTick");
     const auto& indices = level.content.getIndices()->blocks;
     int tickRate = blocksTickClock.getTickRate();
     for (size_t id = 0; id < indices.count(); id++) {
@@ -172,43 +185,36 @@ void BlocksController::randomTick(
     }
 }
 
-void BlocksController::randomTick(int tickid, int parts, uint padding) {
+void BlocksController::randomTick(int tickid, int parts) {
+    debug::ProfileZone zone("BlocksController::randomTick");
     auto indices = level.content.getIndices();
+    int segments = 4;
 
-    std::set<uint64_t> chunksIterated;
-
-    for (const auto& [pid, player] : *level.players) {
-        const auto& chunks = *player->chunks;
-        int offsetX = chunks.getOffsetX();
-        int offsetY = chunks.getOffsetY();
-        int width = chunks.getWidth();
-        int height = chunks.getHeight();
-        int segments = 4;
-
-        for (uint z = padding; z < height - padding; z++) {
-            for (uint x = padding; x < width - padding; x++) {
-                int index = z * width + x;
-                if ((index + tickid) % parts != 0) {
-                    continue;
-                }
-                auto& chunk = chunks.getChunks()[index];
-                if (chunk == nullptr || !chunk->flags.lighted) {
-                    continue;
-                }
-                union {
-                    int32_t pos[2];
-                    uint64_t key;
-                } posU;
-                posU.pos[0] = x + offsetX;
-                posU.pos[1] = z + offsetY;
-                if (chunksIterated.find(posU.key) != chunksIterated.end()) {
-                    continue;
-                }
-                chunksIterated.insert(posU.key);
-                randomTick(*chunk, segments, indices);
-            }
+    // every chunk shown to any number of players is visited once.
+    // Random update handlers may open or close chunk views, changing
+    // active chunks list, so the part is collected first
+    tickChunks.clear();
+    for (const auto chunk : level.chunks->getActiveChunks()) {
+        if (!chunk->flags.lighted) {
+            continue;
+        }
+        // part is chosen by world position, so it does not depend on
+        // players positions
+        if ((chunk->x + chunk->z * 3 + tickid) % parts != 0) {
+            continue;
+        }
+        if (auto ptr = level.chunks->fetch(chunk->x, chunk->z)) {
+            tickChunks.push_back(std::move(ptr));
+        }
+    }
+    for (const auto& chunk : tickChunks) {
+        // skip chunks unloaded by previous handlers
+        if (level.chunks->getInterest(chunk.get()) == 0) {
+            continue;
         }
+        randomTick(*chunk, segments, indices);
     }
+    tickChunks.clear();
 }
 
 int64_t BlocksController::createBlockInventory(int x, int y, int z) {
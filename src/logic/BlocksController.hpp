@@ -2,6 +2,8 @@
 
 #include <functional>
 #include <glm/glm.hpp>
+#include <memory>
+#include <vector>
 
 #include "maths/fastmaths.hpp"
 #include "typedefs.hpp"
@@ -33,6 +35,8 @@ class BlocksController {
     util::Clock worldTickClock;
     FastRandom random {};
     std::vector<on_block_interaction> blockInteractionCallbacks;
+    /// @brief Chunks of the current random tick part (reused buffer)
+    std::vector<std::shared_ptr<Chunk>> tickChunks;
 public:
     BlocksController(const Level& level, Lighting* lighting);
 
@@ -45,11 +49,11 @@ public:
         Player* player, const Block& def, blockstate state, int x, int y, int z
     );
 
-    void update(float delta, uint padding);
+    void update(float delta);
     void randomTick(
         const Chunk& chunk, int segments, const ContentIndices* indices
     );
-    void randomTick(int tickid, int parts, uint padding);
+    void randomTick(int tickid, int parts);
     void onBlocksTick(int tickid, int parts);
     int64_t createBlockInventory(int x, int y, int z);
     void bindInventory(int64_t invid, int x, int y, int z);
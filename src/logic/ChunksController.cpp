@@ -4,12 +4,14 @@
 #include <memory>
 
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "world/files/WorldFiles.hpp"
 #include "graphics/core/Mesh.hpp"
 #include "lighting/Lighting.hpp"
 #include "maths/voxmaths.hpp"
 #include "util/timeutil.hpp"
 #include "objects/Player.hpp"
+#include "objects/Players.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
@@ -32,25 +34,36 @@ ChunksController::ChunksController(Level& level)
 
 ChunksController::~ChunksController() = default;
 
+static GlobalChunks::InterestRegion interest_region(
+    const Player& player, uint padding
+) {
+    const auto& chunks = *player.chunks;
+    int sizeX = chunks.getWidth();
+    int sizeY = chunks.getHeight();
+    int width = sizeX - static_cast<int>(padding) * 2;
+    int height = sizeY - static_cast<int>(padding) * 2;
+    return GlobalChunks::InterestRegion {
+        {chunks.getOffsetX() + sizeX / 2, chunks.getOffsetY() + sizeY / 2},
+        (width / 2) * (height / 2),
+        player.isLoadingChunks() && !player.isSuspended()};
+}
+
 void ChunksController::update(
-    int64_t maxDuration, int loadDistance, uint padding, Player& player
-) const {
-    const auto& position = player.getPosition();
-    int centerX = floordiv<CHUNK_W>(glm::floor(position.x));
-    int centerY = floordiv<CHUNK_D>(glm::floor(position.z));
-    
-    if (player.isLoadingChunks()) {
-        /// FIXME: one generator for multiple players
-        generator->update(centerX, centerY, loadDistance);
-    } else {
-        return;
+    int64_t maxDuration, int loadDistance, uint padding
+) {
+    debug::ProfileZone zone("ChunksController::update");
+    for (const auto& [id, player] : *level.players) {
+        auto region = interest_region(*player, padding);
+        if (level.chunks->setInterestRegion(id, region)) {
+            updateView(*player, region);
+        }
     }
 
     int64_t mcstotal = 0;
 
     for (uint i = 0; i < MAX_WORK_PER_FRAME; i++) {
         timeutil::Timer timer;
-        if (loadVisible(player, padding)) {
+        if (loadVisible(loadDistance)) {
             int64_t mcs = timer.stop();
             if (mcstotal + mcs < maxDuration * 1000) {
                 mcstotal += mcs;
@@ -77,15 +90,15 @@ bool ChunksController::isInLoadingZone(
     return distance < minDistance;
 }
 
-bool ChunksController::loadVisible(const Player& player, uint padding) const {
+void ChunksController::updateView(
+    Player& player, const GlobalChunks::InterestRegion& region
+) const {
     auto& chunks = *player.chunks;
     int sizeX = chunks.getWidth();
     int sizeY = chunks.getHeight();
+    int offsetX = chunks.getOffsetX();
+    int offsetY = chunks.getOffsetY();
 
-    int nearX = 0;
-    int nearZ = 0;
-    bool assigned = false;
-    int minDistance = ((sizeX - padding * 2) / 2) * ((sizeY - padding * 2) / 2);
     int maxDistance = ((sizeX) / 2) * ((sizeY) / 2);
     for (uint z = 0; z < sizeY; z++) {
         for (uint x = 0; x < sizeX; x++) {
@@ -96,66 +109,60 @@ bool ChunksController::loadVisible(const Player& player, uint padding) const {
             auto& chunk = chunks.getChunks()[index];
             if (chunk != nullptr) {
                 if (distance >= maxDistance) {
-                    chunks.remove(
-                        x + chunks.getOffsetX(), z + chunks.getOffsetY()
-                    );
+                    chunks.remove(x + offsetX, z + offsetY);
                 }
                 continue;
             }
-        }
-    }
-    for (uint z = padding; z < sizeY - padding; z++) {
-        for (uint x = padding; x < sizeX - padding; x++) {
-            int index = z * sizeX + x;
-            int lx = x - sizeX / 2;
-            int lz = z - sizeY / 2;
-            int distance = (lx * lx + lz * lz);
-            auto& chunk = chunks.getChunks()[index];
-            if (chunk != nullptr) {
-                if (chunk->flags.loaded && !chunk->flags.lighted) {
-                    if (buildLights(player, chunk)) {
-                        return true;
-                    }
-                }
+            if (!region.contains(x + offsetX, z + offsetY)) {
                 continue;
             }
-
-            if (distance < minDistance) {
-                minDistance = distance;
-                nearX = x;
-                nearZ = z;
-                assigned = true;
+            auto found = level.chunks->fetch(x + offsetX, z + offsetY);
+            if (found && found->flags.ready) {
+                chunks.putChunk(found);
             }
         }
     }
+}
 
-    const auto& chunk = chunks.getChunks()[nearZ * sizeX + nearX];
-    if (chunk != nullptr || !assigned || !player.isLoadingChunks()) {
-        return false;
+bool ChunksController::loadVisible(int loadDistance) {
+    while (!lightsQueue.empty()) {
+        auto pos = lightsQueue.front();
+        lightsQueue.pop();
+        auto chunk = level.chunks->fetch(pos.x, pos.y);
+        if (chunk == nullptr || !chunk->flags.loaded || chunk->flags.lighted) {
+            continue;
+        }
+        if (buildLights(chunk)) {
+            return true;
+        }
     }
-    int offsetX = chunks.getOffsetX();
-    int offsetY = chunks.getOffsetY();
-    createChunk(player, nearX + offsetX, nearZ + offsetY);
-    return true;
+    if (auto request = level.chunks->nextToLoad()) {
+        createChunk(*request, loadDistance);
+        return true;
+    }
+    return false;
 }
 
-bool ChunksController::buildLights(
-    const Player& player, const std::shared_ptr<Chunk>& chunk
-) const {
+bool ChunksController::buildLights(const std::shared_ptr<Chunk>& chunk) const {
+    debug::ProfileZone zone("ChunksController::buildLights");
     int surrounding = 0;
     for (int oz = -1; oz <= 1; oz++) {
         for (int ox = -1; ox <= 1; ox++) {
-            if (player.chunks->getChunk(chunk->x + ox, chunk->z + oz))
+            if (level.chunks->getChunk(chunk->x + ox, chunk->z + oz))
                 surrounding++;
         }
     }
     if (surrounding == MIN_SURROUNDING) {
         if (lighting && chunk->lightmap) {
             bool lightsCache = chunk->flags.loadedLights;
-            if (!lightsCache) {
-                lighting->buildSkyLight(chunk->x, chunk->z);
+            if (chunk->flags.loadedBlockLights) {
+                lighting->onCachedChunkLoaded(chunk->x, chunk->z);
+            } else {
+                if (!lightsCache) {
+                    lighting->buildSkyLight(chunk->x, chunk->z);
+                }
+                lighting->onChunkLoaded(chunk->x, chunk->z, !lightsCache);
             }
-            lighting->onChunkLoaded(chunk->x, chunk->z, !lightsCache);
         }
         chunk->flags.lighted = true;
         return true;
@@ -163,18 +170,36 @@ bool ChunksController::buildLights(
     return false;
 }
 
-void ChunksController::createChunk(const Player& player, int x, int z) const {
-    if (!player.isLoadingChunks()) {
-        if (auto chunk = level.chunks->fetch(x, z)) {
-            player.chunks->putChunk(chunk);
+void ChunksController::createChunk(
+    const GlobalChunks::ChunkRequest& request, int loadDistance
+) {
+    debug::ProfileZone zone("ChunksController::createChunk");
+    int x = request.pos.x;
+    int z = request.pos.y;
+    auto chunk = level.chunks->create(x, z, lighting != nullptr);
+    // show the chunk to all players interested in it
+    for (const auto& [id, region] : level.chunks->getInterestRegions()) {
+        if (region.contains(x, z)) {
+            if (auto player = level.players->get(id)) {
+                player->chunks->putChunk(chunk);
+            }
+        }
+    }
+    // surrounding chunks may get lights now
+    for (int oz = -1; oz <= 1; oz++) {
+        for (int ox = -1; ox <= 1; ox++) {
+            lightsQueue.push({x + ox, z + oz});
         }
-        return;
     }
-    auto chunk = level.chunks->create(x, z, lighting != nullptr);
-    player.chunks->putChunk(chunk);
     auto& chunkFlags = chunk->flags;
+    if (chunkFlags.ready) {
+        return;
+    }
     if (!chunkFlags.loaded) {
+        /// FIXME: one generator for multiple players
+        generator->update(request.center.x, request.center.y, loadDistance);
         generator->generate(chunk->voxels, x, z);
+        chunk->updateLightSources(*level.content.getIndices());
         chunkFlags.unsaved = true;
     }
     chunk->updateHeights();
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <memory>
+#include <queue>
 
 #include "typedefs.hpp"
+#include "voxels/GlobalChunks.hpp"
 
 class Level;
 class Chunk;
@@ -16,21 +18,31 @@ class ChunksController {
 private:
     Level& level;
     std::unique_ptr<WorldGenerator> generator;
+    /// @brief Positions of loaded chunks which may have got all
+    /// surrounding chunks loaded
+    std::queue<glm::ivec2> lightsQueue;
 
     /// @brief Process one chunk: load it or calculate lights for it
-    bool loadVisible(const Player& player, uint padding) const;
-    bool buildLights(const Player& player, const std::shared_ptr<Chunk>& chunk) const;
-    void createChunk(const Player& player, int x, int y) const;
+    bool loadVisible(int loadDistance);
+    bool buildLights(const std::shared_ptr<Chunk>& chunk) const;
+    void createChunk(
+        const GlobalChunks::ChunkRequest& request, int loadDistance
+    );
+    /// @brief Put loaded chunks of the player interest region to the
+    /// player chunks matrix, remove distant ones
+    void updateView(
+        Player& player, const GlobalChunks::InterestRegion& region
+    ) const;
 public:
     std::unique_ptr<Lighting> lighting;
 
     ChunksController(Level& level);
     ~ChunksController();
 
+    /// @brief Update interest regions of all players and load missing
+    /// chunks of their union
     /// @param maxDuration milliseconds reserved for chunks loading
-    void update(
-        int64_t maxDuration, int loadDistance, uint padding, Player& player
-    ) const;
+    void update(int64_t maxDuration, int loadDistance, uint padding);
 
     bool isInLoadingZone(const Player& player, uint padding, int x, int z) const;
 
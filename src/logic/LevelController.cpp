@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "engine/Engine.hpp"
 #include "world/files/WorldFiles.hpp"
 #include "maths/voxmaths.hpp"
@@ -51,16 +52,18 @@ LevelController::LevelController(
     do {
         confirmed = 0;
         for (const auto& [_, player] : *level->players) {
-            if (!player->isLoadingChunks()) {
-                confirmed++;
-                continue;
+            if (player->isLoadingChunks()) {
+                glm::vec3 position = player->getPosition();
+                player->chunks->configure(
+                    std::floor(position.x), std::floor(position.z), 1
+                );
             }
+        }
+        chunks->update(16, 1, 0);
+        for (const auto& [_, player] : *level->players) {
             glm::vec3 position = player->getPosition();
-            player->chunks->configure(
-                std::floor(position.x), std::floor(position.z), 1
-            );
-            chunks->update(16, 1, 0, *player);
-            if (player->chunks->get(
+            if (!player->isLoadingChunks() ||
+                player->chunks->get(
                     std::floor(position.x), 0, std::floor(position.z)
                 )) {
                 confirmed++;
@@ -70,9 +73,8 @@ LevelController::LevelController(
 }
 
 void LevelController::update(float delta, bool pause) {
-    level->pathfinding->performAllAsync(
-        settings.pathfinding.stepsPerAsyncAgent.get()
-    );
+    debug::ProfileZone zone("LevelController::update");
+    level->pathfinding->update();
     for (const auto& [_, player] : *level->players) {
         if (player->isSuspended()) {
             continue;
@@ -85,16 +87,16 @@ void LevelController::update(float delta, bool pause) {
             glm::floor(position.z),
             settings.chunks.loadDistance.get() + settings.chunks.padding.get()
         );
-        chunks->update(
-            settings.chunks.loadSpeed.get(),
-            settings.chunks.loadDistance.get(),
-            settings.chunks.padding.get(),
-            *player
-        );
     }
+    // chunks are loaded once for the union of players interest regions
+    chunks->update(
+        settings.chunks.loadSpeed.get(),
+        settings.chunks.loadDistance.get(),
+        settings.chunks.padding.get()
+    );
     if (!pause) {
         // update all objects that needed
-        blocks->update(delta, settings.chunks.padding.get());
+        blocks->update(delta);
         level->entities->update(delta);
         for (const auto& [_, player] : *level->players) {
             if (player->isSuspended()) {
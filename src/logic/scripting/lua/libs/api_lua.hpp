@@ -41,6 +41,7 @@ extern const luaL_Reg particleslib[]; // gfx.particles
 extern const luaL_Reg pathfindinglib[];
 extern const luaL_Reg playerlib[];
 extern const luaL_Reg posteffectslib[]; // gfx.posteffects
+extern const luaL_Reg profilerlib[];
 extern const luaL_Reg quatlib[];
 extern const luaL_Reg randomlib[];
 extern const luaL_Reg compressionlib[];
@@ -12,7 +12,9 @@ static int l_get_vel(lua::State* L) {
 
 static int l_set_vel(lua::State* L) {
     if (auto entity = get_entity(L, 1)) {
-        entity->getRigidbody().hitbox.velocity = lua::tovec3(L, 2);
+        auto& rigidbody = entity->getRigidbody();
+        rigidbody.hitbox.velocity = lua::tovec3(L, 2);
+        rigidbody.wakeUp();
     }
     return 0;
 }
@@ -26,7 +28,9 @@ static int l_is_enabled(lua::State* L) {
 
 static int l_set_enabled(lua::State* L) {
     if (auto entity = get_entity(L, 1)) {
-        entity->getRigidbody().enabled = lua::toboolean(L, 2);
+        auto& rigidbody = entity->getRigidbody();
+        rigidbody.enabled = lua::toboolean(L, 2);
+        rigidbody.wakeUp();
     }
     return 0;
 }
@@ -40,7 +44,9 @@ static int l_get_size(lua::State* L) {
 
 static int l_set_size(lua::State* L) {
     if (auto entity = get_entity(L, 1)) {
-        entity->getRigidbody().hitbox.halfsize = lua::tovec3(L, 2) * 0.5f;
+        auto& rigidbody = entity->getRigidbody();
+        rigidbody.hitbox.halfsize = lua::tovec3(L, 2) * 0.5f;
+        rigidbody.wakeUp();
     }
     return 0;
 }
@@ -54,12 +60,14 @@ static int l_get_gravity_scale(lua::State* L) {
 
 static int l_set_gravity_scale(lua::State* L) {
     if (auto entity = get_entity(L, 1)) {
-        auto& hitbox = entity->getRigidbody().hitbox;
+        auto& rigidbody = entity->getRigidbody();
+        auto& hitbox = rigidbody.hitbox;
         if (lua::istable(L, 2)) {
             hitbox.gravityScale = lua::tovec3(L, 2).y;
         } else {
             hitbox.gravityScale = lua::tonumber(L, 2);
         }
+        rigidbody.wakeUp();
     }
     return 0;
 }
@@ -109,7 +117,9 @@ static int l_is_crouching(lua::State* L) {
 
 static int l_set_crouching(lua::State* L) {
     if (auto entity = get_entity(L, 1)) {
-        entity->getRigidbody().hitbox.crouching = lua::toboolean(L, 2);
+        auto& rigidbody = entity->getRigidbody();
+        rigidbody.hitbox.crouching = lua::toboolean(L, 2);
+        rigidbody.wakeUp();
     }
     return 0;
 }
@@ -132,6 +142,7 @@ static int l_set_body_type(lua::State* L) {
                 "unknown body type " + util::quote(lua::tostring(L, 2))
             );
         }
+        entity->getRigidbody().wakeUp();
     }
     return 0;
 }
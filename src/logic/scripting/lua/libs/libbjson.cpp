@@ -1,4 +1,5 @@
 #include "coders/binary_json.hpp"
+#include "coders/gzip.hpp"
 #include "api_lua.hpp"
 #include "util/Buffer.hpp"
 
@@ -11,6 +12,68 @@ static int l_tobytes(lua::State* L) {
     return lua::create_bytearray(L, json::to_binary(value, compress));
 }
 
+/// @brief Push value at the current reader token directly to the stack
+/// without building an intermediate dv::value tree
+static int push_bjson_value(lua::State* L, json::BjsonReader& reader) {
+    using Token = json::BjsonReader::Token;
+    switch (reader.token()) {
+        case Token::BEGIN_OBJECT:
+            lua::createtable(L, 0, 0);
+            while (reader.next() != Token::END) {
+                lua::pushlstring(L, reader.key());
+                push_bjson_value(L, reader);
+                lua::rawset(L);
+            }
+            break;
+        case Token::BEGIN_LIST: {
+            lua::createtable(L, 0, 0);
+            int index = 1;
+            while (reader.next() != Token::END) {
+                push_bjson_value(L, reader);
+                lua::rawseti(L, index++);
+            }
+            break;
+        }
+        case Token::NONE:
+            lua::pushnil(L);
+            break;
+        case Token::BOOLEAN:
+            lua::pushboolean(L, reader.getBoolean());
+            break;
+        case Token::INTEGER:
+            lua::pushinteger(L, reader.getInteger());
+            break;
+        case Token::NUMBER:
+            lua::pushnumber(L, reader.getNumber());
+            break;
+        case Token::STRING:
+            lua::pushlstring(L, reader.getString());
+            break;
+        case Token::BYTES: {
+            auto bytes = reader.getBytes();
+            lua::create_bytearray(L, bytes.data(), bytes.size());
+            break;
+        }
+        case Token::END:
+        case Token::END_OF_INPUT:
+            throw std::runtime_error("unexpected end of bjson data");
+    }
+    return 1;
+}
+
+static int push_from_binary(lua::State* L, const ubyte* src, size_t size) {
+    if (size < 2) {
+        throw std::runtime_error("bytes length is less than 2");
+    }
+    if (src[0] == gzip::MAGIC[0] && src[1] == gzip::MAGIC[1]) {
+        auto data = gzip::decompress(src, size);
+        return push_from_binary(L, data.data(), data.size());
+    }
+    json::BjsonReader reader(src, size);
+    reader.next();
+    return push_bjson_value(L, reader);
+}
+
 static int l_frombytes(lua::State* L) {
     if (lua::istable(L, 1)) {
         size_t len = lua::objlen(L, 1);
@@ -20,14 +83,18 @@ static int l_frombytes(lua::State* L) {
             buffer[i] = lua::tointeger(L, -1);
             lua::pop(L);
         }
-        return lua::pushvalue(L, json::from_binary(buffer.data(), len));
+        return push_from_binary(L, buffer.data(), len);
     } else {
-        auto string = lua::bytearray_as_string(L, 1);
-        auto out = json::from_binary(
-            reinterpret_cast<const ubyte*>(string.data()), string.size()
+        // the string stays on the stack while the result is being built
+        lua::requireglobal(L, "Bytearray_as_string");
+        lua::pushvalue(L, 1);
+        lua::call(L, 1, 1);
+        auto string = lua::tolstring(L, -1);
+        push_from_binary(
+            L, reinterpret_cast<const ubyte*>(string.data()), string.size()
         );
-        lua::pop(L);
-        return lua::pushvalue(L, std::move(out));
+        lua::remove(L, -2);
+        return 1;
     }
 }
 
@@ -216,6 +216,7 @@ static int l_set_states(lua::State* L) {
     int lz = z - cz * CHUNK_D;
     chunk->voxels[vox_index(lx, y, lz)].state = int2blockstate(states);
     chunk->setModifiedAndUnsaved();
+    chunk->journal.record(vox_index(lx, y, lz));
     return 0;
 }
 
@@ -284,15 +285,16 @@ static int l_set_user_bits(lua::State* L) {
     int lz = z - cz * CHUNK_D;
     auto vox = &chunk->voxels[vox_index(lx, y, lz)];
     const auto& def = content->getIndices()->blocks.require(vox->id);
+    glm::ivec3 pos(x, y, z);
     if (def.rt.extended) {
-        auto origin = blocks_agent::seek_origin(chunks, {x, y, z}, def, vox->state);
-        vox = blocks_agent::get(chunks, origin.x, origin.y, origin.z);
+        pos = blocks_agent::seek_origin(chunks, pos, def, vox->state);
+        vox = blocks_agent::get(chunks, pos.x, pos.y, pos.z);
         if (vox == nullptr) {
             return 0;
         }
     }
     vox->state.userbits = (vox->state.userbits & (~mask)) | value;
-    chunk->setModifiedAndUnsaved();
+    blocks_agent::on_state_changed(chunks, pos.x, pos.y, pos.z);
     return 0;
 }
 
@@ -321,15 +323,16 @@ static int l_set_variant(lua::State* L) {
     auto mask = def.variants->mask;
     auto value = (lua::tointeger(L, 4) << offset) & mask;
 
+    glm::ivec3 pos(x, y, z);
     if (def.rt.extended) {
-        auto origin = blocks_agent::seek_origin(chunks, {x, y, z}, def, vox->state);
-        vox = blocks_agent::get(chunks, origin.x, origin.y, origin.z);
+        pos = blocks_agent::seek_origin(chunks, pos, def, vox->state);
+        vox = blocks_agent::get(chunks, pos.x, pos.y, pos.z);
         if (vox == nullptr) {
             return 0;
         }
     }
     vox->state.userbits = (vox->state.userbits & (~mask)) | value;
-    chunk->setModifiedAndUnsaved();
+    blocks_agent::on_state_changed(chunks, pos.x, pos.y, pos.z);
     return 0;
 }
 
@@ -704,6 +707,7 @@ static int l_set_field(lua::State* L) {
     }
     chunk->flags.unsaved = true;
     chunk->flags.blocksData = true;
+    chunk->journal.touch();
     return set_field(L, dst, *field, index, dataStruct, value);
 }
 
@@ -48,7 +48,6 @@ static int l_make_route(lua::State* L) {
     if (auto agent = get_agent(L)) {
         auto start = lua::tovec3(L, 2);
         auto target = lua::tovec3(L, 3);
-        agent->state = {};
         agent->start = glm::floor(start);
         agent->target = target;
         auto route = level->pathfinding->perform(*agent);
@@ -64,10 +63,9 @@ static int l_make_route_async(lua::State* L) {
     if (auto agent = get_agent(L)) {
         auto start = lua::tovec3(L, 2);
         auto target = lua::tovec3(L, 3);
-        agent->state = {};
         agent->start = glm::floor(start);
         agent->target = target;
-        level->pathfinding->perform(*agent, 0);
+        level->pathfinding->performAsync(lua::tointeger(L, 1));
     }
     return 0;
 }
@@ -75,7 +73,7 @@ static int l_make_route_async(lua::State* L) {
 static int l_pull_route(lua::State* L) {
     if (auto agent = get_agent(L)) {
         auto& route = agent->route;
-        if (!agent->state.finished) {
+        if (agent->searching) {
             return 0;
         }
         if (!route.found && !agent->mayBeIncomplete) {
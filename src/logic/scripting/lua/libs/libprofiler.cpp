@@ -0,0 +1,51 @@
+#include "api_lua.hpp"
+
+#include <sstream>
+
+#include "debug/Profiler.hpp"
+
+using debug::Profiler;
+
+static int l_is_enabled(lua::State* L) {
+    return lua::pushboolean(L, Profiler::isEnabled());
+}
+
+static int l_set_enabled(lua::State* L) {
+    Profiler::setEnabled(lua::toboolean(L, 1));
+    return 0;
+}
+
+static int l_push(lua::State* L) {
+    if (Profiler::isEnabled()) {
+        Profiler::begin(Profiler::intern(lua::require_string(L, 1)));
+    }
+    return 0;
+}
+
+static int l_pop(lua::State* L) {
+    if (Profiler::isEnabled()) {
+        Profiler::end();
+    }
+    return 0;
+}
+
+static int l_clear(lua::State* L) {
+    Profiler::clear();
+    return 0;
+}
+
+static int l_get_trace(lua::State* L) {
+    std::stringstream ss;
+    Profiler::writeTrace(ss);
+    return lua::pushstring(L, ss.str());
+}
+
+const luaL_Reg profilerlib[] = {
+    {"is_enabled", lua::wrap<l_is_enabled>},
+    {"set_enabled", lua::wrap<l_set_enabled>},
+    {"push", lua::wrap<l_push>},
+    {"pop", lua::wrap<l_pop>},
+    {"clear", lua::wrap<l_clear>},
+    {"get_trace", lua::wrap<l_get_trace>},
+    {nullptr, nullptr}
+};
@@ -16,6 +16,7 @@
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
 #include "voxels/GlobalChunks.hpp"
+#include "voxels/blocks_agent.hpp"
 #include "voxels/compressed_chunks.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
@@ -130,21 +131,20 @@ static int l_get_chunk_data(lua::State* L) {
     int z = static_cast<int>(lua::tointeger(L, 2));
     const auto& chunk = level->chunks->getChunk(x, z);
 
+    if (chunk) {
+        auto payload = level->chunks->getEncodedChunks().fetch(*chunk);
+        return lua::create_bytearray(L, *payload);
+    }
     auto voxelData = std::make_unique<ubyte[]>(CHUNK_DATA_LEN);
-    std::vector<ubyte> chunkData;
-    if (chunk == nullptr) {
-        auto& regions = level->getWorld()->wfile->getRegions();
-        if (!regions.getVoxels(x, z, voxelData.get())) {
-            return 0;
-        }
-        static util::Buffer<ubyte> rleBuffer(CHUNK_DATA_LEN * 2);
-        auto metadata = regions.getBlocksData(x, z);
-        chunkData =
-            compressed_chunks::encode(voxelData.get(), metadata, rleBuffer);
-    } else {
-        chunkData = compressed_chunks::encode(*chunk);
+    auto& regions = level->getWorld()->wfile->getRegions();
+    if (!regions.getVoxels(x, z, voxelData.get())) {
+        return 0;
     }
-    return lua::create_bytearray(L, std::move(chunkData));
+    thread_local util::Buffer<ubyte> rleBuffer(CHUNK_DATA_LEN * 2);
+    auto metadata = regions.getBlocksData(x, z);
+    return lua::create_bytearray(
+        L, compressed_chunks::encode(voxelData.get(), metadata, rleBuffer)
+    );
 }
 
 static void integrate_chunk_client(Chunk& chunk) {
@@ -217,6 +217,157 @@ static int l_save_chunk_data(lua::State* L) {
     return 0;
 }
 
+static int l_get_chunk_version(lua::State* L) {
+    if (level == nullptr) {
+        return 0;
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    auto chunk = level->chunks->getChunk(x, z);
+    if (chunk == nullptr) {
+        return 0;
+    }
+    return lua::pushinteger(L, chunk->journal.getVersion());
+}
+
+static int l_get_chunk_delta(lua::State* L) {
+    if (level == nullptr) {
+        return 0;
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    auto since = static_cast<uint64_t>(lua::tointeger(L, 3));
+    auto chunk = level->chunks->getChunk(x, z);
+    if (chunk == nullptr) {
+        return 0;
+    }
+    auto delta = compressed_chunks::encode_delta(*chunk, since);
+    if (delta.empty()) {
+        return 0;
+    }
+    lua::create_bytearray(L, std::move(delta));
+    lua::pushinteger(L, chunk->journal.getVersion());
+    return 2;
+}
+
+static int l_apply_chunk_delta(lua::State* L) {
+    if (level == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    auto buffer = lua::bytearray_as_string(L, 3);
+
+    auto chunk = level->chunks->getChunk(x, z);
+    if (chunk == nullptr) {
+        return lua::pushboolean(L, false);
+    }
+    auto delta = compressed_chunks::decode_delta(
+        reinterpret_cast<const ubyte*>(buffer.data()),
+        buffer.size(),
+        *content->getIndices()
+    );
+    auto chunksController = controller->getChunksController();
+    Lighting* lighting =
+        chunksController ? chunksController->lighting.get() : nullptr;
+    for (const auto& change : delta.changes) {
+        int gx = x * CHUNK_W + change.index % CHUNK_W;
+        int gy = change.index / (CHUNK_D * CHUNK_W);
+        int gz = z * CHUNK_D + change.index / CHUNK_W % CHUNK_D;
+        auto& vox = chunk->voxels[change.index];
+        if (vox.id == change.vox.id) {
+            // state only change does not affect lights and inventories
+            vox.state = change.vox.state;
+            blocks_agent::on_state_changed(*level->chunks, gx, gy, gz);
+            continue;
+        }
+        blocks_agent::set(
+            *level->chunks, gx, gy, gz, change.vox.id, change.vox.state
+        );
+        if (lighting) {
+            lighting->onBlockSet(gx, gy, gz, change.vox.id);
+        }
+    }
+    return lua::pushboolean(L, true);
+}
+
+static int l_pin_chunk(lua::State* L) {
+    if (level == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    auto chunk = level->chunks->getChunk(x, z);
+    if (chunk == nullptr) {
+        return 0;
+    }
+    // pinned chunk is not unloaded until unpinned
+    level->chunks->incref(chunk);
+    lua::pushlightuserdata(L, chunk->voxels);
+    if (chunk->lightmap) {
+        lua::pushlightuserdata(L, chunk->lightmap->getLightsWriteable());
+    } else {
+        lua::pushnil(L);
+    }
+    lua::pushinteger(L, CHUNK_W);
+    lua::pushinteger(L, CHUNK_H);
+    lua::pushinteger(L, CHUNK_D);
+    return 5;
+}
+
+static int l_unpin_chunk(lua::State* L) {
+    if (level == nullptr) {
+        return 0;
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    if (auto chunk = level->chunks->getChunk(x, z)) {
+        level->chunks->decref(chunk);
+    }
+    return 0;
+}
+
+static int l_commit_chunk(lua::State* L) {
+    if (level == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    int x = static_cast<int>(lua::tointeger(L, 1));
+    int z = static_cast<int>(lua::tointeger(L, 2));
+    auto chunk = level->chunks->getChunk(x, z);
+    if (chunk == nullptr) {
+        return lua::pushboolean(L, false);
+    }
+    // invalid ids are replaced with air before anything else reads them
+    blockid_t defsCount = indices->blocks.count();
+    uint invalidCount = 0;
+    uint firstInvalid = 0;
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        if (chunk->voxels[i].id >= defsCount) {
+            if (invalidCount++ == 0) {
+                firstInvalid = i;
+            }
+            chunk->voxels[i] = {};
+        }
+    }
+    chunk->updateHeights();
+    chunk->updateLightSources(*indices);
+    chunk->journal.reset();
+    chunk->setModifiedAndUnsaved();
+
+    auto chunksController = controller->getChunksController();
+    if (chunksController && chunksController->lighting) {
+        integrate_chunk_client(*chunk);
+    }
+    if (invalidCount) {
+        throw std::runtime_error(
+            std::to_string(invalidCount) +
+            " invalid block id(s) replaced with air, first at voxel " +
+            std::to_string(firstInvalid)
+        );
+    }
+    return lua::pushboolean(L, true);
+}
+
 static int l_count_chunks(lua::State* L) {
     if (level == nullptr) {
         return 0;
@@ -251,6 +402,12 @@ const luaL_Reg worldlib[] = {
     {"get_chunk_data", lua::wrap<l_get_chunk_data>},
     {"set_chunk_data", lua::wrap<l_set_chunk_data>},
     {"save_chunk_data", lua::wrap<l_save_chunk_data>},
+    {"get_chunk_version", lua::wrap<l_get_chunk_version>},
+    {"get_chunk_delta", lua::wrap<l_get_chunk_delta>},
+    {"apply_chunk_delta", lua::wrap<l_apply_chunk_delta>},
+    {"__pin_chunk", lua::wrap<l_pin_chunk>},
+    {"__unpin_chunk", lua::wrap<l_unpin_chunk>},
+    {"__commit_chunk", lua::wrap<l_commit_chunk>},
     {"count_chunks", lua::wrap<l_count_chunks>},
     {"reload_script", lua::wrap<l_reload_script>},
     {nullptr, nullptr}
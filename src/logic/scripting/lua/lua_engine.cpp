@@ -54,6 +54,7 @@ static void create_libs(State* L, StateType stateType) {
     openlib(L, "json", jsonlib);
     openlib(L, "mat4", mat4lib);
     openlib(L, "pack", packlib);
+    openlib(L, "profiler", profilerlib);
     openlib(L, "quat", quatlib);
     openlib(L, "random", randomlib);
     openlib(L, "compression", compressionlib);
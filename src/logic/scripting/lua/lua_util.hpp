@@ -200,6 +200,10 @@ namespace lua {
         lua_pushboolean(L, value);
         return 1;
     }
+    inline int pushlightuserdata(lua::State* L, void* ptr) {
+        lua_pushlightuserdata(L, ptr);
+        return 1;
+    }
     inline int pushglobals(lua::State* L) {
         return pushvalue(L, LUA_GLOBALSINDEX);
     }
@@ -3,11 +3,13 @@
 
 #include <glm/ext/matrix_transform.hpp>
 #include <sstream>
+#include <thread>
 
 #include "assets/Assets.hpp"
 #include "content/Content.hpp"
 #include "data/dv_util.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "engine/Engine.hpp"
 #include "graphics/core/DrawContext.hpp"
 #include "graphics/core/LineBatch.hpp"
@@ -20,14 +22,140 @@
 #include "Entity.hpp"
 #include "rigging.hpp"
 #include "physics/PhysicsSolver.hpp"
+#include "util/ThreadPool.hpp"
 #include "world/Level.hpp"
 
 static debug::Logger logger("entities");
 
+/// @brief Broadphase grid cell size
+inline const float BROADPHASE_CELL_SIZE = 4.0f;
+
+/// @brief Less bodies are integrated on the main thread only
+inline const size_t PARALLEL_PHYSICS_MIN_BODIES = 128;
+/// @brief Min number of bodies integrated by a single job
+inline const size_t PHYSICS_JOB_MIN_BODIES = 32;
+
+/// @brief Max speed of a body considered staying still
+inline const float SLEEP_MAX_VELOCITY = 0.05f;
+/// @brief Time a body must stay still to fall asleep, seconds
+inline const float SLEEP_DELAY = 1.0f;
+
+struct PhysicsBody {
+    entt::entity entity;
+    entityid_t uid;
+    Hitbox* hitbox;
+    glm::vec3 prevPos;
+    glm::vec3 prevVel;
+    bool grounded;
+    bool sleeping;
+    int substeps;
+};
+
+/// @brief Bodies integrated in a physics step. Workers write only hitboxes
+/// of their range and triggered sensors lists of these bodies, so events are
+/// dispatched on the main thread in the same order as bodies are stored
+struct PhysicsBatch {
+    const GlobalChunks* chunks = nullptr;
+    const PhysicsSolver* solver = nullptr;
+    float delta = 0.0f;
+    std::vector<PhysicsBody> bodies;
+    /// @brief Sensors triggered by bodies of the same index
+    std::vector<std::vector<Sensor*>> triggered;
+    /// @brief Number of bodies integrated by workers, main thread only
+    size_t integrated = 0;
+
+    void integrate(
+        size_t begin, size_t end, std::vector<SpatialHash::id_t>& candidates
+    ) {
+        for (size_t i = begin; i < end; i++) {
+            auto& body = bodies[i];
+            // sleeping bodies are only checked for sensors
+            if (!body.sleeping) {
+                solver->integrate(*chunks, *body.hitbox, delta, body.substeps);
+            }
+            solver->collectTriggered(
+                *body.hitbox, body.uid, candidates, triggered[i]
+            );
+        }
+    }
+};
+
+struct PhysicsJob {
+    PhysicsBatch* batch = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+class PhysicsWorker : public util::Worker<PhysicsJob, size_t> {
+    std::vector<SpatialHash::id_t> candidates;
+public:
+    size_t operator()(const PhysicsJob& job) override {
+        job.batch->integrate(job.begin, job.end, candidates);
+        return job.end - job.begin;
+    }
+};
+
 Entities::Entities(Level& level)
     : level(level),
       sensorsTickClock(20, 3),
-      updateTickClock(20, 3) {
+      updateTickClock(20, 3),
+      broadphase(BROADPHASE_CELL_SIZE),
+      physicsBatch(std::make_unique<PhysicsBatch>()) {
+}
+
+Entities::~Entities() = default;
+
+/// @brief Bounds containing transform position and hitbox both scaled
+/// and not scaled as queries use all of them
+static AABB calc_bounds(const Transform& transform, const Hitbox& hitbox) {
+    glm::vec3 half = glm::max(hitbox.halfsize, hitbox.getHalfSize());
+    return AABB(
+        glm::min(transform.pos, hitbox.position - half),
+        glm::max(transform.pos, hitbox.position + half)
+    );
+}
+
+void Entities::updateBroadphase(
+    entityid_t id, const Transform& transform, const Hitbox& hitbox
+) {
+    broadphase.update(id, calc_bounds(transform, hitbox));
+}
+
+void Entities::wakeUp(const AABB& aabb) {
+    broadphase.query(aabb, candidates);
+    for (auto uid : candidates) {
+        const auto& found = entities.find(uid);
+        if (found == entities.end()) {
+            continue;
+        }
+        if (auto rigidbody = registry.try_get<Rigidbody>(found->second)) {
+            rigidbody->wakeUp();
+        }
+    }
+}
+
+/// @brief Update idle time of a just integrated body putting it to sleep
+/// if it stays still long enough
+static void update_sleeping(
+    Rigidbody& rigidbody, const glm::vec3& prevPos, float delta
+) {
+    const auto& hitbox = rigidbody.hitbox;
+    glm::vec3 offset = hitbox.position - prevPos;
+    float maxDistance = SLEEP_MAX_VELOCITY * delta;
+    bool still = hitbox.type == BodyType::DYNAMIC &&
+                 (hitbox.grounded || hitbox.gravityScale <= 1e-7f) &&
+                 glm::dot(hitbox.velocity, hitbox.velocity) <
+                     SLEEP_MAX_VELOCITY * SLEEP_MAX_VELOCITY &&
+                 glm::dot(offset, offset) < maxDistance * maxDistance;
+    if (!still) {
+        rigidbody.idleTime = 0.0f;
+        return;
+    }
+    rigidbody.idleTime += delta;
+    if (rigidbody.idleTime >= SLEEP_DELAY) {
+        rigidbody.sleeping = true;
+        rigidbody.hitbox.velocity = glm::vec3(0.0f);
+    }
 }
 
 std::optional<Entity> Entities::get(entityid_t id) {
@@ -100,6 +228,7 @@ entityid_t Entities::spawn(
         loadEntity(saved, get(id).value());
     }
     body.hitbox.position = tsf.pos;
+    updateBroadphase(id, tsf, body.hitbox);
     scripting::on_entity_spawn(
         def, id, scripting.components, args, componentsMap
     );
@@ -148,13 +277,20 @@ std::optional<Entities::RaycastResult> Entities::rayCast(
     glm::vec3 start, glm::vec3 dir, float maxDistance, entityid_t ignore
 ) {
     Ray ray(start, dir);
-    auto view = registry.view<EntityId, Transform, Rigidbody>();
 
     entityid_t foundUID = 0;
     glm::ivec3 foundNormal;
 
-    for (auto [entity, eid, transform, body] : view.each()) {
-        if (eid.uid == ignore || !body.enabled) {
+    glm::vec3 end = start + dir * maxDistance;
+    broadphase.query(
+        AABB(glm::min(start, end), glm::max(start, end)), candidates
+    );
+    for (auto uid : candidates) {
+        if (uid == ignore) {
+            continue;
+        }
+        auto& body = registry.get<Rigidbody>(entities.at(uid));
+        if (!body.enabled) {
             continue;
         }
         auto& hitbox = body.hitbox;
@@ -163,7 +299,7 @@ std::optional<Entities::RaycastResult> Entities::rayCast(
         if (ray.intersectAABB(
                 glm::vec3(), hitbox.getAABB(), maxDistance, normal, distance
             ) > RayRelation::None) {
-            foundUID = eid.uid;
+            foundUID = uid;
             foundNormal = normal;
             maxDistance = static_cast<float>(distance);
         }
@@ -223,6 +359,7 @@ void Entities::clean() {
             for (auto& sensor : rigidbody.sensors) {
                 physics->removeSensor(&sensor);
             }
+            broadphase.remove(it->first);
             uids.erase(it->second);
             registry.destroy(it->second);
             it = entities.erase(it);
@@ -282,40 +419,134 @@ void Entities::preparePhysics(float delta) {
     }
 }
 
+void Entities::integrateBodies(PhysicsBatch& batch) {
+    debug::ProfileZone zone("Entities::integrateBodies");
+    size_t count = batch.bodies.size();
+    if (count < PARALLEL_PHYSICS_MIN_BODIES) {
+        batch.integrate(0, count, candidates);
+        return;
+    }
+    if (physicsPool == nullptr) {
+        physicsPool = std::make_unique<util::ThreadPool<PhysicsJob, size_t>>(
+            "physics-pool",
+            []() { return std::make_shared<PhysicsWorker>(); },
+            [this](size_t& integrated) {
+                physicsBatch->integrated += integrated;
+            },
+            util::ThreadPool<PhysicsJob, size_t>::HALF
+        );
+    }
+    // main thread takes a range too
+    size_t jobs = physicsPool->getWorkersCount() + 1;
+    size_t rangeSize =
+        std::max(PHYSICS_JOB_MIN_BODIES, (count + jobs - 1) / jobs);
+
+    batch.integrated = 0;
+    size_t mainRangeBegin = std::min(count, (jobs - 1) * rangeSize);
+    for (size_t begin = 0; begin < mainRangeBegin; begin += rangeSize) {
+        physicsPool->enqueueJob(PhysicsJob {
+            &batch, begin, std::min(mainRangeBegin, begin + rangeSize)});
+    }
+    batch.integrate(mainRangeBegin, count, candidates);
+    while (batch.integrated < mainRangeBegin) {
+        physicsPool->update();
+        if (batch.integrated < mainRangeBegin) {
+            std::this_thread::yield();
+        }
+    }
+}
+
 void Entities::updatePhysics(float delta) {
+    debug::ProfileZone zone("Entities::updatePhysics");
     preparePhysics(delta);
 
+    auto& batch = *physicsBatch;
+    batch.chunks = level.chunks.get();
+    batch.solver = level.physics.get();
+    batch.delta = delta;
+    batch.bodies.clear();
+
+    activeBodies = 0;
+    sleepingBodies = 0;
+
     auto view = registry.view<EntityId, Transform, Rigidbody>();
-    auto physics = level.physics.get();
     for (auto [entity, eid, transform, rigidbody] : view.each()) {
-        if (!rigidbody.enabled || rigidbody.hitbox.type == BodyType::STATIC) {
+        auto& hitbox = rigidbody.hitbox;
+        if (!rigidbody.enabled || hitbox.type == BodyType::STATIC) {
+            rigidbody.wakeUp();
+            updateBroadphase(eid.uid, transform, hitbox);
             continue;
         }
-        auto& hitbox = rigidbody.hitbox;
-        auto prevVel = hitbox.velocity;
-        bool grounded = hitbox.grounded;
-
-        float vel = glm::length(prevVel);
+        // velocity set by scripts or player controls wakes body up
+        if (rigidbody.sleeping && hitbox.velocity != glm::vec3(0.0f)) {
+            rigidbody.wakeUp();
+        }
+        if (rigidbody.sleeping) {
+            sleepingBodies++;
+        } else {
+            activeBodies++;
+        }
+        float vel = glm::length(hitbox.velocity);
         int substeps = static_cast<int>(delta * vel * 20);
         substeps = std::min(100, std::max(2, substeps));
-        physics->step(*level.chunks, hitbox, delta, substeps, eid.uid);
+        batch.bodies.push_back(PhysicsBody {
+            entity,
+            eid.uid,
+            &hitbox,
+            hitbox.position,
+            hitbox.velocity,
+            hitbox.grounded,
+            rigidbody.sleeping,
+            substeps});
+    }
+    if (batch.triggered.size() < batch.bodies.size()) {
+        batch.triggered.resize(batch.bodies.size());
+    }
+    integrateBodies(batch);
+
+    // events are dispatched after all bodies are integrated, so components
+    // are accessed again as scripts may change the registry
+    for (size_t i = 0; i < batch.bodies.size(); i++) {
+        const auto& body = batch.bodies[i];
+        if (!registry.valid(body.entity)) {
+            continue;
+        }
+        auto& transform = registry.get<Transform>(body.entity);
+        auto& rigidbody = registry.get<Rigidbody>(body.entity);
+        auto& hitbox = rigidbody.hitbox;
+        if (body.sleeping) {
+            for (auto sensor : batch.triggered[i]) {
+                // entering a sensor wakes body up
+                if (PhysicsSolver::trigger(*sensor, body.uid)) {
+                    rigidbody.wakeUp();
+                }
+            }
+            continue;
+        }
+        bool grounded = body.grounded;
         hitbox.friction = glm::abs(hitbox.gravityScale <= 1e-7f)
                               ? 8.0f
                               : (!grounded ? 2.0f : 10.0f);
         hitbox.scale = transform.size;
         transform.setPos(hitbox.position);
+        updateBroadphase(body.uid, transform, hitbox);
+        for (auto sensor : batch.triggered[i]) {
+            PhysicsSolver::trigger(*sensor, body.uid);
+        }
+        update_sleeping(rigidbody, body.prevPos, delta);
         if (hitbox.grounded && !grounded) {
             scripting::on_entity_grounded(
-                *get(eid.uid), glm::length(prevVel - hitbox.velocity)
+                *get(body.uid), glm::length(body.prevVel - hitbox.velocity)
             );
         }
         if (!hitbox.grounded && grounded) {
-            scripting::on_entity_fall(*get(eid.uid));
+            scripting::on_entity_fall(*get(body.uid));
         }
     }
 }
 
 void Entities::update(float delta) {
+    debug::ProfileZone zone("Entities::update");
     if (updateTickClock.update(delta)) {
         scripting::on_entities_update(
             updateTickClock.getTickRate(),
@@ -425,8 +656,11 @@ void Entities::render(
 }
 
 bool Entities::hasBlockingInside(AABB aabb) {
-    auto view = registry.view<EntityId, Rigidbody>();
-    for (auto [entity, eid, body] : view.each()) {
+    broadphase.query(aabb, candidates);
+    for (auto uid : candidates) {
+        auto entity = entities.at(uid);
+        const auto& eid = registry.get<EntityId>(entity);
+        const auto& body = registry.get<Rigidbody>(entity);
         if (eid.def.blocking && aabb.intersect(body.hitbox.getAABB(), -0.05f)) {
             return true;
         }
@@ -436,14 +670,13 @@ bool Entities::hasBlockingInside(AABB aabb) {
 
 std::vector<Entity> Entities::getAllInside(AABB aabb) {
     std::vector<Entity> collected;
-    auto view = registry.view<EntityId, Transform>();
-    for (auto [entity, eid, transform] : view.each()) {
+    broadphase.query(aabb, candidates);
+    for (auto uid : candidates) {
+        auto entity = entities.at(uid);
+        const auto& eid = registry.get<EntityId>(entity);
+        const auto& transform = registry.get<Transform>(entity);
         if (!eid.destroyFlag && aabb.contains(transform.pos)) {
-            const auto& found = uids.find(entity);
-            if (found == uids.end()) {
-                continue;
-            }
-            if (auto wrapper = get(found->second)) {
+            if (auto wrapper = get(uid)) {
                 collected.push_back(*wrapper);
             }
         }
@@ -453,14 +686,11 @@ std::vector<Entity> Entities::getAllInside(AABB aabb) {
 
 std::vector<Entity> Entities::getAllInRadius(glm::vec3 center, float radius) {
     std::vector<Entity> collected;
-    auto view = registry.view<Transform>();
-    for (auto [entity, transform] : view.each()) {
+    broadphase.query(AABB(center - radius, center + radius), candidates);
+    for (auto uid : candidates) {
+        const auto& transform = registry.get<Transform>(entities.at(uid));
         if (glm::distance2(transform.pos, center) <= radius * radius) {
-            const auto& found = uids.find(entity);
-            if (found == uids.end()) {
-                continue;
-            }
-            if (auto wrapper = get(found->second)) {
+            if (auto wrapper = get(uid)) {
                 collected.push_back(*wrapper);
             }
         }
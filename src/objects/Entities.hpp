@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "physics/Hitbox.hpp"
+#include "physics/SpatialHash.hpp"
 #include "Transform.hpp"
 #include "Rigidbody.hpp"
 #include "ScriptComponents.hpp"
@@ -31,6 +32,14 @@ namespace rigging {
     class SkeletonConfig;
 }
 
+namespace util {
+    template <class T, class R>
+    class ThreadPool;
+}
+
+struct PhysicsJob;
+struct PhysicsBatch;
+
 class Entities {
     entt::registry registry;
     Level& level;
@@ -39,11 +48,21 @@ class Entities {
     entityid_t nextID = 1;
     util::Clock sensorsTickClock;
     util::Clock updateTickClock;
+    /// @brief Entities bounds by UID, updated on physics update and teleports
+    SpatialHash broadphase;
+    std::vector<SpatialHash::id_t> candidates;
+    /// @brief Bodies integrated this physics step
+    std::unique_ptr<PhysicsBatch> physicsBatch;
+    /// @brief Created on first step with enough bodies to run in parallel
+    std::unique_ptr<util::ThreadPool<PhysicsJob, size_t>> physicsPool;
+    size_t activeBodies = 0;
+    size_t sleepingBodies = 0;
 
     void updateSensors(
         Rigidbody& body, const Transform& tsf, std::vector<Sensor*>& sensors
     );
     void preparePhysics(float delta);
+    void integrateBodies(PhysicsBatch& batch);
 public:
     struct RaycastResult {
         entityid_t entity;
@@ -52,6 +71,7 @@ public:
     };
 
     Entities(Level& level);
+    ~Entities();
 
     void clean();
     void updatePhysics(float delta);
@@ -93,6 +113,14 @@ public:
         entityid_t ignore = -1
     );
 
+    /// @brief Update entity bounds used by spatial queries
+    void updateBroadphase(
+        entityid_t id, const Transform& transform, const Hitbox& hitbox
+    );
+
+    /// @brief Wake up sleeping bodies intersecting the box
+    void wakeUp(const AABB& aabb);
+
     void loadEntities(dv::value map);
     void loadEntity(const dv::value& map);
     void loadEntity(const dv::value& map, Entity entity);
@@ -112,6 +140,17 @@ public:
         return entities.size();
     }
 
+    /// @brief Get number of bodies integrated in the last physics update
+    inline size_t getActiveBodiesCount() const {
+        return activeBodies;
+    }
+
+    /// @brief Get number of bodies skipped as sleeping in the last physics
+    /// update
+    inline size_t getSleepingBodiesCount() const {
+        return sleepingBodies;
+    }
+
     inline entityid_t peekNextID() const {
         return nextID;
     }
@@ -12,6 +12,16 @@
 
 static inline std::string SAVED_DATA_VARNAME = "SAVED_DATA";
 
+void Entity::setPosition(const glm::vec3& position) {
+    auto& transform = getTransform();
+    auto& rigidbody = getRigidbody();
+    auto& hitbox = rigidbody.hitbox;
+    transform.setPos(position);
+    hitbox.position = position;
+    rigidbody.wakeUp();
+    entities.updateBroadphase(id, transform, hitbox);
+}
+
 void Entity::setInterpolatedPosition(const glm::vec3& position) {
     getSkeleton().interpolation.refresh(position);
 }
@@ -68,6 +68,9 @@ public:
 
     void setPlayer(int64_t id);
 
+    /// @brief Move transform and hitbox to the position
+    void setPosition(const glm::vec3& position);
+
     void setInterpolatedPosition(const glm::vec3& position);
 
     glm::vec3 getInterpolatedPosition() const;
@@ -9,6 +9,7 @@
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "objects/Entities.hpp"
+#include "voxels/GlobalChunks.hpp"
 
 Players::Players(Level& level) : level(level) {}
 
@@ -113,6 +114,7 @@ void Players::resume(int64_t id) {
 }
 
 void Players::remove(int64_t id) {
+    level.chunks->removeInterestRegion(id);
     players.erase(id);
 }
 
@@ -13,6 +13,15 @@ struct Rigidbody {
     bool enabled = true;
     Hitbox hitbox;
     std::vector<Sensor> sensors;
+    /// @brief Sleeping body is not integrated until woken up
+    bool sleeping = false;
+    /// @brief Time the body stays still, seconds
+    float idleTime = 0.0f;
+
+    void wakeUp() {
+        sleeping = false;
+        idleTime = 0.0f;
+    }
 
     dv::value serialize(bool saveVelocity, bool saveBodySettings) const;
     void deserialize(const dv::value& root);
@@ -14,7 +14,32 @@
 inline const float E = 0.03f;
 inline const float MAX_FIX = 0.1f;
 
-PhysicsSolver::PhysicsSolver(glm::vec3 gravity) : gravity(gravity) {}
+/// @brief Sensors grid cell size, sensors are usually few blocks large
+inline const float SENSORS_CELL_SIZE = 4.0f;
+
+PhysicsSolver::PhysicsSolver(glm::vec3 gravity)
+    : gravity(gravity), sensorsGrid(SENSORS_CELL_SIZE) {}
+
+static AABB calc_sensor_bounds(const Sensor& sensor) {
+    switch (sensor.type) {
+        case SensorType::AABB:
+            return sensor.calculated.aabb;
+        case SensorType::RADIUS: {
+            glm::vec3 center(sensor.calculated.radial);
+            float radius = glm::sqrt(sensor.calculated.radial.w);
+            return AABB(center - radius, center + radius);
+        }
+    }
+    return AABB();
+}
+
+void PhysicsSolver::setSensors(std::vector<Sensor*> sensors) {
+    this->sensors = std::move(sensors);
+    sensorsGrid.clear();
+    for (size_t i = 0; i < this->sensors.size(); i++) {
+        sensorsGrid.update(i, calc_sensor_bounds(*this->sensors[i]));
+    }
+}
 
 void PhysicsSolver::step(
     const GlobalChunks& chunks, 
@@ -23,6 +48,16 @@ void PhysicsSolver::step(
     uint substeps, 
     entityid_t entity
 ) {
+    integrate(chunks, hitbox, delta, substeps);
+    collectTriggered(hitbox, entity, candidates, triggered);
+    for (auto sensor : triggered) {
+        trigger(*sensor, entity);
+    }
+}
+
+void PhysicsSolver::integrate(
+    const GlobalChunks& chunks, Hitbox& hitbox, float delta, uint substeps
+) const {
     float dt = delta / static_cast<float>(substeps);
     float linearDamping = hitbox.linearDamping * hitbox.friction;
     float s = 2.0f/BLOCK_AABB_GRID;
@@ -88,12 +123,22 @@ void PhysicsSolver::step(
     if (hitbox.verticalDamping > 0.0f) {
         vel.y /= 1.0f + delta * linearDamping * hitbox.verticalDamping;
     }
+}
 
+void PhysicsSolver::collectTriggered(
+    const Hitbox& hitbox,
+    entityid_t entity,
+    std::vector<SpatialHash::id_t>& candidates,
+    std::vector<Sensor*>& dst
+) const {
+    dst.clear();
     AABB aabb;
     aabb.a = hitbox.position - hitbox.getHalfSize();
     aabb.b = hitbox.position + hitbox.getHalfSize();
-    for (size_t i = 0; i < sensors.size(); i++) {
-        auto& sensor = *sensors[i];
+    // candidates are sorted so callbacks order does not depend on the grid
+    sensorsGrid.query(aabb, candidates);
+    for (auto index : candidates) {
+        auto& sensor = *sensors[index];
         if (sensor.entity == entity) {
             continue;
         }
@@ -110,14 +155,21 @@ void PhysicsSolver::step(
                 break;
         }
         if (triggered) {
-            if (sensor.prevEntered.find(entity) == sensor.prevEntered.end()) {
-                sensor.enterCallback(sensor.entity, sensor.index, entity);
-            }
-            sensor.nextEntered.insert(entity);
+            dst.push_back(&sensor);
         }
     }
 }
 
+bool PhysicsSolver::trigger(Sensor& sensor, entityid_t entity) {
+    bool entered =
+        sensor.prevEntered.find(entity) == sensor.prevEntered.end();
+    if (entered) {
+        sensor.enterCallback(sensor.entity, sensor.index, entity);
+    }
+    sensor.nextEntered.insert(entity);
+    return entered;
+}
+
 static float calc_step_height(
     const GlobalChunks& chunks, 
     const glm::vec3& pos, 
@@ -210,7 +262,7 @@ void PhysicsSolver::colisionCalc(
     glm::vec3& pos, 
     const glm::vec3 half,
     float stepHeight
-) {
+) const {
     // step size (smaller - more accurate, but slower)
     float s = 2.0f/BLOCK_AABB_GRID;
 
@@ -291,5 +343,11 @@ bool PhysicsSolver::isBlockInside(int x, int y, int z, Block* def, blockstate st
 }
 
 void PhysicsSolver::removeSensor(Sensor* sensor) {
-    sensors.erase(std::remove(sensors.begin(), sensors.end(), sensor), sensors.end());
+    // indices are kept as they are used as sensors grid ids
+    for (size_t i = 0; i < sensors.size(); i++) {
+        if (sensors[i] == sensor) {
+            sensorsGrid.remove(i);
+            sensors[i] = nullptr;
+        }
+    }
 }
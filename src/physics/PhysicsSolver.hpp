@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Hitbox.hpp"
+#include "SpatialHash.hpp"
 
 #include "typedefs.hpp"
 #include "voxels/voxel.hpp"
@@ -15,8 +16,14 @@ struct Sensor;
 class PhysicsSolver {
     glm::vec3 gravity;
     std::vector<Sensor*> sensors;
+    /// @brief Sensors bounds by index in sensors vector
+    SpatialHash sensorsGrid;
+    std::vector<SpatialHash::id_t> candidates;
+    std::vector<Sensor*> triggered;
 public:
     PhysicsSolver(glm::vec3 gravity);
+
+    /// @brief Integrate body and trigger sensors it's inside
     void step(
         const GlobalChunks& chunks,
         Hitbox& hitbox,
@@ -24,6 +31,29 @@ public:
         uint substeps,
         entityid_t entity
     );
+
+    /// @brief Move body resolving blocks collisions. Chunks are only read
+    /// so different bodies may be integrated in parallel
+    void integrate(
+        const GlobalChunks& chunks, Hitbox& hitbox, float delta, uint substeps
+    ) const;
+
+    /// @brief Collect sensors the body is inside without calling callbacks.
+    /// Thread-safe while sensors are not changed
+    /// @param candidates grid query buffer
+    /// @param dst destination vector, cleared before collecting
+    void collectTriggered(
+        const Hitbox& hitbox,
+        entityid_t entity,
+        std::vector<SpatialHash::id_t>& candidates,
+        std::vector<Sensor*>& dst
+    ) const;
+
+    /// @brief Mark body entered the sensor calling enter callback
+    /// if it was not inside before
+    /// @return true if enter callback was called
+    static bool trigger(Sensor& sensor, entityid_t entity);
+
     void colisionCalc(
         const GlobalChunks& chunks,
         Hitbox& hitbox,
@@ -31,13 +61,11 @@ public:
         glm::vec3& pos,
         const glm::vec3 half,
         float stepHeight
-    );
+    ) const;
     bool isBlockInside(int x, int y, int z, Hitbox* hitbox);
     bool isBlockInside(int x, int y, int z, Block* def, blockstate state, Hitbox* hitbox);
 
-    void setSensors(std::vector<Sensor*> sensors) {
-        this->sensors = std::move(sensors);
-    }
+    void setSensors(std::vector<Sensor*> sensors);
 
     void removeSensor(Sensor* sensor);
 };
@@ -0,0 +1,172 @@
+#include "SpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static inline bool overlaps(
+    const glm::vec3& minA,
+    const glm::vec3& maxA,
+    const glm::vec3& minB,
+    const glm::vec3& maxB
+) {
+    return minA.x <= maxB.x && maxA.x >= minB.x && minA.y <= maxB.y &&
+           maxA.y >= minB.y && minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+static inline double count_cells(const glm::ivec3& min, const glm::ivec3& max) {
+    return (max.x - min.x + 1.0) * (max.y - min.y + 1.0) * (max.z - min.z + 1.0);
+}
+
+static inline bool is_finite(const glm::vec3& min, const glm::vec3& max) {
+    return std::isfinite(min.x) && std::isfinite(min.y) &&
+           std::isfinite(min.z) && std::isfinite(max.x) &&
+           std::isfinite(max.y) && std::isfinite(max.z);
+}
+
+/// @brief Cells coordinates limit keeping conversions to int defined
+static constexpr float MAX_CELL_COORD = 1e8f;
+
+SpatialHash::SpatialHash(float cellSize) : cellSize(cellSize) {
+}
+
+glm::ivec3 SpatialHash::cellAt(const glm::vec3& pos) const {
+    auto coord = [this](float value) {
+        return static_cast<int>(std::clamp(
+            std::floor(value / cellSize), -MAX_CELL_COORD, MAX_CELL_COORD
+        ));
+    };
+    return glm::ivec3(coord(pos.x), coord(pos.y), coord(pos.z));
+}
+
+void SpatialHash::link(id_t id, const Object& object) {
+    if (object.large) {
+        largeObjects.push_back(id);
+        return;
+    }
+    const auto& min = object.minCell;
+    const auto& max = object.maxCell;
+    for (int y = min.y; y <= max.y; y++) {
+        for (int z = min.z; z <= max.z; z++) {
+            for (int x = min.x; x <= max.x; x++) {
+                cells[glm::ivec3(x, y, z)].push_back(id);
+            }
+        }
+    }
+}
+
+void SpatialHash::unlink(id_t id, const Object& object) {
+    if (object.large) {
+        largeObjects.erase(
+            std::find(largeObjects.begin(), largeObjects.end(), id)
+        );
+        return;
+    }
+    const auto& min = object.minCell;
+    const auto& max = object.maxCell;
+    for (int y = min.y; y <= max.y; y++) {
+        for (int z = min.z; z <= max.z; z++) {
+            for (int x = min.x; x <= max.x; x++) {
+                const auto& found = cells.find(glm::ivec3(x, y, z));
+                if (found == cells.end()) {
+                    continue;
+                }
+                auto& ids = found->second;
+                auto iter = std::find(ids.begin(), ids.end(), id);
+                if (iter != ids.end()) {
+                    *iter = ids.back();
+                    ids.pop_back();
+                }
+                if (ids.empty()) {
+                    cells.erase(found);
+                }
+            }
+        }
+    }
+}
+
+void SpatialHash::update(id_t id, const AABB& aabb) {
+    Object object {aabb.min(), aabb.max(), {}, {}, true};
+    if (is_finite(object.min, object.max)) {
+        object.minCell = cellAt(object.min);
+        object.maxCell = cellAt(object.max);
+        object.large =
+            count_cells(object.minCell, object.maxCell) > MAX_OBJECT_CELLS;
+    }
+
+    const auto& found = objects.find(id);
+    if (found == objects.end()) {
+        link(id, object);
+        objects.emplace(id, object);
+        return;
+    }
+    auto& prev = found->second;
+    if (prev.large != object.large || prev.minCell != object.minCell ||
+        prev.maxCell != object.maxCell) {
+        unlink(id, prev);
+        link(id, object);
+    }
+    prev = object;
+}
+
+void SpatialHash::remove(id_t id) {
+    const auto& found = objects.find(id);
+    if (found == objects.end()) {
+        return;
+    }
+    unlink(id, found->second);
+    objects.erase(found);
+}
+
+void SpatialHash::clear() {
+    objects.clear();
+    cells.clear();
+    largeObjects.clear();
+}
+
+void SpatialHash::query(const AABB& aabb, std::vector<id_t>& dst) const {
+    dst.clear();
+    glm::vec3 min = aabb.min();
+    glm::vec3 max = aabb.max();
+    if (!is_finite(min, max)) {
+        return;
+    }
+    glm::ivec3 minCell = cellAt(min);
+    glm::ivec3 maxCell = cellAt(max);
+
+    if (count_cells(minCell, maxCell) > objects.size()) {
+        // checking all objects is cheaper than visiting all cells
+        for (const auto& [id, object] : objects) {
+            if (overlaps(min, max, object.min, object.max)) {
+                dst.push_back(id);
+            }
+        }
+        std::sort(dst.begin(), dst.end());
+        return;
+    }
+    for (int y = minCell.y; y <= maxCell.y; y++) {
+        for (int z = minCell.z; z <= maxCell.z; z++) {
+            for (int x = minCell.x; x <= maxCell.x; x++) {
+                const auto& found = cells.find(glm::ivec3(x, y, z));
+                if (found != cells.end()) {
+                    dst.insert(
+                        dst.end(), found->second.begin(), found->second.end()
+                    );
+                }
+            }
+        }
+    }
+    dst.insert(dst.end(), largeObjects.begin(), largeObjects.end());
+    std::sort(dst.begin(), dst.end());
+    dst.erase(std::unique(dst.begin(), dst.end()), dst.end());
+    dst.erase(
+        std::remove_if(
+            dst.begin(),
+            dst.end(),
+            [this, &min, &max](id_t id) {
+                const auto& object = objects.at(id);
+                return !overlaps(min, max, object.min, object.max);
+            }
+        ),
+        dst.end()
+    );
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include "maths/aabb.hpp"
+
+/// @brief Uniform grid of objects bounding boxes used as a broadphase
+/// for entities queries and sensors. Object cells are changed only when
+/// it moves to another cells range
+class SpatialHash {
+public:
+    using id_t = uint64_t;
+
+    /// @brief Objects covering more cells are stored out of the grid
+    /// and returned by every query
+    static constexpr int MAX_OBJECT_CELLS = 64;
+
+    explicit SpatialHash(float cellSize);
+
+    /// @brief Insert object or update its bounding box
+    void update(id_t id, const AABB& aabb);
+
+    void remove(id_t id);
+
+    void clear();
+
+    /// @brief Collect objects which bounding boxes intersect the given box
+    /// (including touching ones)
+    /// @param dst destination vector, cleared before query.
+    /// Sorted by id on return
+    void query(const AABB& aabb, std::vector<id_t>& dst) const;
+
+    size_t size() const {
+        return objects.size();
+    }
+
+    /// @brief Get number of non-empty grid cells
+    size_t countCells() const {
+        return cells.size();
+    }
+private:
+    struct Object {
+        glm::vec3 min;
+        glm::vec3 max;
+        glm::ivec3 minCell;
+        glm::ivec3 maxCell;
+        bool large;
+    };
+    float cellSize;
+    std::unordered_map<id_t, Object> objects;
+    std::unordered_map<glm::ivec3, std::vector<id_t>> cells;
+    std::vector<id_t> largeObjects;
+
+    glm::ivec3 cellAt(const glm::vec3& pos) const;
+
+    void link(id_t id, const Object& object);
+    void unlink(id_t id, const Object& object);
+};
@@ -71,6 +71,8 @@ struct GraphicsSettings {
     FlagSetting denseRender {true};
     /// @brief Enable chunks frustum culling
     FlagSetting frustumCulling {true};
+    /// @brief Skip chunks hidden behind other chunks
+    FlagSetting occlusionCulling {true};
     /// @brief Skybox texture face resolution
     IntegerSetting skyboxResolution {64 + 32, 64, 128};
     /// @brief Chunk renderer vertices buffer capacity
@@ -89,11 +91,13 @@ struct GraphicsSettings {
     IntegerSetting denseRenderDistance {56, 0, 10'000};
     /// @brief Soft lighting for blocks
     FlagSetting softLighting {true};
-};
-
-struct PathfindingSettings {
-    /// @brief Max visited blocks by an agent per async tick
-    IntegerSetting stepsPerAsyncAgent {128, 1, 2048};
+    /// @brief Merge coplanar faces of opaque cubes sharing texture and light
+    FlagSetting greedyMeshing {false};
+    /// @brief Use compact fixed point chunk vertices
+    FlagSetting packedChunkVertices {false};
+    /// @brief Distance (chunks) from which chunks are meshed with lower
+    /// detail (0 - disabled)
+    IntegerSetting lodDistance {0, 0, 64};
 };
 
 struct DebugSettings {
@@ -124,5 +128,4 @@ struct EngineSettings {
     DebugSettings debug;
     UiSettings ui;
     NetworkSettings network;
-    PathfindingSettings pathfinding;
 };
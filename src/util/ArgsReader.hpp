@@ -42,5 +42,14 @@ namespace util {
                 throw std::runtime_error(e.what());
             }
         }
+
+        float nextFloat() {
+            auto text = next();
+            try {
+                return std::stof(text);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(e.what());
+            }
+        }
     };
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace util {
+    /// @brief Bounded lock-free queue for exactly one producer thread and
+    /// one consumer thread
+    template <class T>
+    class SPSCQueue {
+        /// @brief Head and tail are kept in separate cache lines to avoid
+        /// false sharing between producer and consumer
+        static constexpr size_t CACHE_LINE = 64;
+
+        std::unique_ptr<std::optional<T>[]> buffer;
+        size_t capacity;
+        size_t mask;
+
+        /// @brief Next slot to pop (written by consumer only)
+        alignas(CACHE_LINE) std::atomic<size_t> head {0};
+        /// @brief Last tail seen by consumer
+        size_t cachedTail = 0;
+
+        /// @brief Next slot to push (written by producer only)
+        alignas(CACHE_LINE) std::atomic<size_t> tail {0};
+        /// @brief Last head seen by producer
+        size_t cachedHead = 0;
+    public:
+        /// @param capacity max number of elements, rounded up to
+        /// power of two
+        SPSCQueue(size_t capacity) {
+            size_t size = 1;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            buffer = std::make_unique<std::optional<T>[]>(size);
+            this->capacity = size;
+            this->mask = size - 1;
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        /// @brief Push value to the queue (producer thread only)
+        /// @return false if queue is full, value is not moved in that case
+        bool tryPush(T&& value) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - cachedHead == capacity) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (t - cachedHead == capacity) {
+                    return false;
+                }
+            }
+            buffer[t & mask].emplace(std::move(value));
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Pop value from the queue (consumer thread only)
+        /// @return std::nullopt if queue is empty
+        std::optional<T> tryPop() {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == cachedTail) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (h == cachedTail) {
+                    return std::nullopt;
+                }
+            }
+            auto& slot = buffer[h & mask];
+            std::optional<T> value = std::move(slot);
+            slot.reset();
+            head.store(h + 1, std::memory_order_release);
+            return value;
+        }
+
+        /// @brief Get number of elements. May be called from any thread,
+        /// the result is approximate while queue is being used
+        size_t size() const {
+            size_t h = head.load(std::memory_order_acquire);
+            return tail.load(std::memory_order_acquire) - h;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        bool full() const {
+            return size() == capacity;
+        }
+
+        size_t getCapacity() const {
+            return capacity;
+        }
+    };
+}
@@ -10,17 +10,16 @@
 #include <utility>
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "delegates.hpp"
 #include "interfaces/Task.hpp"
+#include "SPSCQueue.hpp"
 
 namespace util {
 
     template <class J, class T>
     struct ThreadPoolResult {
         J job;
-        std::condition_variable& variable;
-        int workerIndex;
-        bool& locked;
         T entry;
     };
 
@@ -34,14 +33,32 @@ namespace util {
 
     template <class T, class R>
     class ThreadPool : public Task {
+        /// @brief Results of a single worker. Worker is the only producer
+        /// and the thread calling update() is the only consumer
+        struct WorkerResults {
+            SPSCQueue<ThreadPoolResult<T, R>> queue;
+            /// @brief Number of results pushed (accessed by worker only)
+            uint64_t produced = 0;
+            /// @brief Number of results passed to the consumer
+            std::atomic<uint64_t> consumed = 0;
+
+            WorkerResults(size_t capacity) : queue(capacity) {
+            }
+        };
+
         debug::Logger logger;
+        /// @brief Pool name used for profiler zones
+        const char* zoneName;
         std::queue<T> jobs;
-        std::queue<ThreadPoolResult<T, R>> results;
+        std::vector<std::unique_ptr<WorkerResults>> results;
+        /// @brief Used only to park workers waiting for the main thread:
+        /// on full results queue or until result performed
         std::mutex resultsMutex;
+        std::condition_variable resultsCondition;
+        std::atomic<int> waitingWorkers = 0;
         std::vector<std::thread> threads;
         std::condition_variable jobsMutexCondition;
         std::mutex jobsMutex;
-        std::vector<std::unique_lock<std::mutex>> workersBlocked;
         consumer<R&> resultConsumer;
         consumer<T&> onJobFailed = nullptr;
         runnable onComplete = nullptr;
@@ -52,10 +69,90 @@ namespace util {
         bool standaloneResults = true;
         bool stopOnFail = true;
 
-        void threadLoop(int index, std::shared_ptr<Worker<T, R>> worker) {
-            std::condition_variable variable;
-            std::mutex mutex;
-            bool locked = false;
+        /// @brief Block worker until the predicate is true or the pool
+        /// is terminated
+        /// @return false if the pool is terminated
+        template <class Predicate>
+        bool waitForMainThread(const Predicate& ready) {
+            waitingWorkers++;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(resultsMutex);
+                resultsCondition.wait(lock, [&] {
+                    return !working || ready();
+                });
+            }
+            waitingWorkers--;
+            return working;
+        }
+
+        /// @brief Wake up workers parked in waitForMainThread
+        void notifyWorkers() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waitingWorkers == 0) {
+                return;
+            }
+            { std::lock_guard<std::mutex> lock(resultsMutex); }
+            resultsCondition.notify_all();
+        }
+
+        /// @return false if the pool is terminated while waiting
+        bool pushResult(WorkerResults& slot, ThreadPoolResult<T, R>&& entry) {
+            while (!slot.queue.tryPush(std::move(entry))) {
+                // back-pressure: wait until main thread takes some results
+                if (!waitForMainThread([&] { return !slot.queue.full(); })) {
+                    busyWorkers--;
+                    return false;
+                }
+            }
+            uint64_t produced = ++slot.produced;
+            busyWorkers--;
+            if (!standaloneResults) {
+                return waitForMainThread([&] {
+                    return slot.consumed >= produced;
+                });
+            }
+            return true;
+        }
+
+        /// @brief Pass results available at the moment to the consumer.
+        /// No locks are held while the consumer is called
+        /// @return false if consumer has thrown an exception
+        bool consumeResults(WorkerResults& slot) {
+            size_t count = slot.queue.size();
+            for (size_t i = 0; i < count; i++) {
+                auto entry = slot.queue.tryPop();
+                try {
+                    resultConsumer(entry->entry);
+                } catch (std::exception& err) {
+                    logger.error() << err.what();
+                    if (onJobFailed) {
+                        onJobFailed(entry->job);
+                    }
+                    if (stopOnFail) {
+                        std::lock_guard<std::mutex> jobsLock(jobsMutex);
+                        failed = true;
+                    }
+                    slot.consumed++;
+                    notifyWorkers();
+                    return false;
+                }
+                slot.consumed++;
+            }
+            if (count) {
+                notifyWorkers();
+            }
+            return true;
+        }
+
+        void threadLoop(
+            int index,
+            WorkerResults* slot,
+            std::shared_ptr<Worker<T, R>> worker
+        ) {
+            debug::Profiler::setThreadName(
+                std::string(zoneName) + "-" + std::to_string(index)
+            );
             while (working) {
                 T job;
                 {
@@ -72,21 +169,13 @@ namespace util {
                     busyWorkers++;
                 }
                 try {
-                    R result = (*worker)(job);
-                    {
-                        std::lock_guard<std::mutex> lock(resultsMutex);
-                        results.push(ThreadPoolResult<T, R> {
-                            job, variable, index, locked, result});
-                        if (!standaloneResults) {
-                            locked = true;
-                        }
-                        busyWorkers--;
-                    }
-                    if (!standaloneResults) {
-                        std::unique_lock<std::mutex> lock(mutex);
-                        variable.wait(lock, [&] {
-                            return !working || !locked;
-                        });
+                    R result = [&]() {
+                        debug::ProfileZone zone(zoneName);
+                        return (*worker)(job);
+                    }();
+                    if (!pushResult(*slot, ThreadPoolResult<T, R> {
+                            std::move(job), std::move(result)})) {
+                        break;
                     }
                 } catch (std::exception& err) {
                     busyWorkers--;
@@ -106,6 +195,7 @@ namespace util {
         static constexpr int UNLIMITED = 0;
         static constexpr int HALF = -2;
         static constexpr int QUARTER = -4;
+        static constexpr size_t DEFAULT_RESULTS_CAPACITY = 64;
 
         /// @brief Main thread pool constructor
         /// @param name thread pool name (used in logger)
@@ -113,19 +203,24 @@ namespace util {
         /// @param resultConsumer workers results consumer function
         /// @param maxWorkers max number of workers. Special values: 0 is 
         /// unlimited, -2 is half of auto count, -4 is quarter.
+        /// @param resultsCapacity max number of not consumed results per
+        /// worker. Worker waits for update() call when it's reached
         ThreadPool(
             std::string name,
             supplier<std::shared_ptr<Worker<T, R>>> workersSupplier,
             consumer<R&> resultConsumer,
-            int maxWorkers=UNLIMITED
+            int maxWorkers=UNLIMITED,
+            size_t resultsCapacity=DEFAULT_RESULTS_CAPACITY
         )
-            : logger(std::move(name)), resultConsumer(resultConsumer) {
+            : logger(name),
+              zoneName(debug::Profiler::intern(name)),
+              resultConsumer(resultConsumer) {
             uint numThreads = std::thread::hardware_concurrency();
             switch (maxWorkers) {
                 case UNLIMITED:
                     break;
                 case HALF:
-                    numThreads = std::max(1U, numThreads);
+                    numThreads = std::max(1U, numThreads / 2);
                     break;
                 case QUARTER:
                     numThreads = std::max(1U, numThreads / 4);
@@ -136,11 +231,19 @@ namespace util {
                     );
                     break;
             }
+            for (uint i = 0; i < numThreads; i++) {
+                results.push_back(
+                    std::make_unique<WorkerResults>(resultsCapacity)
+                );
+            }
             for (uint i = 0; i < numThreads; i++) {
                 threads.emplace_back(
-                    &ThreadPool<T, R>::threadLoop, this, i, workersSupplier()
+                    &ThreadPool<T, R>::threadLoop,
+                    this,
+                    i,
+                    results[i].get(),
+                    workersSupplier()
                 );
-                workersBlocked.emplace_back();
             }
         }
         ~ThreadPool() {
@@ -159,17 +262,8 @@ namespace util {
                 std::lock_guard<std::mutex> lock(jobsMutex);
                 working = false;
             }
-            {
-                std::lock_guard<std::mutex> lock(resultsMutex);
-                while (!results.empty()) {
-                    ThreadPoolResult<T, R> entry = results.front();
-                    results.pop();
-                    if (!standaloneResults) {
-                        entry.locked = false;
-                        entry.variable.notify_all();
-                    }
-                }
-            }
+            { std::lock_guard<std::mutex> lock(resultsMutex); }
+            resultsCondition.notify_all();
 
             jobsMutexCondition.notify_all();
             for (auto& thread : threads) {
@@ -186,39 +280,17 @@ namespace util {
             }
 
             bool complete = false;
-            {
-                std::lock_guard<std::mutex> lock(resultsMutex);
-                while (!results.empty()) {
-                    ThreadPoolResult<T, R> entry = results.front();
-                    results.pop();
-
-                    try {
-                        resultConsumer(entry.entry);
-                    } catch (std::exception& err) {
-                        logger.error() << err.what();
-                        if (onJobFailed) {
-                            onJobFailed(entry.job);
-                        }
-                        if (stopOnFail) {
-                            std::lock_guard<std::mutex> jobsLock(jobsMutex);
-                            failed = true;
-                            complete = false;
-                        }
-                        break;
-                    }
-
-                    if (!standaloneResults) {
-                        entry.locked = false;
-                        entry.variable.notify_all();
-                    }
+            for (const auto& slot : results) {
+                if (!consumeResults(*slot)) {
+                    break;
                 }
-
-                if (onComplete && busyWorkers == 0) {
-                    std::lock_guard<std::mutex> jobsLock(jobsMutex);
-                    if (jobs.empty()) {
-                        onComplete();
-                        complete = true;
-                    }
+            }
+            if (onComplete && !failed && busyWorkers == 0) {
+                // busyWorkers is decremented after pushing result
+                std::lock_guard<std::mutex> jobsLock(jobsMutex);
+                if (jobs.empty() && busyWorkers == 0 && !hasResults()) {
+                    onComplete();
+                    complete = true;
                 }
             }
             if (failed) {
@@ -279,6 +351,16 @@ namespace util {
             }
         }
 
+        /// @brief Check if there are results not passed to the consumer yet
+        bool hasResults() const {
+            for (const auto& slot : results) {
+                if (!slot->queue.empty()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
         uint getWorkersCount() const {
             return threads.size();
         }
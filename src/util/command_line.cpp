@@ -74,6 +74,44 @@ static bool perform_keyword(
             params.debugServerString = reader.next();
             return true;
         }, "<serv>", "open debugging server where <serv> is {transport}:{port}"),
+        ArgC("--profile", [&params, &reader]() -> bool {
+            params.profileFile = reader.next();
+            return true;
+        }, "<path>", "headless mode profiling trace output file."),
+        ArgC("--load-test", [&params, &reader]() -> bool {
+            params.headless = true;
+            params.testMode = true;
+            params.loadTest.players = reader.nextInt();
+            return true;
+        }, "<players>", "run headless load test with synthetic players."),
+        ArgC("--load-ticks", [&params, &reader]() -> bool {
+            params.loadTest.ticks = reader.nextInt();
+            return true;
+        }, "<ticks>", "load test duration (default - 6000)."),
+        ArgC("--load-speed", [&params, &reader]() -> bool {
+            params.loadTest.speed = reader.nextFloat();
+            return true;
+        }, "<speed>", "load test players speed in blocks per second."),
+        ArgC("--load-trajectory", [&params, &reader]() -> bool {
+            params.loadTest.trajectory = reader.next();
+            return true;
+        }, "<name>", "load test players trajectory: random, line, circle."),
+        ArgC("--load-seed", [&params, &reader]() -> bool {
+            params.loadTest.seed = reader.next();
+            return true;
+        }, "<seed>", "load test world seed."),
+        ArgC("--load-generator", [&params, &reader]() -> bool {
+            params.loadTest.generator = reader.next();
+            return true;
+        }, "<name>", "load test world generator."),
+        ArgC("--load-report", [&params, &reader]() -> bool {
+            params.loadTest.reportFile = reader.next();
+            return true;
+        }, "<path>", "load test json report output file."),
+        ArgC("--load-overwrite", [&params]() -> bool {
+            params.loadTest.overwrite = true;
+            return true;
+        }, "", "allow load test to replace existing 'load-test' world."),
         ArgC("--help", []() -> bool {
             std::cout << "VoxelCore v" << ENGINE_VERSION_STRING << "\n\n";
             std::cout << "Command-line arguments:\n";
@@ -14,8 +14,10 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <psapi.h>
 #pragma comment(lib, "winmm.lib")
 #else
+#include <sys/resource.h>
 #include <unistd.h>
 #endif
 
@@ -74,6 +76,16 @@ int platform::get_process_id() {
     return GetCurrentProcessId(); 
 }
 
+size_t platform::get_peak_memory_usage() {
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (!K32GetProcessMemoryInfo(
+            GetCurrentProcess(), &counters, sizeof(counters)
+        )) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+}
+
 bool platform::open_url(const std::string& url) {
     if (url.empty()) return false;
     // UTF-8 → UTF-16
@@ -119,6 +131,19 @@ int platform::get_process_id() {
     return getpid();
 }
 
+size_t platform::get_peak_memory_usage() {
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    // kilobytes on linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
 bool platform::open_url(const std::string& url) {
     if (url.empty()) return false;
 
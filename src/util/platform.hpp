@@ -15,6 +15,8 @@ namespace platform {
     void sleep(size_t millis);
     /// @brief Get current process id 
     int get_process_id();
+    /// @brief Get peak resident memory of the current process (bytes)
+    size_t get_peak_memory_usage();
     /// @brief Get current process running executable path  
     std::filesystem::path get_executable_path();
     /// @brief Run a separate engine instance with specified arguments
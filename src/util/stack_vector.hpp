@@ -6,7 +6,7 @@ namespace util {
     template<typename T, int capacity>
     class stack_vector {
         struct buffer {
-            alignas(alignof(T)) char* data[sizeof(T) * capacity];
+            alignas(alignof(T)) char data[sizeof(T) * capacity];
 
             T* ptr() {
                 return reinterpret_cast<T*>(data);
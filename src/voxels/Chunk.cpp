@@ -1,11 +1,14 @@
 #include "Chunk.hpp"
 
+#include <algorithm>
 #include <utility>
 
+#include "content/Content.hpp"
 #include "content/ContentReport.hpp"
 #include "items/Inventory.hpp"
 #include "lighting/Lightmap.hpp"
 #include "util/data_io.hpp"
+#include "Block.hpp"
 #include "voxel.hpp"
 
 Chunk::Chunk(int xpos, int zpos, std::shared_ptr<Lightmap> lightmap)
@@ -30,6 +33,28 @@ void Chunk::updateHeights() {
     }
 }
 
+void Chunk::updateLightSources(const ContentIndices& indices) {
+    lightSources.clear();
+    auto defs = indices.blocks.getDefs();
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        if (defs[voxels[i].id]->rt.emissive) {
+            lightSources.push_back(i);
+        }
+    }
+}
+
+void Chunk::addLightSource(uint index) {
+    lightSources.push_back(index);
+}
+
+void Chunk::removeLightSource(uint index) {
+    auto found = std::find(lightSources.begin(), lightSources.end(), index);
+    if (found != lightSources.end()) {
+        *found = lightSources.back();
+        lightSources.pop_back();
+    }
+}
+
 void Chunk::addBlockInventory(
     std::shared_ptr<Inventory> inventory, uint x, uint y, uint z
 ) {
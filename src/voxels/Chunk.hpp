@@ -4,7 +4,9 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
+#include "ChunkJournal.hpp"
 #include "constants.hpp"
 #include "lighting/Lightmap.hpp"
 #include "util/SmallHeap.hpp"
@@ -14,6 +16,7 @@
 /// @brief Total bytes number of chunk voxel data
 inline constexpr int CHUNK_DATA_LEN = CHUNK_VOL * 4;
 
+class ContentIndices;
 class ContentReport;
 class Inventory;
 
@@ -35,6 +38,10 @@ public:
         bool lighted : 1;
         bool unsaved : 1;
         bool loadedLights : 1;
+        /// @brief Block light channels are loaded from cache too
+        bool loadedBlockLights : 1;
+        /// @brief Lights changed since the chunk was loaded
+        bool unsavedLights : 1;
         bool entities : 1;
         bool blocksData : 1;
         bool dirtyHeights : 1;
@@ -44,12 +51,22 @@ public:
     ChunkInventoriesMap inventories;
     /// @brief Blocks metadata heap
     BlocksMetadata blocksMetadata;
+    /// @brief Indices of emissive voxels (unordered)
+    std::vector<uint> lightSources;
+    /// @brief Recent voxels changes
+    ChunkJournal journal;
 
     Chunk(int x, int z, std::shared_ptr<Lightmap> lightmap=nullptr);
 
     /// @brief Refresh `bottom` and `top` values
     void updateHeights();
 
+    /// @brief Rebuild light sources list scanning all voxels
+    void updateLightSources(const ContentIndices& indices);
+
+    void addLightSource(uint index);
+    void removeLightSource(uint index);
+
     /// @brief Creates new block inventory given size
     /// @return inventory id or 0 if block does not exists
     void addBlockInventory(
@@ -64,6 +81,7 @@ public:
     inline void setModifiedAndUnsaved() {
         flags.modified = true;
         flags.unsaved = true;
+        journal.touch();
     }
 
     /// @brief Encode chunk to bytes array of size CHUNK_DATA_LEN
@@ -0,0 +1,51 @@
+#include "ChunkJournal.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<uint64_t> versionsCounter = 0;
+
+ChunkJournal::ChunkJournal() {
+    version = ++versionsCounter;
+    minVersion = version;
+}
+
+void ChunkJournal::record(uint index) {
+    version = ++versionsCounter;
+    if (records.size() < CAPACITY) {
+        records.push_back(Record {version, index});
+        return;
+    }
+    // changes since the evicted record version are still available
+    minVersion = records[next].version;
+    records[next] = Record {version, index};
+    next = (next + 1) % CAPACITY;
+}
+
+void ChunkJournal::touch() {
+    version = ++versionsCounter;
+}
+
+void ChunkJournal::reset() {
+    records.clear();
+    next = 0;
+    version = ++versionsCounter;
+    minVersion = version;
+}
+
+bool ChunkJournal::collectChanges(
+    uint64_t since, std::vector<uint>& dst
+) const {
+    dst.clear();
+    if (since < minVersion || since > version) {
+        return false;
+    }
+    for (const auto& record : records) {
+        if (record.version > since) {
+            dst.push_back(record.index);
+        }
+    }
+    std::sort(dst.begin(), dst.end());
+    dst.erase(std::unique(dst.begin(), dst.end()), dst.end());
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "typedefs.hpp"
+
+/// @brief Recent chunk voxels changes used to replicate chunks by deltas.
+/// Versions are unique process-wide, so a chunk reloaded or replaced
+/// entirely never repeats versions seen before
+class ChunkJournal {
+    struct Record {
+        uint64_t version;
+        uint index;
+    };
+    /// @brief Ring buffer of the most recent records
+    std::vector<Record> records;
+    size_t next = 0;
+    uint64_t version;
+    /// @brief The oldest version changes since which are still available
+    uint64_t minVersion;
+public:
+    /// @brief Max number of records kept
+    static constexpr size_t CAPACITY = 256;
+
+    ChunkJournal();
+
+    /// @brief Record voxel change
+    /// @param index voxel index in chunk
+    void record(uint index);
+
+    /// @brief Increase version without voxels changes
+    /// (e.g. when blocks metadata is modified)
+    void touch();
+
+    /// @brief Forget all records. Used when all voxels are replaced
+    void reset();
+
+    uint64_t getVersion() const {
+        return version;
+    }
+
+    /// @brief Get sorted unique indices of voxels changed since the version
+    /// @return false if changes since the version are not available
+    bool collectChanges(uint64_t since, std::vector<uint>& dst) const;
+};
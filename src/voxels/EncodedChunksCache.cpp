@@ -0,0 +1,96 @@
+#include "EncodedChunksCache.hpp"
+
+#include "Chunk.hpp"
+#include "compressed_chunks.hpp"
+
+EncodedChunksCache::EncodedChunksCache(size_t capacity) : capacity(capacity) {
+}
+
+EncodedChunksCache::Payload EncodedChunksCache::get(
+    int x, int z, uint64_t version
+) {
+    std::lock_guard lock(mutex);
+    const auto& found = map.find({x, z});
+    if (found == map.end()) {
+        misses++;
+        return nullptr;
+    }
+    auto iter = found->second;
+    if (iter->version != version) {
+        entries.erase(iter);
+        map.erase(found);
+        misses++;
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, iter);
+    hits++;
+    return iter->payload;
+}
+
+void EncodedChunksCache::put(
+    int x, int z, uint64_t version, Payload payload
+) {
+    std::lock_guard lock(mutex);
+    glm::ivec2 pos(x, z);
+    const auto& found = map.find(pos);
+    if (found != map.end()) {
+        auto iter = found->second;
+        // chunk may be encoded by other thread concurrently
+        if (iter->version > version) {
+            return;
+        }
+        iter->version = version;
+        iter->payload = std::move(payload);
+        entries.splice(entries.begin(), entries, iter);
+        return;
+    }
+    if (entries.size() >= capacity && !entries.empty()) {
+        map.erase(entries.back().pos);
+        entries.pop_back();
+    }
+    entries.push_front(Entry {pos, version, std::move(payload)});
+    map[pos] = entries.begin();
+}
+
+EncodedChunksCache::Payload EncodedChunksCache::fetch(const Chunk& chunk) {
+    uint64_t version = chunk.journal.getVersion();
+    if (auto payload = get(chunk.x, chunk.z, version)) {
+        return payload;
+    }
+    // encoding is done without lock
+    auto payload = std::make_shared<const std::vector<ubyte>>(
+        compressed_chunks::encode(chunk)
+    );
+    put(chunk.x, chunk.z, version, payload);
+    return payload;
+}
+
+void EncodedChunksCache::erase(int x, int z) {
+    std::lock_guard lock(mutex);
+    const auto& found = map.find({x, z});
+    if (found != map.end()) {
+        entries.erase(found->second);
+        map.erase(found);
+    }
+}
+
+void EncodedChunksCache::clear() {
+    std::lock_guard lock(mutex);
+    entries.clear();
+    map.clear();
+}
+
+size_t EncodedChunksCache::size() const {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+size_t EncodedChunksCache::getHits() const {
+    std::lock_guard lock(mutex);
+    return hits;
+}
+
+size_t EncodedChunksCache::getMisses() const {
+    std::lock_guard lock(mutex);
+    return misses;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "typedefs.hpp"
+
+class Chunk;
+
+/// @brief Bounded LRU cache of compressed chunks data (as produced by
+/// compressed_chunks::encode) keyed by chunk position and journal version.
+/// Thread-safe
+class EncodedChunksCache {
+public:
+    using Payload = std::shared_ptr<const std::vector<ubyte>>;
+private:
+    struct Entry {
+        glm::ivec2 pos;
+        uint64_t version;
+        Payload payload;
+    };
+    size_t capacity;
+    /// @brief Entries from the most recently used
+    std::list<Entry> entries;
+    std::unordered_map<glm::ivec2, std::list<Entry>::iterator> map;
+    mutable std::mutex mutex;
+    size_t hits = 0;
+    size_t misses = 0;
+public:
+    EncodedChunksCache(size_t capacity);
+
+    /// @return cached payload or nullptr if missing or outdated
+    Payload get(int x, int z, uint64_t version);
+
+    void put(int x, int z, uint64_t version, Payload payload);
+
+    /// @brief Get cached chunk payload or encode the chunk and cache it.
+    /// Chunk must not be modified while encoding
+    Payload fetch(const Chunk& chunk);
+
+    void erase(int x, int z);
+
+    void clear();
+
+    size_t size() const;
+
+    size_t getHits() const;
+    size_t getMisses() const;
+};
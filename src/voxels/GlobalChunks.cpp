@@ -1,10 +1,10 @@
 #include "GlobalChunks.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 #include "Block.hpp"
 #include "Chunk.hpp"
-#include "coders/json.hpp"
 #include "content/Content.hpp"
 #include "debug/Logger.hpp"
 #include "items/Inventories.hpp"
@@ -22,8 +22,13 @@
 
 static debug::Logger logger("chunks-storage");
 
+/// @brief Max number of compressed chunks data entries cached
+inline constexpr size_t ENCODED_CHUNKS_CACHE_CAPACITY = 512;
+
 GlobalChunks::GlobalChunks(Level& level)
-    : level(level), indices(*level.content.getIndices()) {
+    : level(level),
+      indices(*level.content.getIndices()),
+      encodedChunks(ENCODED_CHUNKS_CACHE_CAPACITY) {
     chunksMap.max_load_factor(CHUNKS_MAP_MAX_LOAD_FACTOR);
 }
 
@@ -115,6 +120,7 @@ std::shared_ptr<Chunk> GlobalChunks::create(int x, int z, bool lighting) {
 
         chunk->decode(voxelDataBuffer.get());
         check_voxels(indices, *chunk);
+        chunk->updateLightSources(indices);
 
         chunk->setBlockInventories(
             load_inventories(regions, *chunk, indices.blocks)
@@ -132,9 +138,17 @@ std::shared_ptr<Chunk> GlobalChunks::create(int x, int z, bool lighting) {
         }
     }
     if (chunk->lightmap) {
-        if (regions.getLights(chunk->x, chunk->z, voxelDataBuffer.get())) {
-            chunk->lightmap->decode(voxelDataBuffer.get());
-            chunk->flags.loadedLights = true;
+        auto lightsData = voxelDataBuffer.get();
+        if (auto size = regions.getLights(chunk->x, chunk->z, lightsData)) {
+            try {
+                chunk->flags.loadedBlockLights =
+                    chunk->lightmap->decode(lightsData, size);
+                chunk->flags.loadedLights = true;
+            } catch (const std::runtime_error& err) {
+                logger.error() << "chunk " << chunk->x << ", " << chunk->z
+                               << " lights: " << err.what();
+                chunk->lightmap->clear();
+            }
         }
     }
     chunk->blocksMetadata = regions.getBlocksData(chunk->x, chunk->z);
@@ -155,21 +169,29 @@ size_t GlobalChunks::size() const {
 
 void GlobalChunks::incref(Chunk* chunk) {
     auto key = reinterpret_cast<ptrdiff_t>(chunk);
-    const auto& found = refCounters.find(key);
-    if (found == refCounters.end()) {
-        refCounters[key] = 1;
+    const auto& found = interests.find(key);
+    if (found == interests.end()) {
+        interests[key] = ChunkInterest {1, activeChunks.size()};
+        activeChunks.push_back(chunk);
         return;
     }
-    found->second++;
+    found->second.references++;
 }
 
 void GlobalChunks::decref(Chunk* chunk) {
     auto key = reinterpret_cast<ptrdiff_t>(chunk);
-    const auto& found = refCounters.find(key);
-    if (found == refCounters.end()) {
+    const auto& found = interests.find(key);
+    if (found == interests.end()) {
         abort();
     }
-    if (--found->second == 0) {
+    if (--found->second.references == 0) {
+        // still needed chunk must be loaded again
+        for (const auto& [_, region] : regions) {
+            if (region.loading && region.contains(chunk->x, chunk->z)) {
+                loadQueueOutdated = true;
+                break;
+            }
+        }
         union {
             int pos[2];
             long long key;
@@ -181,9 +203,102 @@ void GlobalChunks::decref(Chunk* chunk) {
         if (onUnload) {
             onUnload(*chunk);
         }
+        encodedChunks.erase(chunk->x, chunk->z);
         chunksMap.erase(ekey.key);
-        refCounters.erase(found);
+
+        // swap-remove from active chunks list
+        size_t index = found->second.activeIndex;
+        Chunk* last = activeChunks.back();
+        activeChunks[index] = last;
+        activeChunks.pop_back();
+        if (last != chunk) {
+            interests[reinterpret_cast<ptrdiff_t>(last)].activeIndex = index;
+        }
+        interests.erase(found);
+    }
+}
+
+int GlobalChunks::getInterest(const Chunk* chunk) const {
+    const auto& found = interests.find(reinterpret_cast<ptrdiff_t>(chunk));
+    if (found == interests.end()) {
+        return 0;
+    }
+    return found->second.references;
+}
+
+bool GlobalChunks::setInterestRegion(
+    int64_t id, const InterestRegion& region
+) {
+    const auto& found = regions.find(id);
+    if (found != regions.end() && found->second == region) {
+        return false;
+    }
+    regions[id] = region;
+    loadQueueOutdated = true;
+    return true;
+}
+
+void GlobalChunks::removeInterestRegion(int64_t id) {
+    if (regions.erase(id)) {
+        loadQueueOutdated = true;
+    }
+}
+
+void GlobalChunks::buildLoadQueue() {
+    loadQueue.clear();
+    // index of each missing chunk request in the queue
+    std::unordered_map<glm::ivec2, size_t> requests;
+    for (const auto& [_, region] : regions) {
+        if (!region.loading) {
+            continue;
+        }
+        const auto& center = region.center;
+        int radius = std::ceil(std::sqrt(region.radiusSquared));
+        for (int z = center.y - radius; z <= center.y + radius; z++) {
+            for (int x = center.x - radius; x <= center.x + radius; x++) {
+                if (!region.contains(x, z)) {
+                    continue;
+                }
+                auto chunk = getChunk(x, z);
+                if (chunk && chunk->flags.ready) {
+                    continue;
+                }
+                int dx = x - center.x;
+                int dz = z - center.y;
+                ChunkRequest request {{x, z}, center, dx * dx + dz * dz};
+
+                const auto& found = requests.find(request.pos);
+                if (found == requests.end()) {
+                    requests[request.pos] = loadQueue.size();
+                    loadQueue.push_back(request);
+                } else if (request.distance <
+                           loadQueue[found->second].distance) {
+                    loadQueue[found->second] = request;
+                }
+            }
+        }
+    }
+    std::sort(
+        loadQueue.begin(),
+        loadQueue.end(),
+        [](const auto& a, const auto& b) { return a.distance > b.distance; }
+    );
+    loadQueueOutdated = false;
+}
+
+std::optional<GlobalChunks::ChunkRequest> GlobalChunks::nextToLoad() {
+    if (loadQueueOutdated) {
+        buildLoadQueue();
+    }
+    while (!loadQueue.empty()) {
+        auto request = loadQueue.back();
+        loadQueue.pop_back();
+        auto chunk = getChunk(request.pos.x, request.pos.y);
+        if (chunk == nullptr || !chunk->flags.ready) {
+            return request;
+        }
     }
+    return std::nullopt;
 }
 
 void GlobalChunks::save(Chunk* chunk) {
@@ -192,15 +307,12 @@ void GlobalChunks::save(Chunk* chunk) {
     }
     AABB aabb = chunk->getAABB();
     auto entities = level.entities->getAllInside(aabb);
-    auto root = dv::object();
-    root["data"] = level.entities->serialize(entities);
+    auto list = level.entities->serialize(entities);
     if (!entities.empty()) {
         chunk->flags.entities = true;
     }
     level.getWorld()->wfile->getRegions().put(
-        chunk,
-        chunk->flags.entities ? json::to_binary(root, true)
-                                : std::vector<ubyte>()
+        chunk, chunk->flags.entities ? list : dv::value(nullptr)
     );
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -9,6 +11,7 @@
 
 #include "voxel.hpp"
 #include "delegates.hpp"
+#include "EncodedChunksCache.hpp"
 
 class Chunk;
 class Level;
@@ -16,6 +19,50 @@ struct AABB;
 class ContentIndices;
 
 class GlobalChunks {
+public:
+    /// @brief Circle area of chunks needed by a player
+    struct InterestRegion {
+        /// @brief Position of the region center chunk
+        glm::ivec2 center;
+        /// @brief Squared radius of the region (in chunks)
+        int radiusSquared;
+        /// @brief Missing chunks of the region must be loaded
+        bool loading;
+
+        bool contains(int x, int z) const {
+            int dx = x - center.x;
+            int dz = z - center.y;
+            return dx * dx + dz * dz < radiusSquared;
+        }
+
+        bool operator==(const InterestRegion& other) const {
+            return center == other.center &&
+                   radiusSquared == other.radiusSquared &&
+                   loading == other.loading;
+        }
+
+        bool operator!=(const InterestRegion& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /// @brief Missing chunk of the loading interest regions union
+    struct ChunkRequest {
+        glm::ivec2 pos;
+        /// @brief Center of the nearest region requesting the chunk
+        glm::ivec2 center;
+        /// @brief Squared distance to the center
+        int distance;
+    };
+private:
+    /// @brief Interest of players and chunk views in a loaded chunk
+    struct ChunkInterest {
+        /// @brief Number of players (and other views) the chunk is shown to
+        int references;
+        /// @brief Index of the chunk in activeChunks
+        size_t activeIndex;
+    };
+
     static inline uint64_t keyfrom(int32_t x, int32_t z) {
         union {
             int32_t pos[2];
@@ -30,9 +77,18 @@ class GlobalChunks {
     const ContentIndices& indices;
     std::unordered_map<uint64_t, std::shared_ptr<Chunk>> chunksMap;
     std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> pinnedChunks;
-    std::unordered_map<ptrdiff_t, int> refCounters;
+    std::unordered_map<ptrdiff_t, ChunkInterest> interests;
+    /// @brief Unique chunks referenced at least once
+    std::vector<Chunk*> activeChunks;
+    std::unordered_map<int64_t, InterestRegion> regions;
+    /// @brief Missing chunks of the regions union, the nearest is the last
+    std::vector<ChunkRequest> loadQueue;
+    bool loadQueueOutdated = false;
+
+    void buildLoadQueue();
 
     consumer<Chunk&> onUnload;
+    EncodedChunksCache encodedChunks;
 public:
     GlobalChunks(Level& level);
     ~GlobalChunks() = default;
@@ -50,6 +106,35 @@ public:
     void incref(Chunk* chunk);
     void decref(Chunk* chunk);
 
+    /// @brief Get number of references to the chunk
+    /// (0 if chunk is not shown to anyone)
+    int getInterest(const Chunk* chunk) const;
+
+    /// @brief Get unique chunks shown to at least one player or view.
+    /// Order is not specified and changes when chunks are unloaded
+    const std::vector<Chunk*>& getActiveChunks() const {
+        return activeChunks;
+    }
+
+    /// @brief Set area of chunks needed by a player
+    /// @param id player id
+    /// @return true if the region has changed
+    bool setInterestRegion(int64_t id, const InterestRegion& region);
+
+    void removeInterestRegion(int64_t id);
+
+    const std::unordered_map<int64_t, InterestRegion>& getInterestRegions(
+    ) const {
+        return regions;
+    }
+
+    /// @brief Take the next missing chunk of the loading regions union.
+    /// Chunks are taken once per unique position, nearest to a region
+    /// center first. Queue is rebuilt only when regions change or a chunk
+    /// inside of them is unloaded
+    /// @return std::nullopt if all chunks of the regions are loaded
+    std::optional<ChunkRequest> nextToLoad();
+
     void erase(int x, int z);
 
     void save(Chunk* chunk);
@@ -67,6 +152,11 @@ public:
         return found->second.get();
     }
 
+    /// @brief Get compressed loaded chunks data cache
+    EncodedChunksCache& getEncodedChunks() {
+        return encodedChunks;
+    }
+
     const ContentIndices& getContentIndices() const {
         return indices;
     }
@@ -1,6 +1,11 @@
 #include "Pathfinding.hpp"
 
+#include <algorithm>
+
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
+#include "maths/voxmaths.hpp"
+#include "util/ThreadPool.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/GlobalChunks.hpp"
 #include "voxels/blocks_agent.hpp"
@@ -8,30 +13,151 @@
 
 inline constexpr float SQRT2 = 1.4142135623730951f;  // sqrt(2)
 
+/// @brief Blocks around start and target points included in the first
+/// snapshot. Searches leaving it are repeated with a wider one
+inline constexpr int SNAPSHOT_MARGIN = CHUNK_W;
+/// @brief Snapshot margin multiplier used for repeated searches
+inline constexpr int SNAPSHOT_MARGIN_GROWTH = 4;
+/// @brief Updates number after which unused chunk copy is released
+inline constexpr uint64_t SNAPSHOT_CHUNK_LIFETIME = 600;
+
 using namespace voxels;
 
-static float heuristic(const glm::ivec3& a, const glm::ivec3& b) {
-    return glm::distance(glm::vec3(a), glm::vec3(b));
+namespace voxels {
+    struct PathfindingJob {
+        int agentId;
+        uint64_t request;
+        Agent agent;
+        std::shared_ptr<ChunksSnapshot> snapshot;
+        int margin;
+    };
+
+    struct PathfindingResult {
+        int agentId;
+        uint64_t request;
+        Route route;
+        int margin;
+        bool exceeded;
+    };
+
+    struct SearchNode {
+        glm::ivec3 pos;
+        /// @brief Parent node index or -1
+        int parent;
+        float gScore;
+        bool closed;
+    };
+
+    struct HeapEntry {
+        float fScore;
+        int node;
+    };
+
+    struct HeapEntryLess {
+        bool operator()(const HeapEntry& l, const HeapEntry& r) const {
+            return l.fScore > r.fScore;
+        }
+    };
+
+    /// @brief Search nodes storage reused between searches. Nodes are stored
+    /// in a flat array indexed by an open addressing hash table
+    class SearchBuffers {
+        std::vector<int> table;
+        size_t mask = 0;
+
+        static size_t hash(const glm::ivec3& pos) {
+            return static_cast<size_t>(pos.x) * 73856093 ^
+                   static_cast<size_t>(pos.y) * 19349663 ^
+                   static_cast<size_t>(pos.z) * 83492791;
+        }
+
+        void rehash(size_t capacity) {
+            table.assign(capacity, -1);
+            mask = capacity - 1;
+            for (size_t i = 0; i < nodes.size(); i++) {
+                size_t slot = hash(nodes[i].pos) & mask;
+                while (table[slot] != -1) {
+                    slot = (slot + 1) & mask;
+                }
+                table[slot] = i;
+            }
+        }
+    public:
+        std::vector<SearchNode> nodes;
+        std::vector<HeapEntry> heap;
+
+        void reset(size_t expectedNodes) {
+            nodes.clear();
+            heap.clear();
+            size_t capacity = 64;
+            while (capacity < expectedNodes * 2) {
+                capacity *= 2;
+            }
+            if (table.size() > capacity * 4 || table.size() < capacity) {
+                table.assign(capacity, -1);
+                mask = capacity - 1;
+            } else {
+                std::fill(table.begin(), table.end(), -1);
+            }
+        }
+
+        /// @return node index or -1
+        int find(const glm::ivec3& pos) const {
+            size_t slot = hash(pos) & mask;
+            while (table[slot] != -1) {
+                if (nodes[table[slot]].pos == pos) {
+                    return table[slot];
+                }
+                slot = (slot + 1) & mask;
+            }
+            return -1;
+        }
+
+        int add(const SearchNode& node) {
+            if ((nodes.size() + 1) * 2 > table.size()) {
+                rehash(table.size() * 2);
+            }
+            int index = nodes.size();
+            nodes.push_back(node);
+            size_t slot = hash(node.pos) & mask;
+            while (table[slot] != -1) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = index;
+            return index;
+        }
+
+        void push(float fScore, int node) {
+            heap.push_back({fScore, node});
+            std::push_heap(heap.begin(), heap.end(), HeapEntryLess());
+        }
+
+        int pop() {
+            std::pop_heap(heap.begin(), heap.end(), HeapEntryLess());
+            int node = heap.back().node;
+            heap.pop_back();
+            return node;
+        }
+    };
 }
 
-Pathfinding::Pathfinding(const Level& level)
-    : level(level),
-      chunks(*level.chunks),
-      blockDefs(level.content.getIndices()->blocks) {
+static float heuristic(const glm::ivec3& a, const glm::ivec3& b) {
+    return glm::distance(glm::vec3(a), glm::vec3(b));
 }
 
+template <class Storage>
 static bool check_passability(
     const Agent& agent,
-    const GlobalChunks& chunks,
-    const Node& node,
+    const Storage& chunks,
+    const glm::ivec3& nodePos,
     const glm::ivec2& offset,
     bool diagonal
 ) {
     if (!diagonal) {
         return true;
     }
-    auto a = node.pos + glm::ivec3(offset.x, 0, 0);
-    auto b = node.pos + glm::ivec3(0, 0, offset.y);
+    auto a = nodePos + glm::ivec3(offset.x, 0, 0);
+    auto b = nodePos + glm::ivec3(0, 0, offset.y);
 
     for (int i = 0; i < agent.height; i++) {
         if (blocks_agent::is_obstacle_at(chunks, a.x, a.y + i, a.z))
@@ -42,108 +168,123 @@ static bool check_passability(
     return true;
 }
 
-static void restore_route(
-    Route& route,
-    const glm::ivec3& lastPos,
-    const std::unordered_map<glm::ivec3, Node>& parents
+enum Passability {
+    NON_PASSABLE = -1,
+    OBSTACLE = 0,
+    PASSABLE = 1,
+};
+
+template <class Storage>
+static int check_point(
+    const Agent& agent,
+    const Storage& chunks,
+    int x, int y, int z,
+    int& cost
 ) {
-    auto pos = lastPos;
-    while (true) {
-        const auto& found = parents.find(pos);
-        if (found == parents.end()) {
-            route.nodes.push_back({pos});
-            break;
-        }
-        route.nodes.push_back({pos});
-        pos = found->second.pos;
+    auto vox = blocks_agent::get(chunks, x, y, z);
+    if (vox == nullptr) {
+        return OBSTACLE;
     }
-}
-
-int Pathfinding::createAgent() {
-    int id = nextAgent++;
-    agents[id] = Agent();
-    return id;
-}
-
-bool Pathfinding::removeAgent(int id) {
-    auto found = agents.find(id);
-    if (found != agents.end()) {
-        agents.erase(found);
-        return true;
+    const auto& def = chunks.getContentIndices().blocks.require(vox->id);
+    if (def.obstacle) {
+        return OBSTACLE;
     }
-    return false;
+    for (const auto& pair : agent.avoidTags) {
+        if (def.rt.tags.find(pair.first) != def.rt.tags.end()) {
+            cost = pair.second;
+            return NON_PASSABLE;
+        }
+    }
+    return PASSABLE;
 }
 
-void Pathfinding::performAllAsync(int stepsPerAgent) {
-    for (auto& [_, agent] : agents) {
-        if (agent.state.finished) {
-            continue;
+template <class Storage>
+static int get_surface_at(
+    const Agent& agent,
+    const Storage& chunks,
+    const glm::ivec3& pos,
+    float& cost
+) {
+    int status;
+    int surface = pos.y;
+    int ncost = 0;
+    if ((status = check_point(agent, chunks, pos.x, surface, pos.z, ncost)) ==
+        OBSTACLE) {
+        if ((status = check_point(
+                 agent, chunks, pos.x, surface + 1, pos.z, ncost
+             )) == OBSTACLE) {
+            return NON_PASSABLE;
+        } else if (status == NON_PASSABLE) {
+            cost += 5;
         }
-        perform(agent, stepsPerAgent);
+        cost += ncost;
+        return surface + 1;
+    } else {
+        if (status == NON_PASSABLE) {
+            cost += 5;
+        }
+        if ((status = check_point(
+                 agent, chunks, pos.x, surface - 1, pos.z, ncost
+             )) == OBSTACLE) {
+            cost += ncost;
+            return surface;
+        } else if (status == NON_PASSABLE) {
+            cost += 5;
+        }
+        if ((status = check_point(
+                 agent, chunks, pos.x, surface - 2, pos.z, ncost
+             )) == OBSTACLE) {
+            cost += ncost;
+            return surface - 1;
+        }
+        return NON_PASSABLE;
     }
+    return NON_PASSABLE;
 }
 
-static Route finish_route(Agent& agent, State&& state) {
+static Route finish_route(
+    const Agent& agent, const SearchBuffers& buffers, int nearest, int visited
+) {
     Route route {};
-    restore_route(route, state.nearest, state.parents);
-    route.totalVisited = state.blocked.size();
+    for (int index = nearest; index != -1;
+         index = buffers.nodes[index].parent) {
+        route.nodes.push_back({buffers.nodes[index].pos});
+    }
+    route.totalVisited = visited;
     route.nodes.push_back({agent.start});
     route.found = true;
-    state.finished = true;
-    agent.state = std::move(state);
-    agent.route = route;
     return route;
 }
 
-enum Passability {
-    NON_PASSABLE = -1,
-    OBSTACLE = 0,
-    PASSABLE = 1,
-};
-
-Route Pathfinding::perform(Agent& agent, int maxVisited) {
-    using namespace blocks_agent;
-
-    State state = std::move(agent.state);
-    if (state.queue.empty()) {
-        state.queue.push(
-            {agent.start, {}, 0, heuristic(agent.start, agent.target)}
-        );
-    }
+/// @param chunks GlobalChunks or ChunksSnapshot
+template <class Storage>
+static Route find_route(
+    const Agent& agent, const Storage& chunks, SearchBuffers& buffers
+) {
+    // each visited node adds up to 8 neighbours
+    buffers.reset(std::max(agent.maxVisitedBlocks, 0) * 8 + 1);
 
-    const auto& chunks = *level.chunks;
     int height = std::max(agent.height, 1);
+    float minHScore = heuristic(agent.start, agent.target);
+    int nearest = buffers.add({agent.start, -1, 0, false});
+    buffers.push(minHScore, nearest);
+    int visited = 0;
 
-    if (state.nearest == glm::ivec3(0)) {
-        state.nearest = agent.start;
-        state.minHScore = heuristic(agent.start, agent.target);
-    }
-    int visited = -1;
-
-    while (!state.queue.empty()) {
-        if (state.blocked.size() == agent.maxVisitedBlocks) {
-            if (agent.mayBeIncomplete) {
-                return finish_route(agent, std::move(state));
-            }
+    while (!buffers.heap.empty()) {
+        if (visited == agent.maxVisitedBlocks) {
             break;
         }
-        visited++;
-        if (visited == maxVisited) {
-            state.finished = false;
-            agent.state = std::move(state);
-            return {};
-        }
-
-        auto node = state.queue.top();
-        state.queue.pop();
+        int nodeIndex = buffers.pop();
+        auto node = buffers.nodes[nodeIndex];
 
         if (node.pos.x == agent.target.x &&
             glm::abs((node.pos.y - agent.target.y) / height) == 0 &&
             node.pos.z == agent.target.z) {
-            return finish_route(agent, std::move(state));
+            break;
         }
 
-        state.blocked.emplace(node.pos);
+        buffers.nodes[nodeIndex].closed = true;
+        visited++;
         glm::ivec2 neighbors[8] {
             {0, 1},
             {1, 0},
@@ -159,9 +300,9 @@ Route Pathfinding::perform(Agent& agent, int maxVisited) {
             auto offset = neighbors[i];
             auto pos = node.pos;
 
-            float cost = glm::abs(node.pos.y - pos.y) * 10;
-            int surface = getSurfaceAt(
-                agent, pos + glm::ivec3(offset.x, 0, offset.y), 1, cost
+            float cost = 0.0f;
+            int surface = get_surface_at(
+                agent, chunks, pos + glm::ivec3(offset.x, 0, offset.y), cost
             );
 
             if (surface == NON_PASSABLE) {
@@ -169,101 +310,224 @@ Route Pathfinding::perform(Agent& agent, int maxVisited) {
             }
             pos.y = surface;
             auto point = pos + glm::ivec3(offset.x, 0, offset.y);
-            if (state.blocked.find(point) != state.blocked.end()) {
+            int found = buffers.find(point);
+            if (found != -1 && buffers.nodes[found].closed) {
                 continue;
             }
 
-            if (is_obstacle_at(
+            if (blocks_agent::is_obstacle_at(
                     chunks, pos.x, pos.y + agent.jumpHeight, pos.z
                 )) {
                 continue;
             }
-            if (!check_passability(agent, chunks, node, offset, i >= 4)) {
+            if (!check_passability(agent, chunks, node.pos, offset, i >= 4)) {
+                continue;
+            }
+            if (found != -1) {
                 continue;
             }
-
             float sum = glm::abs(offset.x) + glm::abs(offset.y);
             float gScore = node.gScore + sum + cost;
-            const auto& found = state.parents.find(point);
-            if (found == state.parents.end()) {
-                float hScore = heuristic(point, agent.target);
-                if (hScore < state.minHScore) {
-                    state.minHScore = hScore;
-                    state.nearest = point;
-                }
-                float fScore = gScore * 0.75f + hScore;
-                Node nNode {point, node.pos, gScore, fScore};
-                state.parents[point] = node;
-                state.queue.push(nNode);
+            float hScore = heuristic(point, agent.target);
+            float fScore = gScore * 0.75f + hScore;
+            int index = buffers.add({point, nodeIndex, gScore, false});
+            if (hScore < minHScore) {
+                minHScore = hScore;
+                nearest = index;
             }
+            buffers.push(fScore, index);
         }
     }
-    state.finished = true;
-    agent.state = std::move(state);
-    return finish_route(agent, std::move(agent.state));
+    return finish_route(agent, buffers, nearest, visited);
 }
 
-Agent* Pathfinding::getAgent(int id) {
-    const auto& found = agents.find(id);
-    if (found != agents.end()) {
-        return &found->second;
+class PathfindingWorker
+    : public util::Worker<PathfindingJob, PathfindingResult> {
+    SearchBuffers buffers;
+public:
+    PathfindingResult operator()(const PathfindingJob& job) override {
+        auto route = find_route(job.agent, *job.snapshot, buffers);
+        return PathfindingResult {
+            job.agentId,
+            job.request,
+            std::move(route),
+            job.margin,
+            job.snapshot->isExceeded()};
     }
-    return nullptr;
+};
+
+ChunksSnapshot::ChunksSnapshot(
+    const ContentIndices& indices, glm::ivec2 min, glm::ivec2 max
+)
+    : indices(indices), min(min), max(max) {
 }
 
-const std::unordered_map<int, Agent>& Pathfinding::getAgents() const {
-    return agents;
+void ChunksSnapshot::putChunk(std::shared_ptr<Chunk> chunk) {
+    glm::ivec2 pos(chunk->x, chunk->z);
+    chunks[pos] = std::move(chunk);
 }
 
-int Pathfinding::checkPoint(const Agent& agent, int x, int y, int z, int& cost) {
-    auto vox = blocks_agent::get(chunks, x, y, z);
-    if (vox == nullptr) {
-        return OBSTACLE;
+Chunk* ChunksSnapshot::getChunk(int cx, int cz) const {
+    if (cx < min.x || cz < min.y || cx > max.x || cz > max.y) {
+        exceeded = true;
+        return nullptr;
     }
-    const auto& def = blockDefs.require(vox->id);
-    if (def.obstacle) {
-        return OBSTACLE;
+    const auto& found = chunks.find({cx, cz});
+    if (found == chunks.end()) {
+        return nullptr;
     }
-    for (const auto& pair : agent.avoidTags) {
-        if (def.rt.tags.find(pair.first) != def.rt.tags.end()) {
-            cost = pair.second;
-            return NON_PASSABLE;
-        }
+    return found->second.get();
+}
+
+Pathfinding::Pathfinding(const Level& level)
+    : level(level),
+      chunks(*level.chunks),
+      buffers(std::make_unique<SearchBuffers>()) {
+}
+
+Pathfinding::~Pathfinding() = default;
+
+int Pathfinding::createAgent() {
+    int id = nextAgent++;
+    agents[id] = Agent();
+    return id;
+}
+
+bool Pathfinding::removeAgent(int id) {
+    auto found = agents.find(id);
+    if (found != agents.end()) {
+        agents.erase(found);
+        return true;
     }
-    return PASSABLE;
+    return false;
 }
 
-int Pathfinding::getSurfaceAt(
-    const Agent& agent, const glm::ivec3& pos, int maxDelta, float& cost
+/// @brief Distance (blocks) from the start the search may reach: route
+/// can not be longer than visited blocks number, neighbours of the last
+/// visited node are checked too
+static int get_search_radius(const Agent& agent) {
+    return std::max(agent.maxVisitedBlocks, 0) + 2;
+}
+
+std::shared_ptr<ChunksSnapshot> Pathfinding::createSnapshot(
+    const Agent& agent, int margin
 ) {
-    using namespace blocks_agent;
+    int radius = get_search_radius(agent);
+    auto min = glm::max(
+        glm::min(agent.start, agent.target) - margin, agent.start - radius
+    );
+    auto max = glm::min(
+        glm::max(agent.start, agent.target) + margin, agent.start + radius
+    );
+    int minX = floordiv<CHUNK_W>(min.x);
+    int minZ = floordiv<CHUNK_D>(min.z);
+    int maxX = floordiv<CHUNK_W>(max.x);
+    int maxZ = floordiv<CHUNK_D>(max.z);
 
-    int status;
-    int surface = pos.y;
-    int ncost = 0;
-    if ((status = checkPoint(agent, pos.x, surface, pos.z, ncost)) == OBSTACLE) {
-        if ((status = checkPoint(agent, pos.x, surface + 1, pos.z, ncost)) == OBSTACLE) {
-            return NON_PASSABLE;
-        } else if (status == NON_PASSABLE) {
-            cost += 5;
-        }
-        cost += ncost;
-        return surface + 1;
-    } else {
-        if (status == NON_PASSABLE) {
-            cost += 5;
-        }
-        if ((status = checkPoint(agent, pos.x, surface - 1, pos.z, ncost)) == OBSTACLE) {
-            cost += ncost;
-            return surface;
-        } else if (status == NON_PASSABLE) {
-            cost += 5;
+    auto snapshot = std::make_shared<ChunksSnapshot>(
+        chunks.getContentIndices(),
+        glm::ivec2(minX, minZ),
+        glm::ivec2(maxX, maxZ)
+    );
+    for (int cz = minZ; cz <= maxZ; cz++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            auto chunk = chunks.getChunk(cx, cz);
+            if (chunk == nullptr) {
+                continue;
+            }
+            uint64_t version = chunk->journal.getVersion();
+            auto& entry = snapshotChunks[{cx, cz}];
+            if (entry.chunk == nullptr || entry.version != version) {
+                // chunk copy may still be used by a worker
+                entry.chunk = std::make_shared<Chunk>(cx, cz);
+                std::copy(
+                    std::begin(chunk->voxels),
+                    std::end(chunk->voxels),
+                    entry.chunk->voxels
+                );
+                entry.version = version;
+            }
+            entry.lastUse = updates;
+            snapshot->putChunk(entry.chunk);
         }
-        if ((status = checkPoint(agent, pos.x, surface - 2, pos.z, ncost)) == OBSTACLE) {
-            cost += ncost;
-            return surface - 1;
+    }
+    return snapshot;
+}
+
+void Pathfinding::performAsync(int id) {
+    auto agent = getAgent(id);
+    if (agent == nullptr) {
+        return;
+    }
+    if (pool == nullptr) {
+        pool = std::make_unique<
+            util::ThreadPool<PathfindingJob, PathfindingResult>>(
+            "pathfinding-pool",
+            []() { return std::make_shared<PathfindingWorker>(); },
+            [this](PathfindingResult& result) {
+                auto agent = getAgent(result.agentId);
+                if (agent == nullptr || agent->request != result.request) {
+                    return;
+                }
+                // search left the snapshot area: repeat it with a wider
+                // one until it's as large as the search may reach
+                if (result.exceeded &&
+                    result.margin < get_search_radius(*agent)) {
+                    enqueueSearch(
+                        result.agentId,
+                        *agent,
+                        result.margin * SNAPSHOT_MARGIN_GROWTH
+                    );
+                    return;
+                }
+                agent->route = std::move(result.route);
+                agent->searching = false;
+            },
+            util::ThreadPool<PathfindingJob, PathfindingResult>::QUARTER
+        );
+    }
+    agent->searching = true;
+    agent->request++;
+    enqueueSearch(id, *agent, SNAPSHOT_MARGIN);
+}
+
+void Pathfinding::enqueueSearch(int id, Agent& agent, int margin) {
+    PathfindingJob job {
+        id, agent.request, agent, createSnapshot(agent, margin), margin};
+    job.agent.route = {};
+    pool->enqueueJob(std::move(job));
+}
+
+void Pathfinding::update() {
+    debug::ProfileZone zone("Pathfinding::update");
+    updates++;
+    if (pool) {
+        pool->update();
+    }
+    for (auto it = snapshotChunks.begin(); it != snapshotChunks.end();) {
+        if (updates - it->second.lastUse > SNAPSHOT_CHUNK_LIFETIME) {
+            it = snapshotChunks.erase(it);
+        } else {
+            ++it;
         }
-        return NON_PASSABLE;
     }
-    return NON_PASSABLE;
+}
+
+Route Pathfinding::perform(Agent& agent) {
+    debug::ProfileZone zone("Pathfinding::perform");
+    // main thread reads chunks directly, no snapshot needed
+    agent.route = find_route(agent, chunks, *buffers);
+    return agent.route;
+}
+
+Agent* Pathfinding::getAgent(int id) {
+    const auto& found = agents.find(id);
+    if (found != agents.end()) {
+        return &found->second;
+    }
+    return nullptr;
+}
+
+const std::unordered_map<int, Agent>& Pathfinding::getAgents() const {
+    return agents;
 }
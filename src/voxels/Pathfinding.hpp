@@ -5,20 +5,21 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <memory>
-#include <queue>
 #include <set>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "typedefs.hpp"
 
-class Block;
+class Chunk;
 class Level;
 class GlobalChunks;
+class ContentIndices;
 
-template <typename T, typename IdType>
-class ContentUnitIndices;
+namespace util {
+    template <class T, class R>
+    class ThreadPool;
+}
 
 namespace voxels {
     struct RouteNode {
@@ -31,28 +32,6 @@ namespace voxels {
         int totalVisited;
     };
 
-    struct Node {
-        glm::ivec3 pos;
-        glm::ivec3 parent;
-        float gScore;
-        float fScore;
-    };
-
-    struct NodeLess {
-        bool operator()(const Node& l, const Node& r) const {
-            return l.fScore > r.fScore;
-        }
-    };
-
-    struct State {
-        std::priority_queue<Node, std::vector<Node>, NodeLess> queue;
-        std::unordered_set<glm::ivec3> blocked;
-        std::unordered_map<glm::ivec3, Node> parents;
-        glm::ivec3 nearest;
-        float minHScore;
-        bool finished = true;
-    };
-
     struct Agent {
         bool enabled = false;
         bool mayBeIncomplete = true;
@@ -62,36 +41,95 @@ namespace voxels {
         glm::ivec3 start;
         glm::ivec3 target;
         Route route;
-        State state {};
+        /// @brief Background search is in progress
+        bool searching = false;
+        /// @brief Last background search id. Results of previous ones
+        /// are dropped
+        uint64_t request = 0;
         std::set<std::pair<int, int>> avoidTags;
     };
 
+    /// @brief Immutable copy of chunks voxels in an area. Chunks may be
+    /// read from any thread, a snapshot is used by a single search
+    class ChunksSnapshot {
+        const ContentIndices& indices;
+        std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> chunks;
+        /// @brief Area of chunks included (loaded ones)
+        glm::ivec2 min;
+        glm::ivec2 max;
+        /// @brief A chunk outside of the area was requested
+        mutable bool exceeded = false;
+    public:
+        ChunksSnapshot(
+            const ContentIndices& indices, glm::ivec2 min, glm::ivec2 max
+        );
+
+        void putChunk(std::shared_ptr<Chunk> chunk);
+
+        /// @return chunk or nullptr if chunk is not loaded or is outside
+        /// of the snapshot area (see isExceeded)
+        Chunk* getChunk(int cx, int cz) const;
+
+        /// @return true if search requested chunks outside of the area,
+        /// so its result may differ from a search over loaded chunks
+        bool isExceeded() const {
+            return exceeded;
+        }
+
+        const ContentIndices& getContentIndices() const {
+            return indices;
+        }
+    };
+
+    class SearchBuffers;
+    struct PathfindingJob;
+    struct PathfindingResult;
+
     class Pathfinding {
     public:
         Pathfinding(const Level& level);
+        ~Pathfinding();
 
         int createAgent();
 
         bool removeAgent(int id);
 
-        void performAllAsync(int stepsPerAgent);
+        /// @brief Start agent route search on a worker thread.
+        /// The search uses chunks state at the moment of the call
+        void performAsync(int id);
+
+        /// @brief Apply finished background searches results
+        void update();
 
-        Route perform(Agent& agent, int maxVisited = -1);
+        /// @brief Find agent route on the current thread
+        Route perform(Agent& agent);
 
         Agent* getAgent(int id);
 
         const std::unordered_map<int, Agent>& getAgents() const;
     private:
+        struct SnapshotEntry {
+            uint64_t version;
+            uint64_t lastUse;
+            std::shared_ptr<Chunk> chunk;
+        };
+
         const Level& level;
         const GlobalChunks& chunks;
-        const ContentUnitIndices<Block, blockid_t>& blockDefs;
         std::unordered_map<int, Agent> agents;
         int nextAgent = 1;
-
-        int getSurfaceAt(
-            const Agent& agent, const glm::ivec3& pos, int maxDelta, float& cost
+        /// @brief Chunks copies reused by snapshots while chunks are
+        /// not modified
+        std::unordered_map<glm::ivec2, SnapshotEntry> snapshotChunks;
+        uint64_t updates = 0;
+        std::unique_ptr<SearchBuffers> buffers;
+        std::unique_ptr<util::ThreadPool<PathfindingJob, PathfindingResult>>
+            pool;
+
+        /// @param margin blocks around start and target points included
+        std::shared_ptr<ChunksSnapshot> createSnapshot(
+            const Agent& agent, int margin
         );
-
-        int checkPoint(const Agent& agent, int x, int y, int z, int& cost);
+        void enqueueSearch(int id, Agent& agent, int margin);
     };
 }
@@ -110,6 +110,9 @@ static void finalize_block(
     if (def.inventorySize != 0) {
         chunk.removeBlockInventory(lx, y, lz);
     }
+    if (def.rt.emissive) {
+        chunk.removeLightSource(index);
+    }
     if (def.rt.extended && !vox.state.segment) {
         erase_segments(chunks, def, vox.state, x, y, z);
     }
@@ -146,6 +149,10 @@ static void initialize_block(
     vox.id = id;
     vox.state = state;
     chunk.setModifiedAndUnsaved();
+    chunk.journal.record(vox_index(lx, y, lz));
+    if (def.rt.emissive) {
+        chunk.addLightSource(vox_index(lx, y, lz));
+    }
     if (!state.segment && def.rt.extended) {
         restore_segments(chunks, def, state, x, y, z);
     }
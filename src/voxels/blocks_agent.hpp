@@ -91,6 +91,27 @@ inline voxel& require(const Storage& chunks, int32_t x, int32_t y, int32_t z) {
     return *vox;
 }
 
+/// @brief Mark chunk modified after voxel state change made in place
+/// and record the change to the chunk journal.
+/// @tparam Storage chunks storage class
+/// @param chunks chunks storage
+/// @param x position X
+/// @param y position Y
+/// @param z position Z
+template<class Storage>
+inline void on_state_changed(
+    const Storage& chunks, int32_t x, int32_t y, int32_t z
+) {
+    int cx = floordiv<CHUNK_W>(x);
+    int cz = floordiv<CHUNK_D>(z);
+    Chunk* chunk = get_chunk(chunks, cx, cz);
+    if (chunk == nullptr || y < 0 || y >= CHUNK_H) {
+        return;
+    }
+    chunk->setModifiedAndUnsaved();
+    chunk->journal.record(vox_index(x - cx * CHUNK_W, y, z - cz * CHUNK_D));
+}
+
 template<class Storage>
 inline const Block& get_block_def(const Storage& chunks, blockid_t id) {
     return chunks.getContentIndices().blocks.require(id);
@@ -346,11 +367,7 @@ inline void set_rotation_extended(
                     set(chunks, pos.x, pos.y, pos.z, def.rt.id, segState);
                 } else {
                     vox->state = segState;
-                    int cx = floordiv<CHUNK_W>(pos.x);
-                    int cz = floordiv<CHUNK_D>(pos.z);
-                    auto chunk = get_chunk(chunks, cx, cz);
-                    assert(chunk != nullptr);
-                    chunk->setModifiedAndUnsaved();
+                    on_state_changed(chunks, pos.x, pos.y, pos.z);
                     segmentBlocks.emplace_back(pos);
                 }
             }
@@ -402,11 +419,7 @@ inline void set_rotation(
         set_rotation_extended(chunks, def, vox->state, origin, index);
     } else {
         vox->state.rotation = index;
-        int cx = floordiv<CHUNK_W>(x);
-        int cz = floordiv<CHUNK_D>(z);
-        auto chunk = get_chunk(chunks, cx, cz);
-        assert(chunk != nullptr);
-        chunk->setModifiedAndUnsaved();
+        on_state_changed(chunks, x, y, z);
     }
 }
 
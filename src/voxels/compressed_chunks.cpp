@@ -8,6 +8,7 @@
 
 inline constexpr int HAS_VOXELS = 0x1;
 inline constexpr int HAS_METADATA = 0x2;
+inline constexpr int IS_DELTA = 0x4;
 
 std::vector<ubyte> compressed_chunks::encode(
     const ubyte* data,
@@ -35,8 +36,7 @@ std::vector<ubyte> compressed_chunks::encode(
 std::vector<ubyte> compressed_chunks::encode(const Chunk& chunk) {
     auto data = chunk.encode();
 
-    /// world.get_chunk_data is only available in the main Lua state
-    static util::Buffer<ubyte> rleBuffer(CHUNK_DATA_LEN * 2);
+    thread_local util::Buffer<ubyte> rleBuffer(CHUNK_DATA_LEN * 2);
     return encode(data.get(), chunk.blocksMetadata, rleBuffer);
 }
 
@@ -58,8 +58,7 @@ void compressed_chunks::decode(
     reader.skip(1); // reserved byte
 
     if (flags & HAS_VOXELS) {
-        /// world.get_chunk_data is only available in the main Lua state
-        static util::Buffer<ubyte> voxelData (CHUNK_DATA_LEN);
+        thread_local util::Buffer<ubyte> voxelData (CHUNK_DATA_LEN);
         read_voxel_data(reader, voxelData);
         // TODO: move somewhere in Chunk
         auto src = reinterpret_cast<const uint16_t*>(voxelData.data());
@@ -75,6 +74,8 @@ void compressed_chunks::decode(
         }
         chunk.decode(voxelData.data());
         chunk.updateHeights();
+        chunk.updateLightSources(indices);
+        chunk.journal.reset();
     }
     if (flags & HAS_METADATA) {
         size_t metadataSize = reader.getInt32();
@@ -97,6 +98,8 @@ void compressed_chunks::save(
         regions.put(
             x, z, REGION_LAYER_VOXELS, voxelData.release(), CHUNK_DATA_LEN
         );
+        // cached lights do not match new voxels
+        regions.put(x, z, REGION_LAYER_LIGHTS, nullptr, 0);
     }
     if (flags & HAS_METADATA) {
         size_t metadataSize = reader.getInt32();
@@ -110,3 +113,81 @@ void compressed_chunks::save(
         reader.skip(metadataSize);
     }
 }
+
+/**
+  Delta format:
+    - byte-order: little-endian
+
+    ```
+    byte flags (IS_DELTA)
+    byte reserved
+    int64 version
+    varint changes count
+    changes (sorted by voxel index):
+        varint index delta (from the previous change index)
+        varint block id
+        varint block state
+    ```
+*/
+std::vector<ubyte> compressed_chunks::encode_delta(
+    const Chunk& chunk, uint64_t since
+) {
+    std::vector<uint> changed;
+    if (!chunk.journal.collectChanges(since, changed)) {
+        return {};
+    }
+    ByteBuilder builder(2 + 8 + 2 + changed.size() * 6);
+    builder.put(IS_DELTA); // flags
+    builder.put(0); // reserved
+    builder.putInt64(chunk.journal.getVersion());
+    builder.putVarInt(changed.size());
+    uint prevIndex = 0;
+    for (uint index : changed) {
+        const auto& vox = chunk.voxels[index];
+        builder.putVarInt(index - prevIndex);
+        builder.putVarInt(vox.id);
+        builder.putVarInt(blockstate2int(vox.state));
+        prevIndex = index;
+    }
+    return builder.build();
+}
+
+compressed_chunks::ChunkDelta compressed_chunks::decode_delta(
+    const ubyte* src, size_t size, const ContentIndices& indices
+) {
+    ByteReader reader(src, size);
+
+    ubyte flags = reader.get();
+    if (!(flags & IS_DELTA)) {
+        throw std::runtime_error("chunk delta expected");
+    }
+    reader.skip(1); // reserved byte
+
+    ChunkDelta delta {};
+    delta.version = reader.getInt64();
+    size_t count = reader.getVarInt();
+    if (count > CHUNK_VOL) {
+        throw std::runtime_error("invalid changes count");
+    }
+    delta.changes.reserve(count);
+    uint64_t index = 0;
+    for (size_t i = 0; i < count; i++) {
+        index += reader.getVarInt();
+        uint64_t id = reader.getVarInt();
+        uint64_t state = reader.getVarInt();
+        if (index >= CHUNK_VOL || id >= indices.blocks.count() ||
+            state > 0xFFFF) {
+            throw std::runtime_error(
+                "invalid voxel change at " + std::to_string(index)
+            );
+        }
+        delta.changes.push_back(VoxelChange {
+            static_cast<uint>(index),
+            voxel {
+                static_cast<blockid_t>(id),
+                int2blockstate(static_cast<blockstate_t>(state))
+            }
+        });
+    }
+    return delta;
+}
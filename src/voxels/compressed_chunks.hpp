@@ -10,6 +10,17 @@ class ContentIndices;
 class WorldRegions;
 
 namespace compressed_chunks {
+    struct VoxelChange {
+        uint index;
+        voxel vox;
+    };
+
+    struct ChunkDelta {
+        /// @brief Source chunk journal version
+        uint64_t version;
+        std::vector<VoxelChange> changes;
+    };
+
     std::vector<ubyte> encode(
         const ubyte* voxelData,
         const BlocksMetadata& metadata,
@@ -23,4 +34,13 @@ namespace compressed_chunks {
         const ContentIndices& indices
     );
     void save(int x, int z, std::vector<ubyte> bytes, WorldRegions& regions);
+
+    /// @brief Encode current state of voxels changed since the version
+    /// @return empty vector if the chunk journal does not cover the version
+    std::vector<ubyte> encode_delta(const Chunk& chunk, uint64_t since);
+
+    /// @throws std::runtime_error if the delta is invalid
+    ChunkDelta decode_delta(
+        const ubyte* src, size_t size, const ContentIndices& indices
+    );
 }
@@ -60,6 +60,17 @@ Level::Level(
     events->listen(LevelEventType::CHUNK_HIDDEN, [this](LevelEventType, Chunk* chunk) {
         chunks->decref(chunk);
     });
+    events->listen(LevelEventType::CHUNK_PRESENT, [this](LevelEventType, Chunk* chunk) {
+        // bodies at the chunk border may have been resting on missing chunk
+        entities->wakeUp(AABB(
+            glm::vec3(chunk->x * CHUNK_W - 1, -1, chunk->z * CHUNK_D - 1),
+            glm::vec3(
+                (chunk->x + 1) * CHUNK_W + 1,
+                CHUNK_H + 1,
+                (chunk->z + 1) * CHUNK_D + 1
+            )
+        ));
+    });
     chunks->setOnUnload([this](Chunk& chunk) {
         events->trigger(LevelEventType::CHUNK_UNLOAD, &chunk);
         AABB aabb = chunk.getAABB();
@@ -5,13 +5,17 @@
 #include <vector>
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "coders/json.hpp"
 #include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
 #include "coders/rle.hpp"
 #include "coders/binary_json.hpp"
 #include "items/Inventory.hpp"
 #include "maths/voxmaths.hpp"
+#include "util/Buffer.hpp"
 #include "util/data_io.hpp"
+#include "chunk_records.hpp"
 
 #define REGION_FORMAT_MAGIC ".VOXREG"
 
@@ -69,9 +73,13 @@ WorldRegions::WorldRegions(const io::path& directory) : directory(directory) {
     lights.folder = directory / "lights";
     lights.compression = compression::Method::EXTRLE8;
 
-    layers[REGION_LAYER_INVENTORIES].folder =
-        directory / "inventories";
-    layers[REGION_LAYER_ENTITIES].folder = directory / "entities";
+    auto& inventories = layers[REGION_LAYER_INVENTORIES];
+    inventories.folder = directory / "inventories";
+    inventories.compression = compression::Method::GZIP;
+
+    auto& entities = layers[REGION_LAYER_ENTITIES];
+    entities.folder = directory / "entities";
+    entities.compression = compression::Method::GZIP;
 
     auto& blocksData = layers[REGION_LAYER_BLOCKS_DATA];
     blocksData.folder = directory / "blocksdata";
@@ -120,39 +128,41 @@ void WorldRegions::put(
 static std::unique_ptr<ubyte[]> write_inventories(
     const ChunkInventoriesMap& inventories, uint32_t& datasize
 ) {
-    ByteBuilder builder;
-    builder.putInt32(inventories.size());
-    for (auto& entry : inventories) {
-        builder.putInt32(entry.first);
-        auto map = entry.second->serialize();
-        auto bytes = json::to_binary(map, true);
-        builder.putInt32(bytes.size());
-        builder.put(bytes.data(), bytes.size());
-    }
-    auto datavec = builder.data();
-    datasize = builder.size();
-    auto data = std::make_unique<ubyte[]>(datasize);
-    std::memcpy(data.get(), datavec, datasize);
-    return data;
+    auto bytes = chunk_records::encode_inventories(inventories);
+    datasize = bytes.size();
+    return util::Buffer<ubyte>(bytes.data(), bytes.size()).release();
 }
 
-static ChunkInventoriesMap load_inventories(const ubyte* src, uint32_t size) {
-    ChunkInventoriesMap inventories;
-    ByteReader reader(src, size);
-    auto count = reader.getInt32();
-    for (int i = 0; i < count; i++) {
-        uint index = reader.getInt32();
-        uint size = reader.getInt32();
-        auto map = json::from_binary(reader.pointer(), size);
-        reader.skip(size);
-        auto inv = std::make_shared<Inventory>(0, 0);
-        inv->deserialize(map);
-        inventories[index] = std::move(inv);
-    }
-    return inventories;
+/// @brief Decompress chunk data read from a regions layer.
+/// Inventories and entities layers records were stored uncompressed
+/// before, so gzip records are detected by magic number.
+static util::Buffer<ubyte> decompress_chunk_data(
+    const RegionsLayer& layer,
+    const ubyte* data,
+    uint32_t size,
+    uint32_t srcSize
+) {
+    switch (layer.compression) {
+        case compression::Method::NONE:
+            return util::Buffer<ubyte>(data, size);
+        case compression::Method::GZIP: {
+            if (size < 2 || data[0] != gzip::MAGIC[0] ||
+                data[1] != gzip::MAGIC[1]) {
+                return util::Buffer<ubyte>(data, size);
+            }
+            auto bytes = gzip::decompress(data, size);
+            return util::Buffer<ubyte>(bytes.data(), bytes.size());
+        }
+        default:
+            return util::Buffer<ubyte>(
+                compression::decompress(data, size, srcSize, layer.compression),
+                srcSize
+            );
+    }
 }
 
-void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
+void WorldRegions::put(Chunk* chunk, const dv::value& entities) {
+    debug::ProfileZone zone("WorldRegions::put");
     if (generatorTestMode) {
         return;
     }
@@ -160,7 +170,8 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
     if (!chunk->flags.lighted) {
         return;
     }
-    bool lightsUnsaved = !chunk->flags.loadedLights && doWriteLights;
+    bool lightsUnsaved = doWriteLights && (!chunk->flags.loadedBlockLights ||
+                                           chunk->flags.unsavedLights);
     if (!chunk->flags.unsaved && !lightsUnsaved && !chunk->flags.entities) {
         return;
     }
@@ -181,6 +192,9 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
             REGION_LAYER_LIGHTS,
             chunk->lightmap->encode(),
             LIGHTMAP_DATA_LEN);
+        // stored cache is complete and up to date now
+        chunk->flags.loadedBlockLights = true;
+        chunk->flags.unsavedLights = false;
     }
     // Writing block inventories
     if (!chunk->inventories.empty()) {
@@ -193,16 +207,13 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
             datasize);
     }
     // Writing entities
-    if (!entitiesData.empty()) {
-        auto data = std::make_unique<ubyte[]>(entitiesData.size());
-        for (size_t i = 0; i < entitiesData.size(); i++) {
-            data[i] = entitiesData[i];
-        }
+    if (entities != nullptr) {
+        auto bytes = chunk_records::encode_entities(entities);
         put(chunk->x,
             chunk->z,
             REGION_LAYER_ENTITIES,
-            std::move(data),
-            entitiesData.size());
+            util::Buffer<ubyte>(bytes.data(), bytes.size()).release(),
+            bytes.size());
     }
     // Writing blocks data
     if (chunk->flags.blocksData) {
@@ -216,6 +227,7 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
 }
 
 bool WorldRegions::getVoxels(int x, int z, ubyte* dst) {
+    debug::ProfileZone zone("WorldRegions::getVoxels");
     uint32_t size;
     uint32_t srcSize;
     auto& layer = layers[REGION_LAYER_VOXELS];
@@ -228,26 +240,33 @@ bool WorldRegions::getVoxels(int x, int z, ubyte* dst) {
     return true;
 }
 
-bool WorldRegions::getLights(int x, int z, ubyte* dst) {
+uint32_t WorldRegions::getLights(int x, int z, ubyte* dst) {
     uint32_t size;
     uint32_t srcSize;
     auto& layer = layers[REGION_LAYER_LIGHTS];
     auto* bytes = layer.getData(x, z, size, srcSize);
     if (bytes == nullptr) {
-        return false;
+        return 0;
+    }
+    if (srcSize > LIGHTMAP_DATA_LEN) {
+        logger.error() << "invalid lights data size " << srcSize
+                       << " (chunk: " << x << ", " << z << ")";
+        return 0;
     }
     compression::decompress({bytes, size}, dst, srcSize, layer.compression);
-    return true;
+    return srcSize;
 }
 
 ChunkInventoriesMap WorldRegions::fetchInventories(int x, int z) {
     uint32_t bytesSize;
     uint32_t srcSize;
-    auto bytes = layers[REGION_LAYER_INVENTORIES].getData(x, z, bytesSize, srcSize);
+    auto& layer = layers[REGION_LAYER_INVENTORIES];
+    auto bytes = layer.getData(x, z, bytesSize, srcSize);
     if (bytes == nullptr) {
         return {};
     }
-    return load_inventories(bytes, bytesSize);
+    auto data = decompress_chunk_data(layer, bytes, bytesSize, srcSize);
+    return chunk_records::decode_inventories(data.data(), data.size());
 }
 
 BlocksMetadata WorldRegions::getBlocksData(int x, int z) {
@@ -265,7 +284,8 @@ BlocksMetadata WorldRegions::getBlocksData(int x, int z) {
 void WorldRegions::processInventories(int x, int z, const InventoryProc& func) {
     processRegion(x, z, REGION_LAYER_INVENTORIES,
     [=](std::unique_ptr<ubyte[]> data, uint32_t* size) {
-        auto inventories = load_inventories(data.get(), *size);
+        auto inventories =
+            chunk_records::decode_inventories(data.get(), *size);
         for (const auto& [_, inventory] : inventories) {
             func(inventory.get());
         }
@@ -339,11 +359,13 @@ dv::value WorldRegions::fetchEntities(int x, int z) {
     }
     uint32_t bytesSize;
     uint32_t srcSize;
-    const ubyte* data = layers[REGION_LAYER_ENTITIES].getData(x, z, bytesSize, srcSize);
-    if (data == nullptr) {
+    auto& layer = layers[REGION_LAYER_ENTITIES];
+    const ubyte* bytes = layer.getData(x, z, bytesSize, srcSize);
+    if (bytes == nullptr) {
         return nullptr;
     }
-    auto map = json::from_binary(data, bytesSize);
+    auto data = decompress_chunk_data(layer, bytes, bytesSize, srcSize);
+    auto map = chunk_records::decode_entities(data.data(), data.size());
     if (map.empty()) {
         return nullptr;
     }
@@ -372,14 +394,10 @@ void WorldRegions::processRegion(
             if (data == nullptr) {
                 continue;
             }
-            if (layer.compression != compression::Method::NONE) {
-                data = compression::decompress(
-                    data.get(), length, srcSize, layer.compression
-                );
-            } else {
-                srcSize = length;
-            }
-            if (auto writeData = func(std::move(data), &srcSize)) {
+            auto decompressed =
+                decompress_chunk_data(layer, data.get(), length, srcSize);
+            srcSize = decompressed.size();
+            if (auto writeData = func(decompressed.release(), &srcSize)) {
                 put(gx, gz, layerid, std::move(writeData), srcSize);
             }
         }
@@ -395,6 +413,7 @@ io::path WorldRegions::getRegionFilePath(RegionLayerIndex layerid, int x, int z)
 }
 
 void WorldRegions::writeAll() {
+    debug::ProfileZone zone("WorldRegions::writeAll");
     for (auto& layer : layers) {
         io::create_directories(layer.folder);
         layer.writeAll();
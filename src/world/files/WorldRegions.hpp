@@ -190,7 +190,9 @@ public:
     ~WorldRegions();
 
     /// @brief Put all chunk data to regions
-    void put(Chunk* chunk, std::vector<ubyte> entitiesData);
+    /// @param chunk target chunk
+    /// @param entities serialized entities list or nullptr
+    void put(Chunk* chunk, const dv::value& entities);
 
     /// @brief Store data in specified region
     /// @param x chunk.x
@@ -213,8 +215,9 @@ public:
     bool getVoxels(int x, int z, ubyte* dst);
 
     /// @brief Get cached lights for chunk at x,z
-    /// @return true if data read
-    bool getLights(int x, int z, ubyte* dst);
+    /// @param dst destination buffer of LIGHTMAP_DATA_LEN bytes at least
+    /// @return read data length or 0 if there's no valid cached lights
+    uint32_t getLights(int x, int z, ubyte* dst);
     
     ChunkInventoriesMap fetchInventories(int x, int z);
 
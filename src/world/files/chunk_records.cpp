@@ -0,0 +1,493 @@
+#include "chunk_records.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
+#include "items/Inventory.hpp"
+#include "objects/Entity.hpp"
+
+using namespace chunk_records;
+
+enum EntityFlags {
+    ENTITY_TRANSFORM = 0x1,
+    ENTITY_RIGIDBODY = 0x2,
+    ENTITY_EXTRA = 0x4,
+};
+
+enum TransformFlags {
+    TRANSFORM_SIZE = 0x1,
+    TRANSFORM_ROT = 0x2,
+};
+
+enum RigidbodyFlags {
+    BODY_HAS_ENABLED = 0x1,
+    BODY_ENABLED = 0x2,
+    BODY_VEL = 0x4,
+    BODY_DAMPING = 0x8,
+    BODY_TYPE = 0x10,
+    BODY_HAS_CROUCH = 0x20,
+    BODY_CROUCH = 0x40,
+};
+
+static inline uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^
+           static_cast<uint64_t>(value >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static bool is_format_marker(const ubyte* src, size_t size) {
+    if (size < sizeof(int32_t) + 1) {
+        return false;
+    }
+    ByteReader reader(src, size);
+    return reader.getInt32() == FORMAT_MARKER;
+}
+
+static size_t get_count(ByteReader& reader) {
+    size_t count = reader.getVarInt();
+    // every element takes at least one byte
+    if (count > reader.remaining()) {
+        throw std::runtime_error("invalid elements count");
+    }
+    return count;
+}
+
+static void put_bjson(ByteBuilder& builder, const dv::value& value) {
+    auto bytes = json::to_binary(value);
+    builder.putVarInt(bytes.size());
+    builder.put(bytes.data(), bytes.size());
+}
+
+static dv::value get_bjson(
+    ByteReader& reader, const std::shared_ptr<dv::Arena>& arena = nullptr
+) {
+    size_t length = reader.getVarInt();
+    if (length > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    auto value = json::from_binary(reader.pointer(), length, arena);
+    reader.skip(length);
+    return value;
+}
+
+std::vector<ubyte> chunk_records::encode_inventories(
+    const ChunkInventoriesMap& inventories
+) {
+    std::vector<itemid_t> palette;
+    std::unordered_map<itemid_t, uint> paletteIndices;
+    for (const auto& [_, inventory] : inventories) {
+        for (size_t i = 0; i < inventory->size(); i++) {
+            const auto& stack = inventory->getSlot(i);
+            if (stack.isEmpty()) {
+                continue;
+            }
+            itemid_t id = stack.getItemId();
+            if (paletteIndices.find(id) == paletteIndices.end()) {
+                paletteIndices[id] = palette.size();
+                palette.push_back(id);
+            }
+        }
+    }
+    ByteBuilder builder;
+    builder.putInt32(FORMAT_MARKER);
+    builder.put(INVENTORIES_FORMAT_VERSION);
+
+    builder.putVarInt(palette.size());
+    for (itemid_t id : palette) {
+        builder.putVarInt(id);
+    }
+    builder.putVarInt(inventories.size());
+    for (const auto& [index, inventory] : inventories) {
+        builder.putVarInt(index);
+        builder.putVarInt(zigzag_encode(inventory->getId()));
+        builder.putVarInt(inventory->size());
+
+        size_t emptyRun = 0;
+        for (size_t i = 0; i < inventory->size(); i++) {
+            const auto& stack = inventory->getSlot(i);
+            if (stack.isEmpty()) {
+                emptyRun++;
+                continue;
+            }
+            if (emptyRun) {
+                builder.putVarInt(0);
+                builder.putVarInt(emptyRun);
+                emptyRun = 0;
+            }
+            uint64_t paletteIndex = paletteIndices[stack.getItemId()];
+            builder.putVarInt(((paletteIndex << 1) | stack.hasFields()) + 1);
+            builder.putVarInt(stack.getCount());
+            if (stack.hasFields()) {
+                put_bjson(builder, stack.getFields());
+            }
+        }
+        if (emptyRun) {
+            builder.putVarInt(0);
+            builder.putVarInt(emptyRun);
+        }
+    }
+    return builder.build();
+}
+
+static ChunkInventoriesMap decode_legacy_inventories(
+    const ubyte* src, size_t size
+) {
+    ChunkInventoriesMap inventories;
+    ByteReader reader(src, size);
+    auto count = reader.getInt32();
+    for (int i = 0; i < count; i++) {
+        uint index = reader.getInt32();
+        uint size = reader.getInt32();
+        if (size > reader.remaining()) {
+            throw std::runtime_error("buffer underflow");
+        }
+        const ubyte* data = reader.pointer();
+        reader.skip(size);
+
+        std::vector<ubyte> decompressed;
+        if (size >= 2 && data[0] == gzip::MAGIC[0] &&
+            data[1] == gzip::MAGIC[1]) {
+            decompressed = gzip::decompress(data, size);
+            data = decompressed.data();
+            size = decompressed.size();
+        }
+        json::BjsonReader bjson(data, size);
+        bjson.next();
+        auto inv = std::make_shared<Inventory>(0, 0);
+        inv->deserialize(bjson);
+        inventories[index] = std::move(inv);
+    }
+    return inventories;
+}
+
+ChunkInventoriesMap chunk_records::decode_inventories(
+    const ubyte* src, size_t size
+) {
+    if (!is_format_marker(src, size)) {
+        return decode_legacy_inventories(src, size);
+    }
+    ByteReader reader(src, size);
+    reader.skip(sizeof(int32_t));
+    ubyte version = reader.get();
+    if (version > INVENTORIES_FORMAT_VERSION) {
+        throw std::runtime_error(
+            "inventories format " + std::to_string(version) +
+            " is not supported"
+        );
+    }
+    std::vector<itemid_t> palette(get_count(reader));
+    for (size_t i = 0; i < palette.size(); i++) {
+        palette[i] = reader.getVarInt();
+    }
+    ChunkInventoriesMap inventories;
+    size_t count = get_count(reader);
+    for (size_t i = 0; i < count; i++) {
+        uint index = reader.getVarInt();
+        int64_t id = zigzag_decode(reader.getVarInt());
+        size_t slotsCount = reader.getVarInt();
+        if (slotsCount > reader.remaining() * 128) {
+            throw std::runtime_error("invalid inventory size");
+        }
+        auto inventory = std::make_shared<Inventory>(id, slotsCount);
+        size_t slot = 0;
+        while (slot < slotsCount) {
+            uint64_t tag = reader.getVarInt();
+            if (tag == 0) {
+                slot += reader.getVarInt();
+                continue;
+            }
+            tag--;
+            size_t paletteIndex = tag >> 1;
+            if (paletteIndex >= palette.size()) {
+                throw std::runtime_error("invalid item palette index");
+            }
+            itemcount_t itemsCount = reader.getVarInt();
+            dv::value fields = nullptr;
+            if (tag & 1) {
+                fields = get_bjson(reader);
+            }
+            inventory->getSlot(slot++).set(
+                ItemStack(palette[paletteIndex], itemsCount, std::move(fields))
+            );
+        }
+        inventories[index] = std::move(inventory);
+    }
+    return inventories;
+}
+
+static bool is_exact_float(const dv::value& value) {
+    if (!dv::is_numeric(value)) {
+        return false;
+    }
+    // float32 is used for storage, so keep exact values only
+    double number = value.asNumber();
+    return static_cast<double>(static_cast<float>(number)) == number;
+}
+
+static bool is_floats_list(const dv::value& list, size_t n) {
+    if (!list.isList() || list.size() != n) {
+        return false;
+    }
+    for (const auto& element : list) {
+        if (!is_exact_float(element)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void put_floats(ByteBuilder& builder, const dv::value& list) {
+    for (const auto& element : list) {
+        builder.putFloat32(element.asNumber());
+    }
+}
+
+static dv::value get_floats(
+    ByteReader& reader, size_t n, const std::shared_ptr<dv::Arena>& arena
+) {
+    auto list = dv::list(arena);
+    for (size_t i = 0; i < n; i++) {
+        list.add(reader.getFloat32());
+    }
+    return list;
+}
+
+namespace {
+    class StringsTable {
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint> indices;
+    public:
+        uint add(const std::string& string) {
+            const auto& found = indices.find(string);
+            if (found != indices.end()) {
+                return found->second;
+            }
+            uint index = strings.size();
+            indices[string] = index;
+            strings.push_back(string);
+            return index;
+        }
+
+        void write(ByteBuilder& builder) const {
+            builder.putVarInt(strings.size());
+            for (const auto& string : strings) {
+                builder.putVarInt(string.length());
+                builder.put(
+                    reinterpret_cast<const ubyte*>(string.data()),
+                    string.length()
+                );
+            }
+        }
+    };
+}
+
+static bool encode_transform(
+    ByteBuilder& builder, const dv::value& transform
+) {
+    if (!transform.isObject() || !transform.has("pos")) {
+        return false;
+    }
+    ubyte flags = 0;
+    for (const auto& [key, value] : transform.asObject()) {
+        if (key == "pos" && is_floats_list(value, 3)) {
+            continue;
+        } else if (key == "size" && is_floats_list(value, 3)) {
+            flags |= TRANSFORM_SIZE;
+        } else if (key == "rot" && is_floats_list(value, 9)) {
+            flags |= TRANSFORM_ROT;
+        } else {
+            return false;
+        }
+    }
+    builder.put(flags);
+    put_floats(builder, transform["pos"]);
+    if (flags & TRANSFORM_SIZE) {
+        put_floats(builder, transform["size"]);
+    }
+    if (flags & TRANSFORM_ROT) {
+        put_floats(builder, transform["rot"]);
+    }
+    return true;
+}
+
+static dv::value decode_transform(
+    ByteReader& reader, const std::shared_ptr<dv::Arena>& arena
+) {
+    ubyte flags = reader.get();
+    auto transform = dv::object(arena);
+    transform["pos"] = get_floats(reader, 3, arena);
+    if (flags & TRANSFORM_SIZE) {
+        transform["size"] = get_floats(reader, 3, arena);
+    }
+    if (flags & TRANSFORM_ROT) {
+        transform["rot"] = get_floats(reader, 9, arena);
+    }
+    return transform;
+}
+
+static bool encode_rigidbody(
+    ByteBuilder& builder, const dv::value& body, StringsTable& strings
+) {
+    if (!body.isObject()) {
+        return false;
+    }
+    ubyte flags = 0;
+    for (const auto& [key, value] : body.asObject()) {
+        if (key == "enabled" && value.isBoolean()) {
+            flags |= BODY_HAS_ENABLED | (value.asBoolean() ? BODY_ENABLED : 0);
+        } else if (key == "vel" && is_floats_list(value, 3)) {
+            flags |= BODY_VEL;
+        } else if (key == "damping" && is_exact_float(value)) {
+            flags |= BODY_DAMPING;
+        } else if (key == "type" && value.isString()) {
+            flags |= BODY_TYPE;
+        } else if (key == "crouch" && value.isBoolean()) {
+            flags |= BODY_HAS_CROUCH | (value.asBoolean() ? BODY_CROUCH : 0);
+        } else {
+            return false;
+        }
+    }
+    builder.put(flags);
+    if (flags & BODY_VEL) {
+        put_floats(builder, body["vel"]);
+    }
+    if (flags & BODY_DAMPING) {
+        builder.putFloat32(body["damping"].asNumber());
+    }
+    if (flags & BODY_TYPE) {
+        builder.putVarInt(strings.add(body["type"].asString()));
+    }
+    return true;
+}
+
+static dv::value decode_rigidbody(
+    ByteReader& reader,
+    const std::vector<std::string>& strings,
+    const std::shared_ptr<dv::Arena>& arena
+) {
+    ubyte flags = reader.get();
+    auto body = dv::object(arena);
+    if (flags & BODY_HAS_ENABLED) {
+        body["enabled"] = (flags & BODY_ENABLED) != 0;
+    }
+    if (flags & BODY_VEL) {
+        body["vel"] = get_floats(reader, 3, arena);
+    }
+    if (flags & BODY_DAMPING) {
+        body["damping"] = reader.getFloat32();
+    }
+    if (flags & BODY_TYPE) {
+        body["type"] = strings.at(reader.getVarInt());
+    }
+    if (flags & BODY_HAS_CROUCH) {
+        body["crouch"] = (flags & BODY_CROUCH) != 0;
+    }
+    return body;
+}
+
+std::vector<ubyte> chunk_records::encode_entities(const dv::value& entities) {
+    StringsTable strings;
+    ByteBuilder body;
+    body.putVarInt(entities.size());
+    for (const auto& entity : entities) {
+        const auto& def = entity["def"];
+        const auto& uid = entity["uid"];
+        if (!def.isString() || !uid.isInteger()) {
+            throw std::runtime_error("invalid entity data");
+        }
+        ByteBuilder components;
+        ubyte flags = 0;
+        if (auto transform = entity.at(COMP_TRANSFORM)) {
+            if (encode_transform(components, *transform)) {
+                flags |= ENTITY_TRANSFORM;
+            }
+        }
+        if (auto rigidbody = entity.at(COMP_RIGIDBODY)) {
+            if (encode_rigidbody(components, *rigidbody, strings)) {
+                flags |= ENTITY_RIGIDBODY;
+            }
+        }
+        // everything not covered by the schema is stored as bjson
+        auto extra = dv::object();
+        for (const auto& [key, value] : entity.asObject()) {
+            if (key == "def" || key == "uid" ||
+                (key == COMP_TRANSFORM && (flags & ENTITY_TRANSFORM)) ||
+                (key == COMP_RIGIDBODY && (flags & ENTITY_RIGIDBODY))) {
+                continue;
+            }
+            extra[key] = value;
+        }
+        if (!extra.empty()) {
+            flags |= ENTITY_EXTRA;
+        }
+        body.put(flags);
+        body.putVarInt(strings.add(def.asString()));
+        body.putVarInt(uid.asInteger());
+        body.put(components.data(), components.size());
+        if (flags & ENTITY_EXTRA) {
+            put_bjson(body, extra);
+        }
+    }
+    ByteBuilder builder;
+    builder.putInt32(FORMAT_MARKER);
+    builder.put(ENTITIES_FORMAT_VERSION);
+    strings.write(builder);
+    builder.put(body.data(), body.size());
+    return builder.build();
+}
+
+dv::value chunk_records::decode_entities(const ubyte* src, size_t size) {
+    // decoded tree is discarded after entities are spawned
+    auto arena = std::make_shared<dv::Arena>();
+    if (!is_format_marker(src, size)) {
+        return json::from_binary(src, size, arena);
+    }
+    ByteReader reader(src, size);
+    reader.skip(sizeof(int32_t));
+    ubyte version = reader.get();
+    if (version > ENTITIES_FORMAT_VERSION) {
+        throw std::runtime_error(
+            "entities format " + std::to_string(version) + " is not supported"
+        );
+    }
+    std::vector<std::string> strings(get_count(reader));
+    for (size_t i = 0; i < strings.size(); i++) {
+        size_t length = reader.getVarInt();
+        if (length > reader.remaining()) {
+            throw std::runtime_error("buffer underflow");
+        }
+        strings[i] = std::string(
+            reinterpret_cast<const char*>(reader.pointer()), length
+        );
+        reader.skip(length);
+    }
+    auto root = dv::object(arena);
+    auto& list = root.list("data");
+    size_t count = get_count(reader);
+    for (size_t i = 0; i < count; i++) {
+        ubyte flags = reader.get();
+        auto& entity = list.object();
+        entity["def"] = strings.at(reader.getVarInt());
+        entity["uid"] = static_cast<integer_t>(reader.getVarInt());
+        if (flags & ENTITY_TRANSFORM) {
+            entity[COMP_TRANSFORM] = decode_transform(reader, arena);
+        }
+        if (flags & ENTITY_RIGIDBODY) {
+            entity[COMP_RIGIDBODY] = decode_rigidbody(reader, strings, arena);
+        }
+        if (flags & ENTITY_EXTRA) {
+            auto extra = get_bjson(reader, arena);
+            for (const auto& [key, value] : extra.asObject()) {
+                entity[key] = value;
+            }
+        }
+    }
+    return root;
+}
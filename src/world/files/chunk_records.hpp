@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "data/dv.hpp"
+#include "typedefs.hpp"
+#include "voxels/Chunk.hpp"
+
+/// @brief Compact native encoding of inventories and entities region layers
+/// records. Records are stored uncompressed here, compression is applied
+/// once per chunk record by the regions layer.
+/// @see /doc/specs/chunk_records_spec.md
+namespace chunk_records {
+    /// @brief Marker used instead of legacy record inventories count /
+    /// legacy bjson document type byte
+    inline constexpr int32_t FORMAT_MARKER = -1;
+
+    inline constexpr ubyte INVENTORIES_FORMAT_VERSION = 1;
+    inline constexpr ubyte ENTITIES_FORMAT_VERSION = 1;
+
+    /// @brief Encode chunk block inventories
+    std::vector<ubyte> encode_inventories(
+        const ChunkInventoriesMap& inventories
+    );
+
+    /// @brief Decode chunk block inventories record.
+    /// Legacy records (per-inventory gzipped bjson) are supported too.
+    /// @param src record bytes (decompressed)
+    /// @param size record size
+    ChunkInventoriesMap decode_inventories(const ubyte* src, size_t size);
+
+    /// @brief Encode serialized entities list
+    /// @param entities list produced by Entities::serialize
+    std::vector<ubyte> encode_entities(const dv::value& entities);
+
+    /// @brief Decode chunk entities record.
+    /// Legacy bjson records are supported too.
+    /// @param src record bytes (decompressed)
+    /// @param size record size
+    /// @return map with entities list as "data"
+    dv::value decode_entities(const ubyte* src, size_t size);
+}
@@ -87,7 +87,8 @@ util::Buffer<ubyte> compatibility::convert_region_2to3(
             }
             case REGION_LAYER_LIGHTS:
                 builder.putInt32(size);
-                builder.putInt32(LIGHTMAP_DATA_LEN);
+                // version 1 lights store sky light only
+                builder.putInt32(LIGHTMAP_SKY_DATA_LEN);
                 builder.put(data, size);
                 break;
             case REGION_LAYER_ENTITIES:
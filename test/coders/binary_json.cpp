@@ -36,3 +36,86 @@ TEST(BJSON, EncodeDecode) {
         }
     }
 }
+
+TEST(BJSON, StreamingWriterReader) {
+    std::vector<ubyte> buffer;
+    json::BjsonWriter writer(buffer);
+    writer.beginObject();
+    writer.key("name");
+    writer.putString("chest");
+    writer.key("skipped");
+    writer.beginList();
+    writer.beginObject();
+    writer.key("nested");
+    writer.putInteger(-100000);
+    writer.end();
+    writer.putNull();
+    writer.end();
+    writer.key("slots");
+    writer.beginList();
+    for (int i = 0; i < 3; i++) {
+        writer.putInteger(i * 1000);
+    }
+    writer.end();
+    writer.key("score");
+    writer.putNumber(0.5);
+    writer.key("flag");
+    writer.putBoolean(true);
+    writer.end();
+    EXPECT_EQ(writer.depth(), 0);
+
+    auto object = json::from_binary(buffer.data(), buffer.size());
+    EXPECT_EQ(object["name"].asString(), "chest");
+    EXPECT_EQ(object["skipped"][0]["nested"].asInteger(), -100000);
+    EXPECT_EQ(object["slots"][2].asInteger(), 2000);
+    EXPECT_EQ(json::to_binary(object).size(), buffer.size());
+
+    using Token = json::BjsonReader::Token;
+    json::BjsonReader reader(buffer.data(), buffer.size());
+    ASSERT_EQ(reader.next(), Token::BEGIN_OBJECT);
+    std::vector<int> slots;
+    while (reader.next() != Token::END) {
+        auto key = reader.key();
+        if (key == "name") {
+            EXPECT_EQ(reader.getString(), "chest");
+        } else if (key == "skipped") {
+            reader.skip();
+            EXPECT_EQ(reader.depth(), 1);
+        } else if (key == "slots") {
+            while (reader.next() != Token::END) {
+                slots.push_back(reader.getInteger());
+            }
+        } else if (key == "score") {
+            EXPECT_EQ(reader.getNumber(), 0.5);
+        } else if (key == "flag") {
+            EXPECT_TRUE(reader.getBoolean());
+        }
+    }
+    EXPECT_EQ(slots, std::vector<int>({0, 1000, 2000}));
+    EXPECT_EQ(reader.next(), Token::END_OF_INPUT);
+}
+
+TEST(BJSON, WriterBufferReuse) {
+    auto object = dv::object();
+    object["id"] = 5;
+    object["name"] = "test";
+
+    std::vector<ubyte> buffer;
+    json::to_binary(object, buffer);
+    size_t size = buffer.size();
+    json::to_binary(object, buffer);
+    ASSERT_EQ(buffer.size(), size * 2);
+
+    auto second = json::from_binary(buffer.data() + size, size);
+    EXPECT_EQ(second["id"].asInteger(), 5);
+    EXPECT_EQ(second["name"].asString(), "test");
+}
+
+TEST(BJSON, ReaderTruncated) {
+    auto object = dv::object();
+    object["name"] = "truncated document";
+    auto bytes = json::to_binary(object);
+    EXPECT_THROW(
+        json::from_binary(bytes.data(), bytes.size() - 4), std::runtime_error
+    );
+}
@@ -18,3 +18,22 @@ TEST(byte_utils, BytesBuildAndRead) {
     EXPECT_EQ(reader.getInt32(), 123456789);
     EXPECT_EQ(reader.getInt64(), 98765432123456789LL);
 }
+
+TEST(byte_utils, VarInt) {
+    const uint64_t values[] {
+        0, 1, 127, 128, 300, 16383, 16384, UINT32_MAX, UINT64_MAX
+    };
+    ByteBuilder builder;
+    for (auto value : values) {
+        builder.putVarInt(value);
+    }
+    auto data = builder.build();
+    EXPECT_EQ(data[0], 0);
+    EXPECT_EQ(data[2], 127);
+
+    ByteReader reader(data.data(), data.size());
+    for (auto value : values) {
+        EXPECT_EQ(reader.getVarInt(), value);
+    }
+    EXPECT_FALSE(reader.hasNext());
+}
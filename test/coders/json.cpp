@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include "coders/commons.hpp"
 #include "coders/json.hpp"
 #include "util/stringutil.hpp"
 
@@ -40,3 +41,42 @@ TEST(JSON, EncodeDecode) {
         }
     }
 }
+
+TEST(JSON, ParseArena) {
+    std::string text = R"({
+        "name": "block",
+        "hitboxes": [[0, 0, 0, 1, 0.5, 1], [0, 0.5, 0, 0.5, 0.5, 0.5]],
+        "properties": {"hardness": 3, "tags": ["base:stone"]}
+    })";
+    auto arena = std::make_shared<dv::Arena>();
+    auto object = json::parse("[string]", text, arena);
+    EXPECT_EQ(object.getArena(), arena);
+    EXPECT_EQ(object["properties"]["tags"].getArena(), arena);
+    EXPECT_EQ(object["hitboxes"][1][4].asNumber(), 0.5);
+    EXPECT_EQ(
+        json::stringify(object, false), json::stringify(json::parse(text), false)
+    );
+}
+
+TEST(JSON, ParseLongTokens) {
+    std::string longText(100, 'a');
+    std::string text = "{\n                \"text\": \"" + longText +
+                       "\\n\\\"quoted\\\" \\u0041" + longText +
+                       "\",\n                \"number\": 12345678901234567" +
+                       ",\n                \"float\": 1234567.0000000125\n}";
+    auto object = json::parse(text);
+    EXPECT_EQ(
+        object["text"].asString(),
+        longText + "\n\"quoted\" A" + longText
+    );
+    EXPECT_EQ(object["number"].asInteger(), 12345678901234567LL);
+    EXPECT_DOUBLE_EQ(object["float"].asNumber(), 1234567.0000000125);
+
+    try {
+        json::parse("{\n\n                    \"a\": 1,\n          ?}");
+        FAIL() << "parsing_error expected";
+    } catch (const parsing_error& err) {
+        EXPECT_EQ(err.line, 4);
+        EXPECT_EQ(err.pos - err.linestart, 10);
+    }
+}
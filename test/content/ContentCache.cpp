@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "content/ContentCache.hpp"
+#include "io/io.hpp"
+#include "io/devices/StdfsDevice.hpp"
+
+namespace fs = std::filesystem;
+
+TEST(ContentCache, ReadModifiedRemoved) {
+    auto folder = fs::temp_directory_path() / "vctest_content_cache";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    io::set_device("cachetest", std::make_shared<io::StdfsDevice>(folder));
+
+    io::path cacheFile = "cachetest:cache/pack.cache";
+    io::path blockFile = "cachetest:blocks/stone.json";
+    io::path tagsFile = "cachetest:tags.toml";
+    io::create_directories(blockFile.parent());
+    io::write_string(blockFile, R"({"texture": "stone", "hardness": 1.5})");
+    io::write_string(tagsFile, "ores = [\"base:coal\"]\n");
+    {
+        ContentCache cache(cacheFile, "res:");
+        EXPECT_EQ(cache.read(blockFile)["texture"].asString(), "stone");
+        EXPECT_EQ(cache.read(tagsFile)["ores"][0].asString(), "base:coal");
+        EXPECT_EQ(cache.getMisses(), 2);
+        cache.save();
+    }
+    {
+        ContentCache cache(cacheFile, "res:");
+        auto root = cache.read(blockFile);
+        EXPECT_EQ(root["texture"].asString(), "stone");
+        EXPECT_EQ(root["hardness"].asNumber(), 1.5);
+        EXPECT_EQ(cache.getHits(), 1);
+        EXPECT_EQ(cache.getMisses(), 0);
+        // tags.toml entry is not used and removed from the cache
+        cache.save();
+    }
+    io::write_string(blockFile, R"({"texture": "cobblestone"})");
+    fs::last_write_time(
+        folder / "blocks/stone.json",
+        fs::last_write_time(folder / "blocks/stone.json") + std::chrono::hours(1)
+    );
+    {
+        ContentCache cache(cacheFile, "res:");
+        EXPECT_EQ(cache.read(blockFile)["texture"].asString(), "cobblestone");
+        EXPECT_EQ(cache.read(tagsFile)["ores"].size(), 1);
+        EXPECT_EQ(cache.getHits(), 0);
+        EXPECT_EQ(cache.getMisses(), 2);
+    }
+    {
+        // cache built for another pack folder
+        ContentCache cache(cacheFile, "user:content/base");
+        cache.read(blockFile);
+        EXPECT_EQ(cache.getMisses(), 1);
+    }
+    io::remove_device("cachetest");
+    fs::remove_all(folder);
+}
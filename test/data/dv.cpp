@@ -27,3 +27,68 @@ TEST(dv, dv) {
         }
     }
 }
+
+TEST(dv, Arena) {
+    auto arena = std::make_shared<dv::Arena>(256);
+    dv::value list;
+    {
+        auto value = dv::object(arena);
+        auto& elements = value.list("elements");
+        for (int i = 0; i < 100; i++) {
+            auto& obj = elements.object();
+            obj["name"] = "user";
+            obj["position"] = dv::list({40, -41, 52});
+        }
+        EXPECT_EQ(elements.getArena(), arena);
+        EXPECT_EQ(elements[99].getArena(), arena);
+        list = elements;
+    }
+    EXPECT_GT(arena->getAllocations(), 100);
+    EXPECT_GT(arena->getBlocksCount(), 1);
+
+    // the arena is kept alive by containers allocated in it
+    std::weak_ptr<dv::Arena> weak = arena;
+    arena.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ(list.size(), 100);
+    EXPECT_EQ(list[42]["name"].asString(), "user");
+    list = nullptr;
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(dv, ToHeap) {
+    auto arena = std::make_shared<dv::Arena>();
+    auto root = dv::object(arena);
+    auto& props = root.object("props");
+    props["name"] = "user";
+    props.list("position").add(42);
+
+    auto copy = dv::to_heap(root["props"]);
+    EXPECT_EQ(copy.getArena(), nullptr);
+    EXPECT_EQ(copy["position"].getArena(), nullptr);
+    EXPECT_EQ(copy["name"].asString(), "user");
+    EXPECT_EQ(copy["position"][0].asInteger(), 42);
+
+    std::weak_ptr<dv::Arena> weak = arena;
+    arena.reset();
+    root = nullptr;
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(copy["position"].size(), 1);
+}
+
+TEST(dv, ArenaCopyAssign) {
+    using list_t = std::vector<int, dv::arena_allocator<int>>;
+    auto arena = std::make_shared<dv::Arena>();
+    list_t source {{1, 2, 3}, dv::arena_allocator<int>(arena)};
+    list_t target;
+    target = source;
+    EXPECT_EQ(target.get_allocator().getArena(), nullptr);
+    EXPECT_EQ(target.size(), 3);
+
+    // copy assigned target does not keep the arena alive
+    std::weak_ptr<dv::Arena> weak = arena;
+    arena.reset();
+    source = list_t();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(target[2], 3);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+#include "coders/json.hpp"
+#include "debug/Profiler.hpp"
+
+using namespace debug;
+
+static dv::value write_trace() {
+    std::stringstream ss;
+    Profiler::writeTrace(ss);
+    return json::parse(ss.str());
+}
+
+/// @brief Count complete events with the given name
+static int count_zones(const dv::value& trace, const std::string& name) {
+    int count = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"].asString() == "X" &&
+            event["name"].asString() == name) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(Profiler, Zones) {
+    Profiler::clear();
+    Profiler::setEnabled(false);
+    {
+        ProfileZone zone("disabled");
+    }
+    Profiler::setEnabled(true);
+    {
+        ProfileZone outer("outer");
+        for (int i = 0; i < 3; i++) {
+            ProfileZone inner("inner");
+        }
+    }
+    std::thread thread([]() {
+        Profiler::setThreadName("worker \"1\"");
+        ProfileZone zone(Profiler::intern("worker-zone"));
+    });
+    thread.join();
+    EXPECT_FALSE(Profiler::end());
+    Profiler::setEnabled(false);
+
+    auto trace = write_trace();
+    EXPECT_EQ(count_zones(trace, "disabled"), 0);
+    EXPECT_EQ(count_zones(trace, "outer"), 1);
+    EXPECT_EQ(count_zones(trace, "inner"), 3);
+    EXPECT_EQ(count_zones(trace, "worker-zone"), 1);
+
+    double outerBegin = 0.0, outerEnd = 0.0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["name"].asString() == "outer") {
+            outerBegin = event["ts"].asNumber();
+            outerEnd = outerBegin + event["dur"].asNumber();
+        }
+    }
+    bool threadNamed = false;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["name"].asString() == "inner") {
+            EXPECT_GE(event["ts"].asNumber(), outerBegin);
+            double end = event["ts"].asNumber() + event["dur"].asNumber();
+            EXPECT_LE(end, outerEnd);
+        }
+        if (event["ph"].asString() == "M") {
+            threadNamed |= event["args"]["name"].asString() == "worker \"1\"";
+        }
+    }
+    EXPECT_TRUE(threadNamed);
+
+    // finished threads buffers are removed
+    Profiler::clear();
+    trace = write_trace();
+    EXPECT_EQ(count_zones(trace, "worker-zone"), 0);
+    EXPECT_EQ(count_zones(trace, "outer"), 0);
+}
+
+TEST(Profiler, RingBuffer) {
+    Profiler::clear();
+    Profiler::setEnabled(true);
+    const char* names[] {"a", "b"};
+    size_t total = Profiler::BUFFER_CAPACITY + 100;
+    for (size_t i = 0; i < total; i++) {
+        ProfileZone zone(names[i < 100 ? 0 : 1]);
+    }
+    Profiler::setEnabled(false);
+
+    auto trace = write_trace();
+    // the oldest zones are overwritten
+    EXPECT_EQ(count_zones(trace, "a"), 0);
+    EXPECT_EQ(count_zones(trace, "b"), Profiler::BUFFER_CAPACITY);
+
+    double prevTime = -1.0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"].asString() == "X") {
+            EXPECT_GE(event["ts"].asNumber(), prevTime);
+            prevTime = event["ts"].asNumber();
+        }
+    }
+    Profiler::clear();
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "graphics/render/ChunkVisibility.hpp"
+
+using Occluders = std::bitset<CHUNK_VOL>;
+
+static std::unique_ptr<Occluders> make_solid() {
+    auto occluders = std::make_unique<Occluders>();
+    occluders->set();
+    return occluders;
+}
+
+/// @brief Dig a box including both corners
+static void dig(Occluders& occluders, glm::ivec3 a, glm::ivec3 b) {
+    for (int y = a.y; y <= b.y; y++) {
+        for (int z = a.z; z <= b.z; z++) {
+            for (int x = a.x; x <= b.x; x++) {
+                occluders.reset(vox_index(x, y, z));
+            }
+        }
+    }
+}
+
+TEST(ChunkVisibility, Build) {
+    using Face = ChunkVisibility;
+
+    ChunkVisibility empty;
+    empty.build(Occluders());
+    EXPECT_TRUE(empty.isConnected(0, Face::NEG_X, Face::POS_X));
+    EXPECT_TRUE(empty.isConnected(5, Face::NEG_Y, Face::POS_Z));
+
+    auto occluders = make_solid();
+    // vertical shaft through the first section
+    dig(*occluders, {8, 0, 8}, {8, 15, 8});
+    // closed cavity in the second section
+    dig(*occluders, {4, 20, 4}, {10, 25, 10});
+    // tunnel from west to south in the third section
+    dig(*occluders, {0, 40, 3}, {3, 40, 3});
+    dig(*occluders, {3, 40, 3}, {3, 40, 15});
+
+    ChunkVisibility graph;
+    graph.build(*occluders);
+    EXPECT_TRUE(graph.isConnected(0, Face::NEG_Y, Face::POS_Y));
+    EXPECT_FALSE(graph.isConnected(0, Face::NEG_X, Face::POS_X));
+    EXPECT_FALSE(graph.isConnected(0, Face::NEG_Y, Face::POS_X));
+    for (int a = 0; a < Face::FACES_COUNT; a++) {
+        for (int b = a + 1; b < Face::FACES_COUNT; b++) {
+            EXPECT_FALSE(graph.isConnected(1, a, b));
+            EXPECT_FALSE(graph.isConnected(3, a, b));
+        }
+    }
+    EXPECT_TRUE(graph.isConnected(2, Face::NEG_X, Face::POS_Z));
+    EXPECT_TRUE(graph.isConnected(2, Face::POS_Z, Face::NEG_X));
+    EXPECT_FALSE(graph.isConnected(2, Face::NEG_X, Face::POS_X));
+}
+
+TEST(OcclusionCulling, Caves) {
+    const int width = 6;
+    const int depth = 3;
+    // camera in the open middle row, solid rock around.
+    // Row z=1: open, open, rock, rock, open, open
+    ChunkVisibility open;
+    ChunkVisibility rock;
+    rock.build(*make_solid());
+    ChunkVisibility tunnel;
+    {
+        auto occluders = make_solid();
+        dig(*occluders, {0, 8, 8}, {15, 8, 8});
+        tunnel.build(*occluders);
+    }
+    std::vector<const ChunkVisibility*> graphs(width * depth, &rock);
+    graphs[1 * width + 0] = &open;
+    graphs[1 * width + 1] = &open;
+    graphs[1 * width + 4] = &open;
+    graphs[1 * width + 5] = &open;
+
+    OcclusionCulling culling;
+    auto supplier = [&](int index) { return graphs[index]; };
+    glm::vec3 camera(8.0f, 8.0f, CHUNK_D + 8.0f);
+
+    culling.update(width, depth, 0, 0, camera, nullptr, supplier);
+    EXPECT_TRUE(culling.isVisible(1 * width + 0));
+    EXPECT_TRUE(culling.isVisible(1 * width + 1));
+    // the rock itself is visible, but not chunks behind it
+    EXPECT_TRUE(culling.isVisible(1 * width + 2));
+    EXPECT_FALSE(culling.isVisible(1 * width + 3));
+    EXPECT_FALSE(culling.isVisible(1 * width + 4));
+    EXPECT_FALSE(culling.isVisible(1 * width + 5));
+    // rock next to open chunks is visible, rock behind it is not
+    EXPECT_TRUE(culling.isVisible(0 * width + 1));
+    EXPECT_FALSE(culling.isVisible(0 * width + 3));
+    EXPECT_EQ(culling.countVisible(), 7);
+
+    // dig the rock through
+    graphs[1 * width + 2] = &tunnel;
+    graphs[1 * width + 3] = &tunnel;
+    culling.update(width, depth, 0, 0, camera, nullptr, supplier);
+    EXPECT_TRUE(culling.isVisible(1 * width + 3));
+    EXPECT_TRUE(culling.isVisible(1 * width + 4));
+    EXPECT_TRUE(culling.isVisible(1 * width + 5));
+    EXPECT_TRUE(culling.isVisible(2 * width + 5));
+
+    // unknown graphs are treated as open
+    culling.update(
+        width, depth, 0, 0, camera, nullptr, [](int) { return nullptr; }
+    );
+    EXPECT_EQ(culling.countVisible(), width * depth);
+}
+
+TEST(OcclusionCulling, ClosedCave) {
+    auto occluders = make_solid();
+    dig(*occluders, {2, 2, 2}, {12, 10, 12});
+    ChunkVisibility cave;
+    cave.build(*occluders);
+    ChunkVisibility rock;
+    rock.build(*make_solid());
+
+    const int width = 3;
+    std::vector<const ChunkVisibility*> graphs(width * width, &rock);
+    graphs[4] = &cave;
+
+    OcclusionCulling culling;
+    culling.update(
+        width,
+        width,
+        -1,
+        -1,
+        glm::vec3(6.0f, 5.0f, 6.0f),
+        nullptr,
+        [&](int index) { return graphs[index]; }
+    );
+    // camera section neighbours are always visible
+    EXPECT_EQ(culling.countVisible(), 5);
+    EXPECT_TRUE(culling.isVisible(4));
+    EXPECT_TRUE(culling.isVisible(1));
+    EXPECT_FALSE(culling.isVisible(0));
+    EXPECT_FALSE(culling.isVisible(8));
+}
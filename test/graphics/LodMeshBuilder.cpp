@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "graphics/render/LodMeshBuilder.hpp"
+#include "lighting/Lightmap.hpp"
+
+static constexpr blockid_t STONE = 1;
+
+/// @brief Flat stone floor with blocks at y < height
+static std::unique_ptr<voxel[]> make_floor(int height) {
+    auto voxels = std::make_unique<voxel[]>(CHUNK_VOL);
+    for (int i = 0; i < CHUNK_VOL; i++) {
+        voxels[i].id = i < height * CHUNK_W * CHUNK_D ? STONE : BLOCK_AIR;
+    }
+    return voxels;
+}
+
+TEST(LodMeshBuilder, FlatFloor) {
+    LodMeshBuilder::BlockInfo blocks[2] {};
+    blocks[STONE].solid = true;
+
+    auto voxels = make_floor(64);
+    LodMeshBuilder builder;
+    for (int level = 1; level <= LodMeshBuilder::MAX_LEVEL; level++) {
+        int size = 1 << level;
+        int columns = CHUNK_W / size;
+        int layers = 64 / size;
+        builder.build(voxels.get(), nullptr, blocks, level);
+
+        // top faces and skirts on the four chunk borders
+        size_t quads = columns * columns + 4 * columns * layers;
+        EXPECT_EQ(builder.getVertices().size(), quads * 4);
+        EXPECT_EQ(builder.getIndices().size(), quads * 6);
+
+        for (const auto& [vertex, region] : builder.getVertices()) {
+            // faces are placed on block edges
+            EXPECT_GE(vertex.position.y, -0.5f);
+            EXPECT_LE(vertex.position.y, 63.5f);
+            EXPECT_GE(vertex.position.x, -0.5f);
+            EXPECT_LE(vertex.position.x, CHUNK_W - 0.5f);
+            // texture is repeated once per block
+            EXPECT_LE(vertex.uv.x, size);
+            EXPECT_LE(vertex.uv.y, size);
+        }
+    }
+}
+
+TEST(LodMeshBuilder, CellsAndLights) {
+    LodMeshBuilder::BlockInfo blocks[2] {};
+    blocks[STONE].solid = true;
+
+    // single layer is less than half of a level 2 cell
+    auto voxels = make_floor(1);
+    LodMeshBuilder builder;
+    builder.build(voxels.get(), nullptr, blocks, 2);
+    EXPECT_TRUE(builder.getVertices().empty());
+
+    auto lightmap = std::make_unique<Lightmap>();
+    for (int y = 2; y < CHUNK_H; y++) {
+        for (int z = 0; z < CHUNK_D; z++) {
+            for (int x = 0; x < CHUNK_W; x++) {
+                lightmap->setS(x, y, z, 15);
+            }
+        }
+    }
+    voxels = make_floor(2);
+    builder.build(voxels.get(), lightmap->getLights(), blocks, 1);
+    bool topFound = false;
+    for (const auto& [vertex, region] : builder.getVertices()) {
+        if (vertex.normal[1] > 128) {
+            topFound = true;
+            EXPECT_EQ(vertex.color[3], 255);
+            EXPECT_FLOAT_EQ(vertex.position.y, 1.5f);
+        }
+    }
+    EXPECT_TRUE(topFound);
+}
+
+TEST(LodMeshBuilder, SelectLevel) {
+    const float lodDistance = 4.0f;
+    EXPECT_EQ(LodMeshBuilder::selectLevel(100.0f, 0.0f, 0), 0);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(2.0f, lodDistance, 0), 0);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(4.6f, lodDistance, 0), 1);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(9.0f, lodDistance, 0), 2);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(100.0f, lodDistance, 0), 3);
+
+    // hysteresis around a level threshold
+    EXPECT_EQ(LodMeshBuilder::selectLevel(4.2f, lodDistance, 0), 0);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(3.8f, lodDistance, 1), 1);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(3.4f, lodDistance, 1), 0);
+    EXPECT_EQ(LodMeshBuilder::selectLevel(2.0f, lodDistance, 3), 0);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "graphics/render/commons.hpp"
+
+static ChunkVertex make_vertex(
+    const glm::vec3& position,
+    const glm::vec2& uv,
+    const glm::vec3& normal,
+    bool emission
+) {
+    ChunkVertex vertex;
+    vertex.position = position;
+    vertex.uv = uv;
+    vertex.color = {255, 128, 7, 64};
+    vertex.normal = {
+        static_cast<uint8_t>(normal.x * 127 + 128),
+        static_cast<uint8_t>(normal.y * 127 + 128),
+        static_cast<uint8_t>(normal.z * 127 + 128),
+        static_cast<uint8_t>(emission ? 255 : 0),
+    };
+    return vertex;
+}
+
+TEST(PackedChunkVertex, PackUnpack) {
+    glm::vec3 normal(0.0f, 0.6f, -0.8f);
+    for (float x : {-1.5f, 0.0f, 7.25f, 15.5f, 16.5f}) {
+        for (float y : {-0.5f, 33.75f, 255.5f}) {
+            auto source = make_vertex(
+                {x, y, 3.1f}, {0.123f, 0.875f}, normal, y > 0.0f
+            );
+            auto unpacked = PackedChunkVertex::pack(source).unpack();
+            const auto& vertex = unpacked.vertex;
+            for (int i = 0; i < 3; i++) {
+                EXPECT_NEAR(
+                    vertex.position[i],
+                    source.position[i],
+                    0.5f / PackedChunkVertex::POSITION_SCALE
+                );
+                EXPECT_NEAR(vertex.normal[i], source.normal[i], 5);
+            }
+            EXPECT_EQ(vertex.normal[3], source.normal[3]);
+            EXPECT_EQ(vertex.color, source.color);
+            EXPECT_NEAR(vertex.uv.x, source.uv.x, 1.0f / 65535);
+            EXPECT_NEAR(vertex.uv.y, source.uv.y, 1.0f / 65535);
+            EXPECT_EQ(unpacked.region, (std::array<uint16_t, 4> {}));
+        }
+    }
+}
+
+TEST(PackedChunkVertex, RepeatedRegion) {
+    // face axes (X, Y, normal) of cube faces used by greedy meshing
+    const glm::vec3 axes[6][3] {
+        {{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}},
+        {{0, 0, -1}, {0, 1, 0}, {1, 0, 0}},
+        {{1, 0, 0}, {0, 0, 1}, {0, -1, 0}},
+        {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},
+        {{-1, 0, 0}, {0, 1, 0}, {0, 0, -1}},
+        {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+    };
+    const std::array<uint16_t, 4> region {1024, 2048, 3072, 4096};
+    const int w = 3;
+    const int h = 2;
+    for (const auto& [X, Y, Z] : axes) {
+        glm::vec3 center = glm::vec3(5, 40, 9) + X * 1.0f + Y * 0.5f;
+        glm::vec3 dx = X * (w * 0.5f);
+        glm::vec3 dy = Y * (h * 0.5f);
+        glm::vec3 dz = Z * 0.5f;
+        const TiledChunkVertex sources[4] {
+            {make_vertex(center - dx - dy + dz, {0, 0}, Z, false), region},
+            {make_vertex(center + dx - dy + dz, {w, 0}, Z, false), region},
+            {make_vertex(center + dx + dy + dz, {w, h}, Z, false), region},
+            {make_vertex(center - dx + dy + dz, {0, h}, Z, false), region},
+        };
+        glm::vec2 offset;
+        for (int i = 0; i < 4; i++) {
+            auto vertex = PackedChunkVertex::pack(sources[i]).unpack();
+            EXPECT_EQ(vertex.region, region);
+            // texture repeats may differ by an integer offset only
+            glm::vec2 diff = vertex.vertex.uv - sources[i].vertex.uv;
+            if (i == 0) {
+                EXPECT_FLOAT_EQ(diff.x, std::round(diff.x));
+                EXPECT_FLOAT_EQ(diff.y, std::round(diff.y));
+                offset = diff;
+            } else {
+                EXPECT_FLOAT_EQ(diff.x, offset.x);
+                EXPECT_FLOAT_EQ(diff.y, offset.y);
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+
+#include "graphics/render/ParticlesSimulation.hpp"
+#include "voxels/Chunk.hpp"
+
+TEST(ParticlesLightField, Sample) {
+    // 2x2 chunks area starting from chunk (-1, -1)
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int z = -1; z <= 0; z++) {
+        for (int x = -1; x <= 0; x++) {
+            auto chunk = std::make_unique<Chunk>(
+                x, z, std::make_shared<Lightmap>()
+            );
+            for (int ly = 0; ly < CHUNK_H; ly++) {
+                for (int lz = 0; lz < CHUNK_D; lz++) {
+                    for (int lx = 0; lx < CHUNK_W; lx++) {
+                        int value = (lx * 7 + ly * 3 + lz * 5 + x + z * 2);
+                        chunk->lightmap->set(lx, ly, lz, 0, value & 0xF);
+                        chunk->lightmap->setS(lx, ly, lz, (value >> 2) & 0xF);
+                    }
+                }
+            }
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    int lookups = 0;
+    ParticlesLightField field([&](int cx, int cz) -> const Chunk* {
+        lookups++;
+        if (cx < -1 || cz < -1 || cx > 0 || cz > 0) {
+            return nullptr;
+        }
+        return chunks[(cz + 1) * 2 + cx + 1].get();
+    });
+    field.reset(false);
+
+    auto naive_get = [&](int x, int y, int z) -> light_t {
+        if (y < 0 || y >= CHUNK_H || x < -CHUNK_W || z < -CHUNK_D ||
+            x >= CHUNK_W || z >= CHUNK_D) {
+            return 0;
+        }
+        int cx = x < 0 ? -1 : 0;
+        int cz = z < 0 ? -1 : 0;
+        return chunks[(cz + 1) * 2 + cx + 1]->lightmap->get(
+            x - cx * CHUNK_W, y, z - cz * CHUNK_D
+        );
+    };
+    for (int i = 0; i < 500; i++) {
+        glm::vec3 pos(
+            (i * 37 % 400) * 0.1f - 20.0f,
+            (i * 53 % 300) * 1.0f - 20.0f,
+            (i * 71 % 400) * 0.1f - 20.0f
+        );
+        glm::vec3 size(0.5f + (i % 3) * 0.7f);
+        glm::vec4 expected(0.0f);
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                for (int z = -1; z <= 1; z++) {
+                    glm::vec3 sample = pos - size * glm::vec3(x, y, z);
+                    light_t light = naive_get(
+                        std::floor(sample.x),
+                        std::floor(std::min(CHUNK_H - 1.0f, sample.y)),
+                        std::floor(sample.z)
+                    );
+                    for (int c = 0; c < 4; c++) {
+                        expected[c] = std::max(
+                            expected[c], Lightmap::extract(light, c) / 15.0f
+                        );
+                    }
+                }
+            }
+        }
+        glm::vec4 light = field.sample(pos, size);
+        for (int c = 0; c < 4; c++) {
+            EXPECT_FLOAT_EQ(light[c], expected[c]);
+        }
+    }
+    // each chunk is looked up once per step while it stays in the cache
+    EXPECT_LE(lookups, 16);
+
+    field.reset(true);
+    // unloaded chunks are lit by backlight only
+    auto light = field.sample(glm::vec3(1000.0f), glm::vec3(0.5f));
+    EXPECT_FLOAT_EQ(light.x, 1 / 15.0f);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "graphics/render/TranslucentSorter.hpp"
+
+static TranslucentEntries make_entries(size_t count, uint32_t vertices) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> coord(0.0f, 16.0f);
+    TranslucentEntries translucent;
+    for (size_t i = 0; i < count; i++) {
+        translucent.entries.push_back(TranslucentEntries::Entry {
+            glm::vec3(coord(random), coord(random) * 16.0f, coord(random)),
+            static_cast<uint32_t>(translucent.vertexCount),
+            vertices});
+        translucent.vertexCount += vertices;
+    }
+    return translucent;
+}
+
+static float distance2(const glm::vec3& a, const glm::vec3& b) {
+    glm::vec3 delta = a - b;
+    return delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+}
+
+static void expect_back_to_front(
+    const TranslucentEntries& translucent,
+    const glm::vec3& camera,
+    const std::vector<uint32_t>& order
+) {
+    ASSERT_EQ(order.size(), translucent.entries.size());
+    std::vector<bool> found(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        ASSERT_FALSE(found[order[i]]);
+        found[order[i]] = true;
+        if (i > 0) {
+            EXPECT_GE(
+                distance2(translucent.entries[order[i - 1]].position, camera),
+                distance2(translucent.entries[order[i]].position, camera)
+            );
+        }
+    }
+}
+
+TEST(TranslucentSorter, Sort) {
+    auto translucent = make_entries(1000, 6);
+    TranslucentSorter sorter;
+    std::vector<uint32_t> order;
+
+    glm::vec3 camera(8.0f, 100.0f, 8.0f);
+    EXPECT_TRUE(sorter.sort(translucent, camera, order));
+    expect_back_to_front(translucent, camera, order);
+
+    // small movement keeps entries nearly sorted
+    camera.x += 0.05f;
+    EXPECT_FALSE(sorter.sort(translucent, camera, order));
+    expect_back_to_front(translucent, camera, order);
+
+    // moving to the other side reverses the order
+    camera = glm::vec3(8.0f, -100.0f, 8.0f);
+    EXPECT_TRUE(sorter.sort(translucent, camera, order));
+    expect_back_to_front(translucent, camera, order);
+
+    // previous order of another size is ignored
+    auto other = make_entries(10, 6);
+    EXPECT_TRUE(sorter.sort(other, camera, order));
+    expect_back_to_front(other, camera, order);
+}
+
+TEST(TranslucentSorter, WriteIndices) {
+    auto translucent = make_entries(3, 6);
+    translucent.entries[1].vertexCount = 12;
+    translucent.entries[2].firstVertex = 18;
+    translucent.vertexCount = 24;
+
+    std::vector<uint32_t> indices;
+    TranslucentSorter::writeIndices(translucent, {2, 0, 1}, indices);
+    ASSERT_EQ(indices.size(), 24);
+    EXPECT_EQ(indices[0], 18);
+    EXPECT_EQ(indices[5], 23);
+    EXPECT_EQ(indices[6], 0);
+    EXPECT_EQ(indices[12], 6);
+    EXPECT_EQ(indices[23], 17);
+}
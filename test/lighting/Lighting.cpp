@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "core_defs.hpp"
+#include "items/ItemDef.hpp"
+#include "lighting/Lighting.hpp"
+#include "lighting/Lightmap.hpp"
+#include "objects/rigging.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+static constexpr blockid_t LAMP = 1;
+
+/// @brief Air and a red lamp
+static std::unique_ptr<Content> create_content() {
+    ContentBuilder builder;
+    builder.items.create(CORE_EMPTY);
+    {
+        Block& block = builder.blocks.create(CORE_AIR);
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.pickingItem = CORE_EMPTY;
+    }
+    {
+        Block& block = builder.blocks.create("test:lamp");
+        block.emission[0] = 14;
+        block.pickingItem = CORE_EMPTY;
+    }
+    return builder.build();
+}
+
+static std::shared_ptr<Chunk> create_chunk(
+    int x, int z, const std::vector<glm::ivec3>& lamps
+) {
+    auto chunk = std::make_shared<Chunk>(x, z, std::make_shared<Lightmap>());
+    for (const auto& pos : lamps) {
+        chunk->voxels[vox_index(pos.x, pos.y, pos.z)].id = LAMP;
+        chunk->addLightSource(vox_index(pos.x, pos.y, pos.z));
+    }
+    return chunk;
+}
+
+/// @brief Put chunks to a new -1..1 area and solve their lights from scratch
+static void solve_lights(
+    const Content& content, const std::vector<std::shared_ptr<Chunk>>& list
+) {
+    Chunks chunks(3, 3, 1, 1, nullptr, *content.getIndices());
+    Lighting lighting(content, chunks);
+    for (const auto& chunk : list) {
+        chunks.putChunk(chunk);
+    }
+    for (const auto& chunk : list) {
+        lighting.onChunkLoaded(chunk->x, chunk->z, true);
+    }
+}
+
+static bool equal_lights(const Chunk& a, const Chunk& b) {
+    return std::equal(
+        a.lightmap->map, a.lightmap->map + CHUNK_VOL, b.lightmap->map
+    );
+}
+
+TEST(Lighting, CachedChunkSourcesNotSolved) {
+    auto content = create_content();
+    // cached lights without the lamp light: if the lamp was solved again
+    // the lights would change
+    auto chunk = create_chunk(0, 0, {{8, 10, 8}});
+    auto neighbour = create_chunk(1, 0, {});
+    solve_lights(*content, {neighbour});
+
+    Chunks chunks(3, 3, 1, 1, nullptr, *content->getIndices());
+    Lighting lighting(*content, chunks);
+    chunks.putChunk(neighbour);
+    chunks.putChunk(chunk);
+    lighting.onCachedChunkLoaded(0, 0);
+
+    EXPECT_EQ(chunk->lightmap->getR(8, 10, 8), 0);
+    EXPECT_EQ(chunk->lightmap->getR(9, 10, 8), 0);
+    EXPECT_FALSE(chunk->flags.unsavedLights);
+}
+
+TEST(Lighting, CachedChunkBorder) {
+    auto content = create_content();
+    auto chunk = create_chunk(0, 0, {{3, 10, 8}});
+    // lamp near the border lights the cached chunk
+    auto neighbour = create_chunk(1, 0, {{0, 10, 8}});
+    solve_lights(*content, {chunk, neighbour});
+    ASSERT_EQ(chunk->lightmap->getR(15, 10, 8), 13);
+    auto cached = std::make_unique<Lightmap>();
+    cached->set(chunk->lightmap.get());
+
+    // neighbour lamp is removed while the chunk is unloaded
+    auto expectedChunk = create_chunk(0, 0, {{3, 10, 8}});
+    auto emptyNeighbour = create_chunk(1, 0, {});
+    solve_lights(*content, {expectedChunk, emptyNeighbour});
+    {
+        Chunks chunks(3, 3, 1, 1, nullptr, *content->getIndices());
+        Lighting lighting(*content, chunks);
+        chunks.putChunk(emptyNeighbour);
+        chunks.putChunk(chunk);
+        lighting.onCachedChunkLoaded(0, 0);
+    }
+    EXPECT_TRUE(equal_lights(*chunk, *expectedChunk));
+    EXPECT_TRUE(chunk->flags.unsavedLights);
+
+    // neighbour lamp is placed while the chunk is unloaded
+    chunk->lightmap->set(expectedChunk->lightmap.get());
+    chunk->flags.unsavedLights = false;
+    {
+        Chunks chunks(3, 3, 1, 1, nullptr, *content->getIndices());
+        Lighting lighting(*content, chunks);
+        chunks.putChunk(neighbour);
+        chunks.putChunk(chunk);
+        lighting.onCachedChunkLoaded(0, 0);
+    }
+    EXPECT_TRUE(std::equal(
+        chunk->lightmap->map, chunk->lightmap->map + CHUNK_VOL, cached->map
+    ));
+    EXPECT_TRUE(chunk->flags.unsavedLights);
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "coders/rle.hpp"
+#include "lighting/Lightmap.hpp"
+
+TEST(Lightmap, EncodeDecode) {
+    auto src = std::make_unique<Lightmap>();
+    for (int y = 0; y < CHUNK_H; y++) {
+        for (int z = 0; z < CHUNK_D; z++) {
+            for (int x = 0; x < CHUNK_W; x++) {
+                int surface = 56 + (x * 3 + z * 5) % 8;
+                src->setS(x, y, z, std::max(0, 15 - std::max(0, surface - y)));
+                // a torch near the surface
+                int distance = std::abs(x - 8) + std::abs(y - 60) +
+                               std::abs(z - 8);
+                src->setR(x, y, z, std::max(0, 13 - distance));
+                src->setG(x, y, z, std::max(0, 12 - distance));
+                src->setB(x, y, z, std::max(0, 4 - distance));
+            }
+        }
+    }
+    auto bytes = src->encode();
+    EXPECT_EQ(bytes[0], LIGHTMAP_FORMAT_VERSION);
+
+    auto dst = std::make_unique<Lightmap>();
+    EXPECT_TRUE(dst->decode(bytes.get(), LIGHTMAP_DATA_LEN));
+    for (int i = 0; i < CHUNK_VOL; i++) {
+        ASSERT_EQ(src->map[i], dst->map[i]);
+    }
+
+    // channels planes are mostly uniform
+    std::vector<ubyte> compressed(LIGHTMAP_DATA_LEN * 2);
+    size_t size = extrle::encode(
+        bytes.get(), LIGHTMAP_DATA_LEN, compressed.data()
+    );
+    EXPECT_LT(size, LIGHTMAP_DATA_LEN / 10);
+}
+
+TEST(Lightmap, DecodeLegacy) {
+    std::vector<ubyte> bytes(LIGHTMAP_SKY_DATA_LEN);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = i * 31;
+    }
+    Lightmap lightmap;
+    EXPECT_FALSE(lightmap.decode(bytes.data(), bytes.size()));
+    for (int i = 0; i < CHUNK_VOL; i++) {
+        int expected = i % 2 ? bytes[i / 2] >> 4 : bytes[i / 2] & 0xF;
+        ASSERT_EQ(lightmap.map[i], Lightmap::combine(0, 0, 0, expected));
+    }
+
+    bytes.resize(LIGHTMAP_DATA_LEN);
+    bytes[0] = LIGHTMAP_FORMAT_VERSION + 1;
+    EXPECT_THROW(
+        lightmap.decode(bytes.data(), bytes.size()), std::runtime_error
+    );
+    EXPECT_THROW(lightmap.decode(bytes.data(), 100), std::runtime_error);
+}
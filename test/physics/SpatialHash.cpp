@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <map>
+
+#include "physics/SpatialHash.hpp"
+
+using ObjectId = SpatialHash::id_t;
+
+static std::vector<ObjectId> brute_force(
+    const std::map<ObjectId, AABB>& objects, const AABB& aabb
+) {
+    std::vector<ObjectId> result;
+    glm::vec3 min = aabb.min();
+    glm::vec3 max = aabb.max();
+    for (const auto& [id, object] : objects) {
+        glm::vec3 omin = object.min();
+        glm::vec3 omax = object.max();
+        if (min.x <= omax.x && max.x >= omin.x && min.y <= omax.y &&
+            max.y >= omin.y && min.z <= omax.z && max.z >= omin.z) {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+TEST(SpatialHash, Queries) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> extent(0.1f, 3.0f);
+    auto random_box = [&](float maxExtent) {
+        glm::vec3 center(coord(random), coord(random) * 0.5f, coord(random));
+        glm::vec3 half(extent(random), extent(random), extent(random));
+        return AABB(center - half * maxExtent, center + half * maxExtent);
+    };
+
+    SpatialHash grid(4.0f);
+    std::map<ObjectId, AABB> objects;
+    for (ObjectId id = 1; id <= 2000; id++) {
+        // a few objects are larger than the cells limit
+        objects[id] = random_box(id % 500 == 0 ? 20.0f : 1.0f);
+        grid.update(id, objects[id]);
+    }
+    EXPECT_EQ(grid.size(), objects.size());
+
+    std::vector<ObjectId> result;
+    for (int step = 0; step < 5; step++) {
+        for (int i = 0; i < 200; i++) {
+            AABB query = random_box(i % 10 == 0 ? 40.0f : 2.0f);
+            grid.query(query, result);
+            EXPECT_EQ(result, brute_force(objects, query));
+        }
+        // move some objects slightly, some teleport, remove few
+        for (ObjectId id = 1 + step; id <= 2000; id += 7) {
+            if (id % 3 == 0) {
+                objects[id] = objects[id].translated(glm::vec3(0.3f, 0, -0.2f));
+            } else if (id % 3 == 1) {
+                objects[id] = random_box(1.0f);
+            } else {
+                objects.erase(id);
+                grid.remove(id);
+                continue;
+            }
+            grid.update(id, objects[id]);
+        }
+    }
+    EXPECT_EQ(grid.size(), objects.size());
+
+    for (const auto& [id, object] : objects) {
+        grid.remove(id);
+    }
+    EXPECT_EQ(grid.size(), 0);
+    EXPECT_EQ(grid.countCells(), 0);
+}
+
+TEST(SpatialHash, NotFinite) {
+    SpatialHash grid(4.0f);
+    grid.update(1, AABB(glm::vec3(0.0f), glm::vec3(1.0f)));
+    grid.update(2, AABB(glm::vec3(NAN), glm::vec3(1.0f)));
+    grid.update(3, AABB(glm::vec3(-1e30f), glm::vec3(1e30f)));
+
+    std::vector<ObjectId> result;
+    grid.query(AABB(glm::vec3(0.5f), glm::vec3(2.0f)), result);
+    EXPECT_EQ(result, (std::vector<ObjectId> {1, 3}));
+    grid.query(AABB(glm::vec3(INFINITY), glm::vec3(2.0f)), result);
+    EXPECT_TRUE(result.empty());
+
+    grid.remove(2);
+    grid.remove(3);
+    grid.query(AABB(glm::vec3(-1e20f), glm::vec3(1e20f)), result);
+    EXPECT_EQ(result, (std::vector<ObjectId> {1}));
+}
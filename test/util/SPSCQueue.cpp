@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "util/SPSCQueue.hpp"
+
+using namespace util;
+
+TEST(SPSCQueue, PushPop) {
+    SPSCQueue<int> queue(4);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.tryPop(), 1);
+    EXPECT_EQ(queue.tryPop(), 2);
+    EXPECT_EQ(queue.tryPop(), std::nullopt);
+}
+
+TEST(SPSCQueue, Bounded) {
+    SPSCQueue<int> queue(3);
+    EXPECT_EQ(queue.getCapacity(), 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.tryPush(std::move(i)));
+    }
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.tryPop(), 0);
+    EXPECT_TRUE(queue.tryPush(4));
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_EQ(queue.tryPop(), i);
+    }
+}
+
+TEST(SPSCQueue, MoveOnly) {
+    SPSCQueue<std::unique_ptr<int>> queue(2);
+    auto value = std::make_unique<int>(5);
+    EXPECT_TRUE(queue.tryPush(std::move(value)));
+    EXPECT_EQ(value, nullptr);
+
+    auto other = std::make_unique<int>(6);
+    EXPECT_TRUE(queue.tryPush(std::move(other)));
+    auto rejected = std::make_unique<int>(7);
+    EXPECT_FALSE(queue.tryPush(std::move(rejected)));
+    // value is not moved if queue is full
+    EXPECT_NE(rejected, nullptr);
+
+    EXPECT_EQ(**queue.tryPop(), 5);
+}
+
+TEST(SPSCQueue, Threads) {
+    constexpr int count = 100'000;
+    SPSCQueue<int> queue(16);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++) {
+            int value = i;
+            while (!queue.tryPush(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0;
+    while (expected < count) {
+        if (auto value = queue.tryPop()) {
+            ASSERT_EQ(*value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
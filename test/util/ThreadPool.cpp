@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "util/ThreadPool.hpp"
+
+using namespace util;
+
+namespace {
+    class SquareWorker : public Worker<int, int> {
+    public:
+        int operator()(const int& value) override {
+            return value * value;
+        }
+    };
+}
+
+static void run_pool(
+    int count, int workers, size_t capacity, bool standalone
+) {
+    int64_t sum = 0;
+    int consumed = 0;
+    bool completed = false;
+    ThreadPool<int, int> pool(
+        "test-pool",
+        []() { return std::make_shared<SquareWorker>(); },
+        [&](int& result) {
+            sum += result;
+            consumed++;
+        },
+        workers,
+        capacity
+    );
+    pool.setStandaloneResults(standalone);
+    pool.setOnComplete([&completed]() { completed = true; });
+    int64_t expected = 0;
+    for (int i = 0; i < count; i++) {
+        pool.enqueueJob(i);
+        expected += static_cast<int64_t>(i) * i;
+    }
+    pool.waitForEnd();
+    EXPECT_TRUE(completed);
+    EXPECT_EQ(consumed, count);
+    EXPECT_EQ(sum, expected);
+}
+
+TEST(ThreadPool, AllResultsConsumed) {
+    run_pool(10'000, 4, ThreadPool<int, int>::DEFAULT_RESULTS_CAPACITY, true);
+}
+
+TEST(ThreadPool, BackPressure) {
+    run_pool(1'000, 16, 1, true);
+}
+
+TEST(ThreadPool, NotStandaloneResults) {
+    run_pool(1'000, 4, 4, false);
+}
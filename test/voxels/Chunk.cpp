@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #include "voxels/Chunk.hpp"
 
@@ -23,3 +24,17 @@ TEST(Chunk, EncodeDecode) {
         );
     }
 }
+
+TEST(Chunk, LightSources) {
+    Chunk chunk(0, 0);
+    for (uint i = 0; i < 10; i++) {
+        chunk.addLightSource(i * 3);
+    }
+    chunk.removeLightSource(0);
+    chunk.removeLightSource(12);
+    chunk.removeLightSource(1);
+
+    std::vector<uint> sources = chunk.lightSources;
+    std::sort(sources.begin(), sources.end());
+    EXPECT_EQ(sources, (std::vector<uint> {3, 6, 9, 15, 18, 21, 24, 27}));
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include "voxels/ChunkJournal.hpp"
+
+TEST(ChunkJournal, Changes) {
+    ChunkJournal journal;
+    auto initial = journal.getVersion();
+    std::vector<uint> changes;
+    EXPECT_TRUE(journal.collectChanges(initial, changes));
+    EXPECT_TRUE(changes.empty());
+
+    journal.record(10);
+    journal.record(5);
+    auto middle = journal.getVersion();
+    journal.record(10);
+    journal.record(7);
+    EXPECT_GT(journal.getVersion(), middle);
+
+    EXPECT_TRUE(journal.collectChanges(initial, changes));
+    EXPECT_EQ(changes, (std::vector<uint> {5, 7, 10}));
+    EXPECT_TRUE(journal.collectChanges(middle, changes));
+    EXPECT_EQ(changes, (std::vector<uint> {7, 10}));
+    EXPECT_FALSE(journal.collectChanges(journal.getVersion() + 1, changes));
+
+    // versions are not repeated after reset
+    journal.reset();
+    EXPECT_FALSE(journal.collectChanges(middle, changes));
+    EXPECT_TRUE(journal.collectChanges(journal.getVersion(), changes));
+    EXPECT_TRUE(changes.empty());
+}
+
+TEST(ChunkJournal, Overflow) {
+    ChunkJournal journal;
+    auto initial = journal.getVersion();
+    for (uint i = 0; i < ChunkJournal::CAPACITY; i++) {
+        journal.record(i);
+    }
+    std::vector<uint> changes;
+    EXPECT_TRUE(journal.collectChanges(initial, changes));
+    EXPECT_EQ(changes.size(), ChunkJournal::CAPACITY);
+
+    auto version = journal.getVersion();
+    journal.record(1000);
+    EXPECT_FALSE(journal.collectChanges(initial, changes));
+    EXPECT_TRUE(journal.collectChanges(version, changes));
+    EXPECT_EQ(changes, (std::vector<uint> {1000}));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "voxels/Chunk.hpp"
+#include "voxels/EncodedChunksCache.hpp"
+
+static EncodedChunksCache::Payload make_payload(ubyte value) {
+    return std::make_shared<const std::vector<ubyte>>(1, value);
+}
+
+TEST(EncodedChunksCache, Versions) {
+    EncodedChunksCache cache(2);
+    cache.put(0, 0, 1, make_payload(1));
+    cache.put(1, 0, 1, make_payload(2));
+    ASSERT_NE(cache.get(0, 0, 1), nullptr);
+    EXPECT_EQ(cache.get(0, 0, 1)->at(0), 1);
+    // outdated entry is removed
+    EXPECT_EQ(cache.get(1, 0, 2), nullptr);
+    EXPECT_EQ(cache.get(1, 0, 1), nullptr);
+    EXPECT_EQ(cache.size(), 1);
+
+    // the least recently used entry is evicted
+    cache.put(1, 0, 1, make_payload(2));
+    cache.get(0, 0, 1);
+    cache.put(2, 0, 1, make_payload(3));
+    EXPECT_NE(cache.get(0, 0, 1), nullptr);
+    EXPECT_EQ(cache.get(1, 0, 1), nullptr);
+    EXPECT_NE(cache.get(2, 0, 1), nullptr);
+
+    // newer payload is not replaced with older one
+    cache.put(2, 0, 5, make_payload(4));
+    cache.put(2, 0, 4, make_payload(5));
+    EXPECT_EQ(cache.get(2, 0, 5)->at(0), 4);
+    EXPECT_EQ(cache.getHits(), 6);
+    EXPECT_EQ(cache.getMisses(), 3);
+}
+
+TEST(EncodedChunksCache, Fetch) {
+    EncodedChunksCache cache(16);
+    Chunk chunk(3, -2);
+    chunk.voxels[10].id = 1;
+    auto first = cache.fetch(chunk);
+    EXPECT_EQ(cache.fetch(chunk), first);
+
+    chunk.voxels[10].id = 2;
+    chunk.setModifiedAndUnsaved();
+    auto second = cache.fetch(chunk);
+    EXPECT_NE(second, first);
+    EXPECT_NE(*second, *first);
+    EXPECT_EQ(cache.getHits(), 1);
+    EXPECT_EQ(cache.getMisses(), 2);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "items/Inventory.hpp"
+#include "world/files/chunk_records.hpp"
+
+TEST(chunk_records, InventoriesEncodeDecode) {
+    ChunkInventoriesMap inventories;
+    for (uint index = 0; index < 64; index++) {
+        auto inventory = std::make_shared<Inventory>(index + 1, 40);
+        for (size_t i = 0; i < inventory->size(); i += 3) {
+            inventory->getSlot(i).set(ItemStack(1 + i % 5, 1 + index));
+        }
+        inventories[index * 7] = std::move(inventory);
+    }
+    auto fields = dv::object();
+    fields["name"] = "chest key";
+    inventories[0]->getSlot(1).set(ItemStack(42, 1, fields));
+
+    auto bytes = chunk_records::encode_inventories(inventories);
+    auto decoded = chunk_records::decode_inventories(bytes.data(), bytes.size());
+
+    ASSERT_EQ(decoded.size(), inventories.size());
+    for (const auto& [index, inventory] : inventories) {
+        const auto& other = decoded.at(index);
+        EXPECT_EQ(other->getId(), inventory->getId());
+        ASSERT_EQ(other->size(), inventory->size());
+        for (size_t i = 0; i < inventory->size(); i++) {
+            const auto& a = inventory->getSlot(i);
+            const auto& b = other->getSlot(i);
+            EXPECT_EQ(a.getItemId(), b.getItemId());
+            EXPECT_EQ(a.getCount(), b.getCount());
+            EXPECT_EQ(a.hasFields(), b.hasFields());
+        }
+    }
+    EXPECT_EQ(
+        decoded.at(0)->getSlot(1).getFields()["name"].asString(), "chest key"
+    );
+}
+
+TEST(chunk_records, InventoriesLegacy) {
+    Inventory inventory(5, 10);
+    inventory.getSlot(3).set(ItemStack(7, 12));
+
+    ByteBuilder builder;
+    builder.putInt32(1);
+    builder.putInt32(1234);
+    auto bytes = json::to_binary(inventory.serialize(), true);
+    builder.putInt32(bytes.size());
+    builder.put(bytes.data(), bytes.size());
+
+    auto decoded =
+        chunk_records::decode_inventories(builder.data(), builder.size());
+    const auto& other = decoded.at(1234);
+    EXPECT_EQ(other->getId(), 5);
+    EXPECT_EQ(other->size(), 10);
+    EXPECT_EQ(other->getSlot(3).getItemId(), 7);
+    EXPECT_EQ(other->getSlot(3).getCount(), 12);
+}
+
+TEST(chunk_records, EntitiesEncodeDecode) {
+    auto list = dv::list();
+    for (int i = 0; i < 10; i++) {
+        auto& entity = list.object();
+        entity["def"] = i % 2 ? "base:drop" : "base:player";
+        entity["uid"] = 100 + i;
+        auto& transform = entity.object("transform");
+        transform["pos"] = dv::list({1.5f, 64.0f, -3.25f});
+        if (i == 3) {
+            transform["size"] = dv::list({0.5f, 0.5f, 0.5f});
+        }
+        auto& body = entity.object("rigidbody");
+        body["vel"] = dv::list({0.0f, -9.5f, 0.0f});
+        body["damping"] = 1.0f;
+        body["type"] = "dynamic";
+        if (i == 4) {
+            body["enabled"] = false;
+            // not a part of the schema
+            body["mass"] = 0.1;
+        }
+        entity.object("comps")["base:drop"] = "data";
+    }
+
+    auto bytes = chunk_records::encode_entities(list);
+    auto root = chunk_records::decode_entities(bytes.data(), bytes.size());
+    const auto& decoded = root["data"];
+
+    ASSERT_EQ(decoded.size(), list.size());
+    for (size_t i = 0; i < list.size(); i++) {
+        const auto& a = list[i];
+        const auto& b = decoded[i];
+        EXPECT_EQ(b["def"].asString(), a["def"].asString());
+        EXPECT_EQ(b["uid"].asInteger(), a["uid"].asInteger());
+        EXPECT_EQ(b["transform"].size(), a["transform"].size());
+        EXPECT_EQ(
+            b["transform"]["pos"][2].asNumber(),
+            a["transform"]["pos"][2].asNumber()
+        );
+        EXPECT_EQ(b["rigidbody"].size(), a["rigidbody"].size());
+        EXPECT_EQ(
+            b["rigidbody"]["type"].asString(), a["rigidbody"]["type"].asString()
+        );
+        EXPECT_EQ(b["comps"]["base:drop"].asString(), "data");
+    }
+    EXPECT_FALSE(decoded[4]["rigidbody"]["enabled"].asBoolean());
+    EXPECT_EQ(decoded[4]["rigidbody"]["mass"].asNumber(), 0.1);
+}
+
+TEST(chunk_records, EntitiesLegacy) {
+    auto root = dv::object();
+    auto& entity = root.list("data").object();
+    entity["def"] = "base:drop";
+    entity["uid"] = 1;
+
+    auto bytes = json::to_binary(root);
+    auto decoded = chunk_records::decode_entities(bytes.data(), bytes.size());
+    EXPECT_EQ(decoded["data"][0]["def"].asString(), "base:drop");
+}
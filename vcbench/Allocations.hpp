@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+
+namespace vcbench {
+    /// @brief Get number of global operator new calls made since start.
+    /// vcbench replaces global operator new/delete to count them
+    size_t get_heap_allocations();
+}
@@ -0,0 +1,149 @@
+#include "BenchWorld.hpp"
+
+#include "content/Content.hpp"
+#include "content/ContentControl.hpp"
+#include "content/PacksManager.hpp"
+#include "debug/Logger.hpp"
+#include "engine/Engine.hpp"
+#include "lighting/Lighting.hpp"
+#include "logic/EngineController.hpp"
+#include "logic/LevelController.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+#include "world/generator/WorldGenerator.hpp"
+
+namespace fs = std::filesystem;
+
+using namespace vcbench;
+
+static debug::Logger logger("bench-world");
+
+static fs::path resFolder = "res";
+static fs::path userFolder = "vcbench-user";
+static std::unique_ptr<BenchWorld> instance;
+
+void BenchWorld::configure(fs::path resFolder, fs::path userFolder) {
+    ::resFolder = std::move(resFolder);
+    ::userFolder = std::move(userFolder);
+}
+
+const fs::path& BenchWorld::getResFolder() {
+    return resFolder;
+}
+
+BenchWorld& BenchWorld::get() {
+    if (instance == nullptr) {
+        instance.reset(new BenchWorld());
+    }
+    return *instance;
+}
+
+void BenchWorld::shutdown() {
+    if (instance == nullptr) {
+        return;
+    }
+    instance.reset();
+    Engine::terminate();
+    fs::remove_all(userFolder);
+}
+
+BenchWorld::BenchWorld() {
+    fs::remove_all(userFolder);
+    fs::create_directories(userFolder);
+
+    CoreParameters params;
+    params.headless = true;
+    params.testMode = true;
+    params.resFolder = resFolder;
+    params.userFolder = userFolder;
+
+    auto& engine = Engine::getInstance();
+    engine.initialize(std::move(params));
+    engine.setLevelConsumer([this, &engine](auto level, auto) {
+        controller = std::make_unique<LevelController>(
+            &engine, std::move(level), nullptr
+        );
+    });
+
+    auto& contentControl = engine.getContentControl();
+    auto& manager = contentControl.scan();
+    contentControl.setContentPacksRaw(manager.getAll(manager.assemble({"base"})));
+    engine.getController()->createWorld("vcbench", "2019", "base:demo");
+    if (controller == nullptr) {
+        throw std::runtime_error("could not create benchmark world");
+    }
+    auto& level = getLevel();
+    auto world = level.getWorld();
+    generator = std::make_unique<WorldGenerator>(
+        level.content.generators.require(world->getGenerator()),
+        level.content,
+        world->getSeed()
+    );
+    loadArea();
+}
+
+BenchWorld::~BenchWorld() {
+    lighting.reset();
+    chunks.reset();
+    loadedChunks.clear();
+    generator.reset();
+    if (controller) {
+        controller->onWorldQuit();
+        controller.reset();
+    }
+}
+
+void BenchWorld::loadArea() {
+    auto& level = getLevel();
+    const auto& indices = *level.content.getIndices();
+    int size = RADIUS * 2 + 1;
+    chunks = std::make_unique<Chunks>(
+        size, size, 0, 0, level.events.get(), indices
+    );
+    chunks->setCenter(0, 0);
+    lighting = std::make_unique<Lighting>(level.content, *chunks);
+
+    logger.info() << "generating " << size * size << " chunks";
+    generator->update(0, 0, size);
+    for (int z = -RADIUS; z <= RADIUS; z++) {
+        for (int x = -RADIUS; x <= RADIUS; x++) {
+            auto chunk = level.chunks->create(x, z, true);
+            generator->generate(chunk->voxels, x, z);
+            chunk->updateLightSources(indices);
+            chunk->updateHeights();
+            Lighting::prebuildSkyLight(*chunk, indices);
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            chunk->flags.unsaved = true;
+            chunks->putChunk(chunk);
+            loadedChunks.push_back(chunk);
+        }
+    }
+    // lights are built for chunks with all neighbours loaded only
+    for (int z = -RADIUS + 1; z < RADIUS; z++) {
+        for (int x = -RADIUS + 1; x < RADIUS; x++) {
+            lighting->buildSkyLight(x, z);
+            lighting->onChunkLoaded(x, z, true);
+            chunks->getChunk(x, z)->flags.lighted = true;
+        }
+    }
+}
+
+Level& BenchWorld::getLevel() {
+    return *controller->getLevel();
+}
+
+const Content& BenchWorld::getContent() {
+    return getLevel().content;
+}
+
+Chunks& BenchWorld::getChunks() {
+    return *chunks;
+}
+
+WorldGenerator& BenchWorld::getGenerator() {
+    return *generator;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+class Chunk;
+class Chunks;
+class Content;
+class Level;
+class LevelController;
+class Lighting;
+class WorldGenerator;
+
+namespace vcbench {
+    /// @brief Headless engine with the base content and a generated world
+    /// shared by benchmarks. Created on first use
+    class BenchWorld {
+    public:
+        /// @brief Loaded chunks area is (RADIUS * 2 + 1)^2 chunks around
+        /// the origin
+        static constexpr int RADIUS = 4;
+
+        ~BenchWorld();
+
+        /// @brief Set paths used to initialize engine
+        static void configure(
+            std::filesystem::path resFolder, std::filesystem::path userFolder
+        );
+
+        /// @brief Get resources folder without engine initialization
+        static const std::filesystem::path& getResFolder();
+
+        static BenchWorld& get();
+
+        /// @brief Close the world and the engine if it was initialized
+        static void shutdown();
+
+        Level& getLevel();
+
+        const Content& getContent();
+
+        /// @brief Chunks area with complete lights around the origin
+        Chunks& getChunks();
+
+        WorldGenerator& getGenerator();
+
+        /// @brief Loaded chunks area chunks
+        const std::vector<std::shared_ptr<Chunk>>& getLoadedChunks() const {
+            return loadedChunks;
+        }
+    private:
+        std::unique_ptr<LevelController> controller;
+        std::unique_ptr<WorldGenerator> generator;
+        std::unique_ptr<Chunks> chunks;
+        std::unique_ptr<Lighting> lighting;
+        std::vector<std::shared_ptr<Chunk>> loadedChunks;
+
+        BenchWorld();
+
+        void loadArea();
+    };
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+
+using namespace vcbench;
+
+State::State(size_t iterations, int64_t arg)
+    : iterations(iterations), arg(arg) {
+}
+
+void State::pause() {
+    if (!paused) {
+        elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       clock::now() - start
+        ).count();
+        cpuElapsed += static_cast<int64_t>(
+            static_cast<double>(std::clock() - cpuStart) * 1e9 /
+            CLOCKS_PER_SEC
+        );
+        paused = true;
+    }
+}
+
+void State::resume() {
+    if (paused) {
+        start = clock::now();
+        cpuStart = std::clock();
+        paused = false;
+    }
+}
+
+void State::stop() {
+    pause();
+}
+
+void State::skipWithError(const std::string& message) {
+    error = message;
+}
+
+static std::vector<Benchmark>& get_registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+bool vcbench::register_benchmark(
+    const std::string& name, BenchmarkFunc func, const std::vector<int64_t>& args
+) {
+    auto& benchmarks = get_registry();
+    if (args.empty()) {
+        benchmarks.push_back(Benchmark {name, name, func, 0});
+    }
+    for (int64_t arg : args) {
+        benchmarks.push_back(
+            Benchmark {name, name + "/" + std::to_string(arg), func, arg}
+        );
+    }
+    return true;
+}
+
+std::vector<Benchmark> vcbench::get_benchmarks() {
+    auto benchmarks = get_registry();
+    std::stable_sort(
+        benchmarks.begin(),
+        benchmarks.end(),
+        // arguments of the same benchmark are kept in given order
+        [](const auto& a, const auto& b) { return a.family < b.family; }
+    );
+    return benchmarks;
+}
+
+void vcbench::use_pointer(const void*) {
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vcbench {
+    /// @brief Benchmark run state. The measured code is placed inside
+    /// `while (state.next()) { ... }` loop
+    class State {
+        using clock = std::chrono::steady_clock;
+
+        size_t iterations;
+        size_t done = 0;
+        int64_t arg;
+        int64_t elapsed = 0;
+        int64_t cpuElapsed = 0;
+        clock::time_point start {};
+        std::clock_t cpuStart = 0;
+        bool paused = false;
+        size_t items = 0;
+        size_t bytes = 0;
+        std::map<std::string, double> counters;
+        std::string error;
+    public:
+        State(size_t iterations, int64_t arg);
+
+        /// @return true while there are iterations to run
+        bool next() {
+            if (done == 0) {
+                start = clock::now();
+                cpuStart = std::clock();
+            }
+            if (done == iterations || !error.empty()) {
+                stop();
+                return false;
+            }
+            done++;
+            return true;
+        }
+
+        /// @brief Stop time measurement (setup inside of the loop)
+        void pause();
+
+        /// @brief Continue time measurement stopped with pause()
+        void resume();
+
+        /// @brief Benchmark argument or 0 if the benchmark has no arguments
+        int64_t getArg() const {
+            return arg;
+        }
+
+        size_t getIterations() const {
+            return iterations;
+        }
+
+        /// @brief Set total number of items processed by all iterations.
+        /// Reported as items per second
+        void setItemsProcessed(size_t count) {
+            items = count;
+        }
+
+        /// @brief Set total number of bytes processed by all iterations.
+        /// Reported as bytes per second
+        void setBytesProcessed(size_t count) {
+            bytes = count;
+        }
+
+        /// @brief Set reported value not related to time (sizes, counts)
+        void setCounter(const std::string& name, double value) {
+            counters[name] = value;
+        }
+
+        /// @brief Stop the benchmark and report the error instead of
+        /// results
+        void skipWithError(const std::string& message);
+
+        /// @return Measured time (nanoseconds)
+        int64_t getElapsed() const {
+            return elapsed;
+        }
+
+        /// @return Measured CPU time of the process including worker
+        /// threads (nanoseconds)
+        int64_t getCpuElapsed() const {
+            return cpuElapsed;
+        }
+
+        size_t getItemsProcessed() const {
+            return items;
+        }
+
+        size_t getBytesProcessed() const {
+            return bytes;
+        }
+
+        const std::map<std::string, double>& getCounters() const {
+            return counters;
+        }
+
+        const std::string& getError() const {
+            return error;
+        }
+    private:
+        void stop();
+    };
+
+    using BenchmarkFunc = void (*)(State&);
+
+    struct Benchmark {
+        /// @brief Registered name
+        std::string family;
+        /// @brief Family name with argument
+        std::string name;
+        BenchmarkFunc func;
+        int64_t arg;
+    };
+
+    /// @brief Register benchmark. Benchmark with arguments is registered
+    /// once per argument as name/arg
+    /// @return always true, used for static registration
+    bool register_benchmark(
+        const std::string& name,
+        BenchmarkFunc func,
+        const std::vector<int64_t>& args = {}
+    );
+
+    /// @return All registered benchmarks sorted by family name
+    std::vector<Benchmark> get_benchmarks();
+
+    /// @brief Pass pointer to a function opaque for the compiler
+    void use_pointer(const void* ptr);
+
+    /// @brief Prevent the compiler from optimizing away the value
+    template <typename T>
+    inline void do_not_optimize(const T& value) {
+        use_pointer(&value);
+    }
+}
+
+/// @brief Register benchmark function with optional integer arguments
+#define VC_BENCHMARK(FUNC, NAME, ...)                      \
+    static const bool FUNC##_registered =                  \
+        vcbench::register_benchmark(NAME, FUNC, {__VA_ARGS__})
@@ -0,0 +1,251 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "Allocations.hpp"
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "coders/binary_json.hpp"
+#include "coders/gzip.hpp"
+#include "coders/json.hpp"
+#include "coders/rle.hpp"
+#include "coders/toml.hpp"
+#include "data/dv_arena.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+namespace fs = std::filesystem;
+
+using namespace vcbench;
+
+struct SourceFile {
+    std::string name;
+    std::string text;
+};
+
+/// @brief Read all files with the extension from res folder
+static const std::vector<SourceFile>& get_res_files(const std::string& ext) {
+    static std::unordered_map<std::string, std::vector<SourceFile>> files;
+    auto found = files.find(ext);
+    if (found != files.end()) {
+        return found->second;
+    }
+    auto& list = files[ext];
+    const auto& folder = BenchWorld::getResFolder();
+    for (const auto& entry : fs::recursive_directory_iterator(folder)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ext) {
+            continue;
+        }
+        std::ifstream stream(entry.path(), std::ios::binary);
+        std::stringstream ss;
+        ss << stream.rdbuf();
+        list.push_back(SourceFile {entry.path().u8string(), ss.str()});
+    }
+    if (list.empty()) {
+        throw std::runtime_error("no " + ext + " files found in res folder");
+    }
+    return list;
+}
+
+static size_t total_size(const std::vector<SourceFile>& files) {
+    size_t size = 0;
+    for (const auto& file : files) {
+        size += file.text.size();
+    }
+    return size;
+}
+
+/// @brief Voxels data of a generated chunk
+static const ubyte* get_chunk_data() {
+    static std::unique_ptr<ubyte[]> data;
+    if (data == nullptr) {
+        data = BenchWorld::get().getChunks().getChunk(0, 0)->encode();
+    }
+    return data.get();
+}
+
+static void extrle_encode(State& state) {
+    auto data = get_chunk_data();
+    auto buffer = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    size_t size = 0;
+    while (state.next()) {
+        size = extrle::encode16(data, CHUNK_DATA_LEN, buffer.get());
+        do_not_optimize(buffer[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+    state.setCounter("encoded_bytes", size);
+}
+VC_BENCHMARK(extrle_encode, "coders/extrle16/encode");
+
+static void extrle_decode(State& state) {
+    auto data = get_chunk_data();
+    auto buffer = std::make_unique<ubyte[]>(CHUNK_DATA_LEN * 2);
+    size_t size = extrle::encode16(data, CHUNK_DATA_LEN, buffer.get());
+    auto decoded = std::make_unique<ubyte[]>(CHUNK_DATA_LEN);
+    while (state.next()) {
+        extrle::decode16(buffer.get(), size, decoded.get(), CHUNK_DATA_LEN);
+        do_not_optimize(decoded[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+}
+VC_BENCHMARK(extrle_decode, "coders/extrle16/decode");
+
+static void gzip_compress(State& state) {
+    auto data = get_chunk_data();
+    size_t size = 0;
+    while (state.next()) {
+        size = gzip::compress(data, CHUNK_DATA_LEN).size();
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+    state.setCounter("compressed_bytes", size);
+}
+VC_BENCHMARK(gzip_compress, "coders/gzip/compress");
+
+static void gzip_decompress(State& state) {
+    auto compressed = gzip::compress(get_chunk_data(), CHUNK_DATA_LEN);
+    while (state.next()) {
+        auto bytes = gzip::decompress(compressed.data(), compressed.size());
+        do_not_optimize(bytes[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+}
+VC_BENCHMARK(gzip_decompress, "coders/gzip/decompress");
+
+/// @brief Count heap allocations made by parsing all files once
+/// @param arena use an arena per file
+static size_t count_parse_allocations(
+    const std::vector<SourceFile>& files, bool arena
+) {
+    size_t before = get_heap_allocations();
+    for (const auto& file : files) {
+        auto value = json::parse(
+            file.name,
+            file.text,
+            arena ? std::make_shared<dv::Arena>() : nullptr
+        );
+        do_not_optimize(value);
+    }
+    return get_heap_allocations() - before;
+}
+
+static void json_parse(State& state) {
+    const auto& files = get_res_files(".json");
+    while (state.next()) {
+        for (const auto& file : files) {
+            auto value = json::parse(file.name, file.text);
+            do_not_optimize(value);
+        }
+    }
+    state.setBytesProcessed(state.getIterations() * total_size(files));
+    state.setCounter("allocations", count_parse_allocations(files, false));
+}
+VC_BENCHMARK(json_parse, "coders/json/parse");
+
+static void json_parse_arena(State& state) {
+    const auto& files = get_res_files(".json");
+    while (state.next()) {
+        for (const auto& file : files) {
+            auto value = json::parse(
+                file.name, file.text, std::make_shared<dv::Arena>()
+            );
+            do_not_optimize(value);
+        }
+    }
+    state.setBytesProcessed(state.getIterations() * total_size(files));
+    state.setCounter("allocations", count_parse_allocations(files, true));
+}
+VC_BENCHMARK(json_parse_arena, "coders/json/parse_arena");
+
+static void json_stringify(State& state) {
+    const auto& files = get_res_files(".json");
+    std::vector<dv::value> values;
+    for (const auto& file : files) {
+        values.push_back(json::parse(file.name, file.text));
+    }
+    size_t size = 0;
+    while (state.next()) {
+        for (const auto& value : values) {
+            size += json::stringify(value, false).size();
+        }
+    }
+    state.setBytesProcessed(size);
+}
+VC_BENCHMARK(json_stringify, "coders/json/stringify");
+
+static void toml_parse(State& state) {
+    const auto& files = get_res_files(".toml");
+    while (state.next()) {
+        for (const auto& file : files) {
+            auto value = toml::parse(file.name, file.text);
+            do_not_optimize(value);
+        }
+    }
+    state.setBytesProcessed(state.getIterations() * total_size(files));
+}
+VC_BENCHMARK(toml_parse, "coders/toml/parse");
+
+/// @brief Binary json documents of all res json files
+static std::vector<std::vector<ubyte>> get_bjson_documents() {
+    std::vector<std::vector<ubyte>> documents;
+    for (const auto& file : get_res_files(".json")) {
+        auto value = json::parse(file.name, file.text);
+        if (value.isObject()) {
+            documents.push_back(json::to_binary(value));
+        }
+    }
+    return documents;
+}
+
+static void bjson_encode(State& state) {
+    std::vector<dv::value> values;
+    for (const auto& file : get_res_files(".json")) {
+        auto value = json::parse(file.name, file.text);
+        if (value.isObject()) {
+            values.push_back(std::move(value));
+        }
+    }
+    std::vector<ubyte> buffer;
+    size_t size = 0;
+    while (state.next()) {
+        for (const auto& value : values) {
+            buffer.clear();
+            json::to_binary(value, buffer);
+            size += buffer.size();
+        }
+    }
+    state.setBytesProcessed(size);
+}
+VC_BENCHMARK(bjson_encode, "coders/bjson/encode");
+
+static void bjson_decode(State& state) {
+    auto documents = get_bjson_documents();
+    size_t size = 0;
+    while (state.next()) {
+        for (const auto& document : documents) {
+            auto value = json::from_binary(document.data(), document.size());
+            do_not_optimize(value);
+            size += document.size();
+        }
+    }
+    state.setBytesProcessed(size);
+}
+VC_BENCHMARK(bjson_decode, "coders/bjson/decode");
+
+static void bjson_read_tokens(State& state) {
+    auto documents = get_bjson_documents();
+    size_t size = 0;
+    size_t tokens = 0;
+    while (state.next()) {
+        for (const auto& document : documents) {
+            json::BjsonReader reader(document.data(), document.size());
+            while (reader.next() != json::BjsonReader::Token::END_OF_INPUT) {
+                tokens++;
+            }
+            size += document.size();
+        }
+    }
+    state.setBytesProcessed(size);
+    state.setItemsProcessed(tokens);
+}
+VC_BENCHMARK(bjson_read_tokens, "coders/bjson/read_tokens");
@@ -0,0 +1,55 @@
+#include <filesystem>
+
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "content/ContentCache.hpp"
+#include "io/path.hpp"
+
+namespace fs = std::filesystem;
+
+using namespace vcbench;
+
+/// @brief Data files of the base content pack
+static const std::vector<io::path>& get_data_files() {
+    static std::vector<io::path> files;
+    if (!files.empty()) {
+        return files;
+    }
+    BenchWorld::get();
+    auto folder = BenchWorld::getResFolder() / "content" / "base";
+    for (const auto& entry : fs::recursive_directory_iterator(folder)) {
+        auto ext = entry.path().extension();
+        if (!entry.is_regular_file() || (ext != ".json" && ext != ".toml")) {
+            continue;
+        }
+        auto relative = fs::relative(entry.path(), folder).generic_u8string();
+        files.emplace_back("res:content/base/" + relative);
+    }
+    return files;
+}
+
+static void content_read(State& state, ContentCache* cache) {
+    const auto& files = get_data_files();
+    for (const auto& file : files) {
+        read_cached(cache, file);
+    }
+    while (state.next()) {
+        for (const auto& file : files) {
+            auto value = read_cached(cache, file);
+            do_not_optimize(value);
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * files.size());
+}
+
+static void content_read_parse(State& state) {
+    content_read(state, nullptr);
+}
+VC_BENCHMARK(content_read_parse, "content/read_data_files/parse");
+
+static void content_read_cache(State& state) {
+    ContentCache cache("user:vcbench-content.cache", "res:content/base");
+    content_read(state, &cache);
+    state.setCounter("misses", cache.getMisses());
+}
+VC_BENCHMARK(content_read_cache, "content/read_data_files/cache");
@@ -0,0 +1,329 @@
+#include <cmath>
+#include <set>
+
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "assets/Assets.hpp"
+#include "content/Content.hpp"
+#include "core_defs.hpp"
+#include "engine/Engine.hpp"
+#include "frontend/ContentGfxCache.hpp"
+#include "graphics/commons/Model.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "graphics/render/BlocksRenderer.hpp"
+#include "graphics/render/ChunkVisibility.hpp"
+#include "graphics/render/Emitter.hpp"
+#include "graphics/render/ParticlesSimulation.hpp"
+#include "graphics/render/TranslucentSorter.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/VoxelsVolume.hpp"
+#include "world/Level.hpp"
+
+using namespace vcbench;
+
+namespace {
+    /// @brief Blocks uv regions cache built without graphics context:
+    /// all textures are mapped to a single region of an empty atlas
+    struct GfxContext {
+        Assets assets;
+        std::unique_ptr<ContentGfxCache> cache;
+    };
+}
+
+static GfxContext& get_gfx_context() {
+    static std::unique_ptr<GfxContext> context;
+    if (context) {
+        return *context;
+    }
+    auto& world = BenchWorld::get();
+    const auto& content = world.getContent();
+    auto& settings = Engine::getInstance().getSettings();
+
+    context = std::make_unique<GfxContext>();
+    auto& assets = context->assets;
+    assets.store(
+        std::make_unique<Atlas>(
+            nullptr,
+            std::unordered_map<std::string, UVRegion> {
+                {TEXTURE_NOTFOUND, UVRegion()}},
+            false
+        ),
+        "blocks"
+    );
+    std::set<std::string> models;
+    auto add_model = [&models](const Variant& variant) {
+        if (variant.model.type == BlockModelType::CUSTOM) {
+            models.insert(variant.model.name);
+        }
+    };
+    for (auto def : content.getIndices()->blocks.getIterable()) {
+        add_model(def->defaults);
+        if (def->variants) {
+            for (const auto& variant : def->variants->variants) {
+                add_model(variant);
+            }
+        }
+    }
+    for (const auto& name : models) {
+        assets.store(std::make_unique<model::Model>(), name);
+    }
+    context->cache = std::make_unique<ContentGfxCache>(
+        content, assets, settings.graphics
+    );
+    return *context;
+}
+
+/// @brief Prepare voxels volume the same way as chunks renderer does
+static std::unique_ptr<VoxelsVolume> prepare_volume(const Chunk& chunk) {
+    constexpr int padding = 2;
+    auto volume = std::make_unique<VoxelsVolume>(
+        CHUNK_W + padding * 2, CHUNK_H, CHUNK_D + padding * 2
+    );
+    volume->setPosition(
+        chunk.x * CHUNK_W - padding, 0, chunk.z * CHUNK_D - padding
+    );
+    BenchWorld::get().getChunks().getVoxels(*volume, true, chunk.top + 1);
+    return volume;
+}
+
+/// @brief Build meshes of the chunk with graphics settings modified
+/// for the benchmark time
+static void build_mesh(State& state, bool greedy, bool packed) {
+    auto& world = BenchWorld::get();
+    auto& context = get_gfx_context();
+    auto& settings = Engine::getInstance().getSettings();
+    auto& graphics = settings.graphics;
+
+    bool prevGreedy = graphics.greedyMeshing.get();
+    bool prevPacked = graphics.packedChunkVertices.get();
+    graphics.greedyMeshing.set(greedy);
+    graphics.packedChunkVertices.set(packed);
+
+    auto chunk = world.getChunks().getChunk(0, 0);
+    auto volume = prepare_volume(*chunk);
+    BlocksRenderer renderer(
+        graphics.chunkMaxVertices.get(),
+        world.getContent(),
+        *context.cache,
+        settings
+    );
+    size_t vertices = 0;
+    size_t bytes = 0;
+    while (state.next()) {
+        renderer.build(chunk, *volume);
+        auto data = renderer.createMesh();
+        if (data.packed) {
+            vertices = data.packedMesh.vertices.size();
+            bytes = vertices * sizeof(PackedChunkVertex);
+        } else {
+            size_t tiled = data.tiledMesh.vertices.size();
+            vertices = data.mesh.vertices.size() + tiled;
+            bytes = data.mesh.vertices.size() * sizeof(ChunkVertex) +
+                    tiled * sizeof(TiledChunkVertex);
+        }
+    }
+    graphics.greedyMeshing.set(prevGreedy);
+    graphics.packedChunkVertices.set(prevPacked);
+
+    state.setItemsProcessed(state.getIterations());
+    state.setCounter("vertices", vertices);
+    state.setCounter("bytes_per_chunk", bytes);
+}
+
+static void blocks_renderer_build(State& state) {
+    build_mesh(state, false, false);
+}
+VC_BENCHMARK(blocks_renderer_build, "graphics/blocks_renderer/build");
+
+static void blocks_renderer_build_greedy(State& state) {
+    build_mesh(state, true, false);
+}
+VC_BENCHMARK(
+    blocks_renderer_build_greedy, "graphics/blocks_renderer/build_greedy"
+);
+
+static void blocks_renderer_build_packed(State& state) {
+    build_mesh(state, true, true);
+}
+VC_BENCHMARK(
+    blocks_renderer_build_packed, "graphics/blocks_renderer/build_packed"
+);
+
+static void blocks_renderer_build_lod(State& state) {
+    auto& world = BenchWorld::get();
+    auto& context = get_gfx_context();
+    auto& settings = Engine::getInstance().getSettings();
+    auto chunk = world.getChunks().getChunk(0, 0);
+    BlocksRenderer renderer(
+        settings.graphics.chunkMaxVertices.get(),
+        world.getContent(),
+        *context.cache,
+        settings
+    );
+    VoxelsVolume volume(CHUNK_W, CHUNK_H, CHUNK_D);
+    volume.setPosition(chunk->x * CHUNK_W, 0, chunk->z * CHUNK_D);
+    world.getChunks().getVoxels(volume, false, CHUNK_H);
+    size_t vertices = 0;
+    while (state.next()) {
+        renderer.buildLod(chunk, volume, state.getArg());
+        vertices = renderer.createMesh().tiledMesh.vertices.size();
+    }
+    state.setItemsProcessed(state.getIterations());
+    state.setCounter("vertices", vertices);
+}
+VC_BENCHMARK(
+    blocks_renderer_build_lod, "graphics/blocks_renderer/build_lod", 1, 2, 3
+);
+
+/// @brief Opaque cube voxels of the chunk, the same as used by
+/// BlocksRenderer to build chunk visibility
+static std::bitset<CHUNK_VOL> get_occluders(const Chunk& chunk) {
+    const auto& indices = *BenchWorld::get().getContent().getIndices();
+    std::bitset<CHUNK_VOL> occluders;
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        const auto& vox = chunk.voxels[i];
+        const auto& def = indices.blocks.require(vox.id);
+        const auto& variant = def.getVariantByBits(vox.state.userbits);
+        occluders[i] = variant.rt.solid && variant.drawGroup == 0 &&
+                       variant.culling == CullingMode::DEFAULT &&
+                       !def.translucent;
+    }
+    return occluders;
+}
+
+static void chunk_visibility_build(State& state) {
+    auto chunk = BenchWorld::get().getChunks().getChunk(0, 0);
+    auto occluders = get_occluders(*chunk);
+    ChunkVisibility visibility;
+    while (state.next()) {
+        visibility.build(occluders);
+        do_not_optimize(visibility);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+VC_BENCHMARK(chunk_visibility_build, "graphics/chunk_visibility/build");
+
+static void occlusion_culling_update(State& state) {
+    auto& chunks = BenchWorld::get().getChunks();
+    const auto& list = chunks.getChunks();
+    std::vector<ChunkVisibility> graphs(list.size());
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i]) {
+            graphs[i].build(get_occluders(*list[i]));
+        }
+    }
+    auto supplier = [&graphs](int index) -> const ChunkVisibility* {
+        return &graphs[index];
+    };
+    // camera above the surface and in a cave
+    float height = state.getArg() ? 120.0f : 20.0f;
+    OcclusionCulling culling;
+    while (state.next()) {
+        culling.update(
+            chunks.getWidth(),
+            chunks.getHeight(),
+            chunks.getOffsetX(),
+            chunks.getOffsetY(),
+            glm::vec3(8.0f, height, 8.0f),
+            nullptr,
+            supplier
+        );
+    }
+    state.setItemsProcessed(state.getIterations());
+    state.setCounter("visible", culling.countVisible());
+}
+VC_BENCHMARK(occlusion_culling_update, "graphics/occlusion_culling/update", 0, 1);
+
+/// @brief Translucent entries of a water-like layer
+static TranslucentEntries create_translucent_entries(int count) {
+    TranslucentEntries entries;
+    int side = static_cast<int>(std::sqrt(count)) + 1;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 position(
+            i % side + 0.5f,
+            60.5f + i / (side * side),
+            (i / side) % side + 0.5f
+        );
+        entries.entries.push_back(
+            {position, static_cast<uint32_t>(entries.vertexCount), 6}
+        );
+        entries.vertexCount += 6;
+    }
+    return entries;
+}
+
+/// @param incremental keep previous order while the camera moves slowly
+static void translucent_sort(State& state, bool incremental) {
+    auto entries = create_translucent_entries(state.getArg());
+    TranslucentSorter sorter;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> indices;
+    size_t step = 0;
+    while (state.next()) {
+        glm::vec3 camera(
+            8.0f + std::sin(step * 0.01f) * 4.0f,
+            70.0f,
+            8.0f + std::cos(step * 0.01f) * 4.0f
+        );
+        step++;
+        if (!incremental) {
+            order.clear();
+        }
+        sorter.sort(entries, camera, order);
+        TranslucentSorter::writeIndices(entries, order, indices);
+    }
+    state.setItemsProcessed(state.getIterations() * entries.entries.size());
+}
+
+static void translucent_sort_full(State& state) {
+    translucent_sort(state, false);
+}
+VC_BENCHMARK(translucent_sort_full, "graphics/translucent/sort_full", 4096);
+
+static void translucent_sort_incremental(State& state) {
+    translucent_sort(state, true);
+}
+VC_BENCHMARK(
+    translucent_sort_incremental, "graphics/translucent/sort_incremental", 4096
+);
+
+static void particles_simulate(State& state) {
+    auto& world = BenchWorld::get();
+    auto& chunks = world.getChunks();
+
+    ParticlesPreset preset;
+    preset.lifetime = 1e9f;
+    Emitter emitter(
+        world.getLevel(), glm::vec3(), preset, nullptr, UVRegion(), 0
+    );
+    ParticlesData particles;
+    int extent = (BenchWorld::RADIUS - 1) * CHUNK_W;
+    for (int i = 0; i < state.getArg(); i++) {
+        Particle particle {};
+        particle.emitter = &emitter;
+        particle.random = i * 7919;
+        particle.position = glm::vec3(
+            (i * 37) % (extent * 2) - extent,
+            60 + (i * 13) % 60,
+            (i * 53) % (extent * 2) - extent
+        );
+        particle.lifetime = preset.lifetime;
+        particles.add(particle);
+    }
+    ParticlesLightField lightField([&chunks](int cx, int cz) {
+        return static_cast<const Chunk*>(chunks.getChunk(cx, cz));
+    });
+    auto isObstacle = [&chunks](const glm::vec3& pos) {
+        return chunks.isObstacleAt(pos) != nullptr;
+    };
+    while (state.next()) {
+        lightField.reset(true);
+        simulate_particles(particles, 1.0f / 60.0f, isObstacle, lightField);
+    }
+    state.setItemsProcessed(state.getIterations() * particles.size());
+}
+VC_BENCHMARK(particles_simulate, "graphics/particles/simulate", 10000, 100000);
@@ -0,0 +1,139 @@
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "content/Content.hpp"
+#include "lighting/LightSolver.hpp"
+#include "lighting/Lighting.hpp"
+#include "lighting/Lightmap.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+using namespace vcbench;
+
+namespace {
+    /// @brief Copy of the benchmark world loaded area having own lightmaps
+    struct LightArea {
+        std::unique_ptr<Chunks> chunks;
+        std::unique_ptr<Lighting> lighting;
+    };
+}
+
+/// @return height of the highest non-air voxel in the column
+static int get_column_top(const Chunk& chunk, int lx, int lz) {
+    for (int y = chunk.top - 1; y > 0; y--) {
+        if (chunk.voxels[vox_index(lx, y, lz)].id != BLOCK_AIR) {
+            return y;
+        }
+    }
+    return 0;
+}
+
+/// @param torches number of torches placed on the surface of each chunk
+static LightArea create_area(int torches) {
+    auto& world = BenchWorld::get();
+    const auto& content = world.getContent();
+    const auto& indices = *content.getIndices();
+    blockid_t torch = content.blocks.require("base:torch").rt.id;
+
+    int size = BenchWorld::RADIUS * 2 + 1;
+    LightArea area;
+    area.chunks = std::make_unique<Chunks>(size, size, 0, 0, nullptr, indices);
+    area.chunks->setCenter(0, 0);
+    area.lighting = std::make_unique<Lighting>(content, *area.chunks);
+
+    for (const auto& source : world.getLoadedChunks()) {
+        auto chunk = std::make_shared<Chunk>(
+            source->x, source->z, std::make_shared<Lightmap>()
+        );
+        chunk->decode(source->encode().get());
+        for (int i = 0; i < torches; i++) {
+            int lx = (i * 7 + 3) % CHUNK_W;
+            int lz = (i * 11 + 5) % CHUNK_D;
+            int y = get_column_top(*chunk, lx, lz) + 1;
+            if (y < CHUNK_H) {
+                chunk->voxels[vox_index(lx, y, lz)] = {torch, {}};
+            }
+        }
+        chunk->updateLightSources(indices);
+        chunk->updateHeights();
+        chunk->flags.loaded = true;
+        chunk->flags.ready = true;
+        area.chunks->putChunk(chunk);
+    }
+    return area;
+}
+
+/// @brief Build lights of a loaded area from scratch the same way as
+/// chunks controller does when chunks are loaded
+static void bootstrap_lights(LightArea& area, const ContentIndices& indices) {
+    area.lighting->clear();
+    for (const auto& chunk : area.chunks->getChunks()) {
+        Lighting::prebuildSkyLight(*chunk, indices);
+    }
+    for (int z = -BenchWorld::RADIUS + 1; z < BenchWorld::RADIUS; z++) {
+        for (int x = -BenchWorld::RADIUS + 1; x < BenchWorld::RADIUS; x++) {
+            area.lighting->buildSkyLight(x, z);
+            area.lighting->onChunkLoaded(x, z, true);
+        }
+    }
+}
+
+static void lighting_bootstrap(State& state) {
+    int torches = state.getArg();
+    auto area = create_area(torches);
+    const auto& indices = *BenchWorld::get().getContent().getIndices();
+    size_t lighted = (BenchWorld::RADIUS * 2 - 1) * (BenchWorld::RADIUS * 2 - 1);
+    while (state.next()) {
+        bootstrap_lights(area, indices);
+    }
+    state.setItemsProcessed(state.getIterations() * lighted);
+}
+// 0 is a typical generated area, 64 is a torch-dense one
+VC_BENCHMARK(lighting_bootstrap, "lighting/bootstrap", 0, 64);
+
+static void lighting_prebuild_sky_light(State& state) {
+    auto area = create_area(0);
+    const auto& indices = *BenchWorld::get().getContent().getIndices();
+    auto& chunk = *area.chunks->getChunk(0, 0);
+    while (state.next()) {
+        Lighting::prebuildSkyLight(chunk, indices);
+        do_not_optimize(chunk.lightmap->map[0]);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+VC_BENCHMARK(lighting_prebuild_sky_light, "lighting/prebuild_sky_light");
+
+/// @brief Add light emitters on the surface and remove them solving
+/// lights after each step
+static void lighting_solver_add_remove(State& state) {
+    auto area = create_area(0);
+    const auto& indices = *BenchWorld::get().getContent().getIndices();
+    bootstrap_lights(area, indices);
+
+    std::vector<glm::ivec3> emitters;
+    int extent = (BenchWorld::RADIUS - 1) * CHUNK_W;
+    for (int i = 0; i < state.getArg(); i++) {
+        int x = (i * 37) % (extent * 2) - extent;
+        int z = (i * 53) % (extent * 2) - extent;
+        auto chunk = area.chunks->getChunkByVoxel(x, 0, z);
+        int y = get_column_top(
+            *chunk, x - chunk->x * CHUNK_W, z - chunk->z * CHUNK_D
+        ) + 1;
+        emitters.emplace_back(x, std::min(y, CHUNK_H - 1), z);
+    }
+    LightSolver solver(indices, *area.chunks, 0);
+    while (state.next()) {
+        for (const auto& pos : emitters) {
+            solver.add(pos.x, pos.y, pos.z, 15);
+        }
+        solver.solve();
+        for (const auto& pos : emitters) {
+            solver.remove(pos.x, pos.y, pos.z);
+        }
+        solver.solve();
+    }
+    state.setItemsProcessed(state.getIterations() * emitters.size());
+}
+VC_BENCHMARK(
+    lighting_solver_add_remove, "lighting/solver/add_remove", 16, 256
+);
@@ -0,0 +1,162 @@
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "constants.hpp"
+#include "content/Content.hpp"
+#include "objects/Entities.hpp"
+#include "objects/Entity.hpp"
+#include "objects/Rigidbody.hpp"
+#include "physics/SpatialHash.hpp"
+#include "world/Level.hpp"
+
+using namespace vcbench;
+
+/// @brief Simulation step used by the engine (60 ticks per second)
+static constexpr float PHYSICS_DELTA = 1.0f / 60.0f;
+
+/// @brief Boxes of entity-like objects moving over a 256x256 area
+static std::vector<AABB> create_boxes(size_t count, size_t step) {
+    std::vector<AABB> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 pos(
+            (i * 37 + step) % 256, 60.0f + (i * 13) % 16, (i * 53) % 256
+        );
+        boxes.emplace_back(pos, pos + glm::vec3(0.5f, 1.8f, 0.5f));
+    }
+    return boxes;
+}
+
+static bool intersects(const AABB& a, const AABB& b) {
+    return a.a.x <= b.b.x && a.b.x >= b.a.x && a.a.y <= b.b.y &&
+           a.b.y >= b.a.y && a.a.z <= b.b.z && a.b.z >= b.a.z;
+}
+
+/// @brief Move all objects and find neighbours of each one
+static void broadphase_spatial_hash(State& state) {
+    size_t count = state.getArg();
+    SpatialHash hash(4.0f);
+    std::vector<SpatialHash::id_t> found;
+    size_t pairs = 0;
+    size_t step = 0;
+    while (state.next()) {
+        state.pause();
+        auto boxes = create_boxes(count, step++);
+        state.resume();
+        for (size_t i = 0; i < count; i++) {
+            hash.update(i, boxes[i]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            hash.query(boxes[i], found);
+            pairs += found.size();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+    state.setCounter(
+        "pairs", pairs / static_cast<double>(state.getIterations())
+    );
+}
+VC_BENCHMARK(
+    broadphase_spatial_hash,
+    "physics/broadphase/spatial_hash",
+    1000,
+    10000,
+    50000
+);
+
+/// @brief All pairs check the spatial hash replaced
+static void broadphase_brute_force(State& state) {
+    size_t count = state.getArg();
+    size_t pairs = 0;
+    size_t step = 0;
+    while (state.next()) {
+        state.pause();
+        auto boxes = create_boxes(count, step++);
+        state.resume();
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < count; j++) {
+                pairs += intersects(boxes[i], boxes[j]);
+            }
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+    state.setCounter(
+        "pairs", pairs / static_cast<double>(state.getIterations())
+    );
+}
+VC_BENCHMARK(broadphase_brute_force, "physics/broadphase/brute_force", 1000);
+
+/// @brief Spawn drops over the benchmark world lighted area
+static std::vector<entityid_t> spawn_drops(size_t count, float height) {
+    auto& level = BenchWorld::get().getLevel();
+    const auto& def = level.content.entities.require("base:drop");
+    int extent = (BenchWorld::RADIUS - 1) * CHUNK_W;
+    std::vector<entityid_t> ids;
+    ids.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 pos(
+            (i * 37) % (extent * 2) - extent + 0.5f,
+            height + (i * 13) % 32,
+            (i * 53) % (extent * 2) - extent + 0.5f
+        );
+        ids.push_back(level.entities->spawn(def, pos));
+    }
+    return ids;
+}
+
+static void despawn_all(const std::vector<entityid_t>& ids) {
+    auto& entities = *BenchWorld::get().getLevel().entities;
+    for (auto id : ids) {
+        entities.despawn(id);
+    }
+    entities.clean();
+}
+
+/// @brief Bodies are lifted back when they land, so all of them are
+/// integrated on every step
+static void entities_falling(State& state) {
+    auto& entities = *BenchWorld::get().getLevel().entities;
+    auto ids = spawn_drops(state.getArg(), 200.0f);
+    while (state.next()) {
+        entities.updatePhysics(PHYSICS_DELTA);
+
+        state.pause();
+        for (auto id : ids) {
+            auto entity = entities.get(id);
+            if (!entity) {
+                continue;
+            }
+            auto& rigidbody = entity->getRigidbody();
+            if (rigidbody.hitbox.grounded || rigidbody.sleeping) {
+                rigidbody.hitbox.position.y = 200.0f;
+                rigidbody.hitbox.velocity = glm::vec3(0.0f);
+                rigidbody.wakeUp();
+            }
+        }
+        state.resume();
+    }
+    state.setItemsProcessed(state.getIterations() * ids.size());
+    state.setCounter("active", entities.getActiveBodiesCount());
+    despawn_all(ids);
+}
+VC_BENCHMARK(entities_falling, "physics/entities/falling", 1000, 10000);
+
+/// @brief Bodies resting on the ground are put to sleep and skipped
+static void entities_sleeping(State& state) {
+    auto& entities = *BenchWorld::get().getLevel().entities;
+    auto ids = spawn_drops(state.getArg(), 140.0f);
+    // let bodies land and fall asleep
+    for (int i = 0; i < 60 * 30; i++) {
+        entities.updatePhysics(PHYSICS_DELTA);
+        if (entities.getActiveBodiesCount() == 0) {
+            break;
+        }
+    }
+    while (state.next()) {
+        entities.updatePhysics(PHYSICS_DELTA);
+    }
+    state.setItemsProcessed(state.getIterations() * ids.size());
+    state.setCounter("active", entities.getActiveBodiesCount());
+    state.setCounter("sleeping", entities.getSleepingBodiesCount());
+    despawn_all(ids);
+}
+VC_BENCHMARK(entities_sleeping, "physics/entities/sleeping", 20000);
@@ -0,0 +1,76 @@
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "constants.hpp"
+#include "logic/scripting/lua/lua_engine.hpp"
+#include "logic/scripting/lua/lua_util.hpp"
+
+using namespace vcbench;
+
+/// @brief Count non-air blocks of a chunk with block.get calls and
+/// through a chunk view
+static const std::string SCAN_SCRIPT = R"(
+function __vcbench_scan_block_get(cx, cz)
+    local count = 0
+    local ox, oz = cx * 16, cz * 16
+    for y = 0, 255 do
+        for z = oz, oz + 15 do
+            for x = ox, ox + 15 do
+                if block.get(x, y, z) > 0 then
+                    count = count + 1
+                end
+            end
+        end
+    end
+    return count
+end
+
+function __vcbench_scan_chunk_view(cx, cz)
+    local view = world.open_chunk_view(cx, cz)
+    local voxels = view.voxels
+    local count = 0
+    for i = 0, view.volume - 1 do
+        if voxels[i].id > 0 then
+            count = count + 1
+        end
+    end
+    view:close()
+    return count
+end
+)";
+
+static lua::State* get_scan_state() {
+    static lua::State* state = nullptr;
+    if (state == nullptr) {
+        BenchWorld::get();
+        auto L = lua::get_main_state();
+        lua::loadbuffer(L, 0, SCAN_SCRIPT, "<vcbench>");
+        lua::call(L, 0, 0);
+        state = L;
+    }
+    return state;
+}
+
+static void chunk_scan(State& state, const std::string& function) {
+    auto L = get_scan_state();
+    lua::Integer count = 0;
+    while (state.next()) {
+        lua::getglobal(L, function);
+        lua::pushinteger(L, 0);
+        lua::pushinteger(L, 0);
+        lua::call(L, 2, 1);
+        count = lua::tointeger(L, -1);
+        lua::pop(L);
+    }
+    state.setItemsProcessed(state.getIterations() * CHUNK_VOL);
+    state.setCounter("blocks", count);
+}
+
+static void chunk_scan_block_get(State& state) {
+    chunk_scan(state, "__vcbench_scan_block_get");
+}
+VC_BENCHMARK(chunk_scan_block_get, "scripting/chunk_scan/block_get");
+
+static void chunk_scan_chunk_view(State& state) {
+    chunk_scan(state, "__vcbench_scan_chunk_view");
+}
+VC_BENCHMARK(chunk_scan_chunk_view, "scripting/chunk_scan/chunk_view");
@@ -0,0 +1,195 @@
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "Benchmark.hpp"
+#include "util/AreaMap2D.hpp"
+#include "util/SPSCQueue.hpp"
+#include "util/SmallHeap.hpp"
+#include "util/ThreadPool.hpp"
+
+using namespace vcbench;
+
+/// @brief Blocks metadata-like usage: entries of random voxel indices
+/// allocated, looked up and freed
+static void small_heap(State& state) {
+    constexpr int count = 256;
+    util::SmallHeap<uint16_t, uint8_t> heap;
+    while (state.next()) {
+        for (int i = 0; i < count; i++) {
+            heap.allocate((i * 7919) % 65536, 4 + i % 16);
+        }
+        for (int i = 0; i < count; i++) {
+            do_not_optimize(heap.find((i * 7919) % 65536));
+        }
+        for (int i = 0; i < count; i++) {
+            heap.free(heap.find((i * 7919) % 65536));
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * count);
+}
+VC_BENCHMARK(small_heap, "util/small_heap/allocate_find_free");
+
+static void area_map_get(State& state) {
+    int size = state.getArg();
+    util::AreaMap2D<int, int> map(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            map.set(x, y, x + y + 1);
+        }
+    }
+    int64_t sum = 0;
+    while (state.next()) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                sum += map.get(x, y);
+            }
+        }
+    }
+    do_not_optimize(sum);
+    state.setItemsProcessed(state.getIterations() * size * size);
+}
+VC_BENCHMARK(area_map_get, "util/area_map/get", 32, 256);
+
+/// @brief Area following a moving player
+static void area_map_translate(State& state) {
+    int size = state.getArg();
+    util::AreaMap2D<int, int> map(size, size);
+    int center = 0;
+    while (state.next()) {
+        state.pause();
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                map.set(
+                    map.getOffsetX() + x, map.getOffsetY() + y, x + y + 1
+                );
+            }
+        }
+        state.resume();
+        center++;
+        map.setCenter(center, center);
+    }
+    state.setItemsProcessed(state.getIterations() * size * size);
+}
+VC_BENCHMARK(area_map_translate, "util/area_map/translate", 32, 256);
+
+/// @brief Results pushed by every producer thread per iteration
+static constexpr int RESULTS_PER_PRODUCER = 4096;
+
+/// @brief Main thread work done per result (mesh upload-like)
+static void consume_result(int value) {
+    int64_t sum = value;
+    for (int i = 0; i < 64; i++) {
+        sum = sum * 31 + i;
+    }
+    do_not_optimize(sum);
+}
+
+/// @brief Previous thread pool results scheme: shared queue guarded by a
+/// mutex held by the main thread while consuming
+static void result_queue_mutex(State& state) {
+    int producers = state.getArg();
+    size_t total = static_cast<size_t>(producers) * RESULTS_PER_PRODUCER;
+    while (state.next()) {
+        std::queue<int> results;
+        std::mutex mutex;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&results, &mutex]() {
+                for (int i = 0; i < RESULTS_PER_PRODUCER; i++) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results.push(i);
+                }
+            });
+        }
+        size_t consumed = 0;
+        while (consumed < total) {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!results.empty()) {
+                consume_result(results.front());
+                results.pop();
+                consumed++;
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * total);
+}
+VC_BENCHMARK(result_queue_mutex, "util/result_queue/mutex", 16, 32);
+
+/// @brief Per-producer bounded lock-free rings, producers spin on full ring
+static void result_queue_spsc(State& state) {
+    int producers = state.getArg();
+    size_t total = static_cast<size_t>(producers) * RESULTS_PER_PRODUCER;
+    while (state.next()) {
+        std::vector<std::unique_ptr<util::SPSCQueue<int>>> rings;
+        for (int p = 0; p < producers; p++) {
+            rings.push_back(std::make_unique<util::SPSCQueue<int>>(64));
+        }
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([ring = rings[p].get()]() {
+                for (int i = 0; i < RESULTS_PER_PRODUCER; i++) {
+                    int value = i;
+                    while (!ring->tryPush(std::move(value))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        size_t consumed = 0;
+        while (consumed < total) {
+            for (auto& ring : rings) {
+                while (auto value = ring->tryPop()) {
+                    consume_result(*value);
+                    consumed++;
+                }
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * total);
+}
+VC_BENCHMARK(result_queue_spsc, "util/result_queue/spsc", 16, 32);
+
+namespace {
+    class IdentityWorker : public util::Worker<int, int> {
+    public:
+        int operator()(const int& value) override {
+            return value;
+        }
+    };
+}
+
+/// @brief util::ThreadPool with tiny jobs, so results delivery dominates.
+/// Number of workers is limited by hardware concurrency
+static void thread_pool_results(State& state) {
+    using Pool = util::ThreadPool<int, int>;
+    size_t total = 0;
+    Pool pool(
+        "vcbench-pool",
+        []() { return std::make_shared<IdentityWorker>(); },
+        [&total](int& result) {
+            consume_result(result);
+            total++;
+        },
+        state.getArg()
+    );
+    size_t jobs = pool.getWorkersCount() * RESULTS_PER_PRODUCER;
+    while (state.next()) {
+        size_t expected = total + jobs;
+        for (size_t i = 0; i < jobs; i++) {
+            pool.enqueueJob(i);
+        }
+        while (total < expected) {
+            pool.update();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * jobs);
+    state.setCounter("workers", pool.getWorkersCount());
+}
+VC_BENCHMARK(thread_pool_results, "util/thread_pool/results", 16, 32);
@@ -0,0 +1,303 @@
+#include <thread>
+
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "content/Content.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/EncodedChunksCache.hpp"
+#include "voxels/Pathfinding.hpp"
+#include "voxels/compressed_chunks.hpp"
+#include "world/Level.hpp"
+#include "world/files/WorldRegions.hpp"
+
+using namespace vcbench;
+
+/// @brief Number of chunks modified between clients requests
+static constexpr int MODIFIED_CHUNKS = 8;
+
+static Chunk& get_chunk() {
+    return *BenchWorld::get().getChunks().getChunk(0, 0);
+}
+
+static void chunk_encode(State& state) {
+    auto& chunk = get_chunk();
+    while (state.next()) {
+        auto data = chunk.encode();
+        do_not_optimize(data[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+}
+VC_BENCHMARK(chunk_encode, "voxels/chunk/encode");
+
+static void chunk_decode(State& state) {
+    auto data = get_chunk().encode();
+    Chunk chunk(0, 0);
+    while (state.next()) {
+        chunk.decode(data.get());
+        do_not_optimize(chunk.voxels[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+}
+VC_BENCHMARK(chunk_decode, "voxels/chunk/decode");
+
+static void compressed_encode(State& state) {
+    auto& chunk = get_chunk();
+    size_t size = 0;
+    while (state.next()) {
+        size = compressed_chunks::encode(chunk).size();
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+    state.setCounter("bytes_per_chunk", size);
+}
+VC_BENCHMARK(compressed_encode, "voxels/compressed_chunks/encode");
+
+static void compressed_decode(State& state) {
+    auto& world = BenchWorld::get();
+    const auto& indices = *world.getContent().getIndices();
+    auto bytes = compressed_chunks::encode(get_chunk());
+    Chunk chunk(0, 0);
+    while (state.next()) {
+        compressed_chunks::decode(chunk, bytes.data(), bytes.size(), indices);
+        do_not_optimize(chunk.voxels[0]);
+    }
+    state.setBytesProcessed(state.getIterations() * CHUNK_DATA_LEN);
+}
+VC_BENCHMARK(compressed_decode, "voxels/compressed_chunks/decode");
+
+static void compressed_encode_delta(State& state) {
+    auto& world = BenchWorld::get();
+    const auto& indices = *world.getContent().getIndices();
+    auto bytes = compressed_chunks::encode(get_chunk());
+    Chunk chunk(0, 0);
+    compressed_chunks::decode(chunk, bytes.data(), bytes.size(), indices);
+
+    uint64_t since = chunk.journal.getVersion();
+    int changes = state.getArg();
+    for (int i = 0; i < changes; i++) {
+        chunk.journal.record((i * 7919) % CHUNK_VOL);
+    }
+    size_t size = 0;
+    while (state.next()) {
+        size = compressed_chunks::encode_delta(chunk, since).size();
+    }
+    state.setItemsProcessed(state.getIterations() * changes);
+    state.setCounter("delta_bytes", size);
+    state.setCounter("full_bytes", bytes.size());
+}
+VC_BENCHMARK(
+    compressed_encode_delta, "voxels/compressed_chunks/encode_delta", 16, 128
+);
+
+/// @brief Regions storage in the benchmark world user folder
+static WorldRegions& get_regions() {
+    static std::unique_ptr<WorldRegions> regions;
+    if (regions == nullptr) {
+        BenchWorld::get();
+        regions = std::make_unique<WorldRegions>("user:vcbench-regions");
+    }
+    return *regions;
+}
+
+/// @brief Chunks which may be written to regions
+static std::vector<Chunk*> get_lighted_chunks() {
+    std::vector<Chunk*> chunks;
+    for (const auto& chunk : BenchWorld::get().getLoadedChunks()) {
+        if (chunk->flags.lighted) {
+            chunks.push_back(chunk.get());
+        }
+    }
+    return chunks;
+}
+
+static void regions_put(State& state) {
+    auto& regions = get_regions();
+    auto chunks = get_lighted_chunks();
+    while (state.next()) {
+        for (auto chunk : chunks) {
+            regions.put(chunk, nullptr);
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * chunks.size());
+}
+VC_BENCHMARK(regions_put, "voxels/regions/put");
+
+static void regions_get(State& state) {
+    auto& regions = get_regions();
+    auto chunks = get_lighted_chunks();
+    for (auto chunk : chunks) {
+        regions.put(chunk, nullptr);
+    }
+    auto buffer = std::make_unique<ubyte[]>(CHUNK_DATA_LEN);
+    while (state.next()) {
+        for (auto chunk : chunks) {
+            if (!regions.getVoxels(chunk->x, chunk->z, buffer.get())) {
+                state.skipWithError("chunk is not found in regions");
+            }
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * chunks.size());
+    state.setBytesProcessed(
+        state.getIterations() * chunks.size() * CHUNK_DATA_LEN
+    );
+}
+VC_BENCHMARK(regions_get, "voxels/regions/get");
+
+static void regions_write_all(State& state) {
+    auto& regions = get_regions();
+    auto chunks = get_lighted_chunks();
+    while (state.next()) {
+        state.pause();
+        for (auto chunk : chunks) {
+            regions.put(chunk, nullptr);
+        }
+        state.resume();
+        regions.writeAll();
+    }
+    state.setItemsProcessed(state.getIterations() * chunks.size());
+}
+VC_BENCHMARK(regions_write_all, "voxels/regions/write_all");
+
+/// @brief Every client requests all loaded chunks, some of them are
+/// modified since the previous requests
+template <bool cached>
+static void serve_clients(State& state) {
+    const auto& chunks = BenchWorld::get().getLoadedChunks();
+    int clients = state.getArg();
+    EncodedChunksCache cache(chunks.size());
+    size_t step = 0;
+
+    auto client = [&chunks, &cache]() {
+        for (const auto& chunk : chunks) {
+            if constexpr (cached) {
+                auto payload = cache.fetch(*chunk);
+                do_not_optimize(payload);
+            } else {
+                auto bytes = compressed_chunks::encode(*chunk);
+                do_not_optimize(bytes[0]);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(clients);
+    while (state.next()) {
+        for (int i = 0; i < MODIFIED_CHUNKS; i++) {
+            chunks[(step++ * 31) % chunks.size()]->journal.touch();
+        }
+        for (int i = 0; i < clients; i++) {
+            threads.emplace_back(client);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        threads.clear();
+    }
+    state.setItemsProcessed(state.getIterations() * clients * chunks.size());
+    if constexpr (cached) {
+        state.setCounter("hits", cache.getHits());
+        state.setCounter("misses", cache.getMisses());
+    }
+}
+
+static void serve_clients_cached(State& state) {
+    serve_clients<true>(state);
+}
+VC_BENCHMARK(
+    serve_clients_cached, "voxels/encoded_chunks_cache/clients", 1, 4, 16
+);
+
+static void serve_clients_uncached(State& state) {
+    serve_clients<false>(state);
+}
+VC_BENCHMARK(serve_clients_uncached, "voxels/encode_chunks/clients", 1, 4, 16);
+
+/// @brief Find surface positions in the benchmark world lighted area
+static std::vector<glm::ivec3> get_surface_positions() {
+    auto& world = BenchWorld::get();
+    const auto& indices = *world.getContent().getIndices();
+    const auto& chunks = world.getChunks();
+
+    std::vector<glm::ivec3> positions;
+    int extent = (BenchWorld::RADIUS - 1) * CHUNK_W;
+    for (int z = -extent; z < extent; z += 5) {
+        for (int x = -extent; x < extent; x += 5) {
+            for (int y = CHUNK_H - 2; y > 0; y--) {
+                auto vox = chunks.get(x, y, z);
+                if (vox && indices.blocks.require(vox->id).obstacle) {
+                    positions.emplace_back(x, y + 1, z);
+                    break;
+                }
+            }
+        }
+    }
+    if (positions.empty()) {
+        throw std::runtime_error("no surface positions found");
+    }
+    return positions;
+}
+
+/// @brief Create agents with routes between random surface positions
+static std::vector<int> create_agents(voxels::Pathfinding& pathfinding, int count) {
+    static auto positions = get_surface_positions();
+    std::vector<int> agents;
+    for (int i = 0; i < count; i++) {
+        int id = pathfinding.createAgent();
+        auto agent = pathfinding.getAgent(id);
+        agent->enabled = true;
+        agent->start = positions[(i * 13) % positions.size()];
+        agent->target = positions[(i * 29 + 7) % positions.size()];
+        agents.push_back(id);
+    }
+    return agents;
+}
+
+static void pathfinding_async(State& state) {
+    auto& pathfinding = *BenchWorld::get().getLevel().pathfinding;
+    auto agents = create_agents(pathfinding, state.getArg());
+    size_t found = 0;
+    while (state.next()) {
+        for (int id : agents) {
+            pathfinding.performAsync(id);
+        }
+        bool searching = true;
+        while (searching) {
+            pathfinding.update();
+            searching = false;
+            for (int id : agents) {
+                searching |= pathfinding.getAgent(id)->searching;
+            }
+            if (searching) {
+                std::this_thread::yield();
+            }
+        }
+        for (int id : agents) {
+            found += pathfinding.getAgent(id)->route.found;
+        }
+    }
+    for (int id : agents) {
+        pathfinding.removeAgent(id);
+    }
+    state.setItemsProcessed(state.getIterations() * agents.size());
+    state.setCounter("found", found / static_cast<double>(state.getIterations()));
+}
+VC_BENCHMARK(pathfinding_async, "voxels/pathfinding/async", 100, 1000);
+
+static void pathfinding_sync(State& state) {
+    auto& pathfinding = *BenchWorld::get().getLevel().pathfinding;
+    auto agents = create_agents(pathfinding, state.getArg());
+    size_t found = 0;
+    while (state.next()) {
+        for (int id : agents) {
+            auto agent = pathfinding.getAgent(id);
+            agent->route = pathfinding.perform(*agent);
+            found += agent->route.found;
+        }
+    }
+    for (int id : agents) {
+        pathfinding.removeAgent(id);
+    }
+    state.setItemsProcessed(state.getIterations() * agents.size());
+    state.setCounter("found", found / static_cast<double>(state.getIterations()));
+}
+VC_BENCHMARK(pathfinding_sync, "voxels/pathfinding/sync", 100, 1000);
@@ -0,0 +1,237 @@
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
+#include "content/Content.hpp"
+#include "items/Inventory.hpp"
+#include "voxels/Chunk.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+#include "world/files/chunk_records.hpp"
+#include "world/generator/WorldGenerator.hpp"
+
+using namespace vcbench;
+
+/// @brief Generate chunks of a row moving away from the loaded area,
+/// so generator prototypes and heightmaps are not reused
+static void generator_generate(State& state) {
+    auto& level = BenchWorld::get().getLevel();
+    auto world = level.getWorld();
+    WorldGenerator generator(
+        level.content.generators.require(world->getGenerator()),
+        level.content,
+        world->getSeed()
+    );
+    auto voxels = std::make_unique<voxel[]>(CHUNK_VOL);
+    int x = 1000;
+    while (state.next()) {
+        generator.update(x, 0, 1);
+        generator.generate(voxels.get(), x, 0);
+        x++;
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+VC_BENCHMARK(generator_generate, "world/generator/generate");
+
+/// @brief Chunk filled with chests: 8 layers of 16x16 chests, 40 slots
+/// each, two thirds of slots are occupied
+static ChunkInventoriesMap create_chests_chunk() {
+    ChunkInventoriesMap inventories;
+    for (uint index = 0; index < CHUNK_W * CHUNK_D * 8; index++) {
+        auto inventory = std::make_shared<Inventory>(index + 1, 40);
+        for (size_t i = 0; i < inventory->size(); i++) {
+            if (i % 3 != 2) {
+                inventory->getSlot(i).set(
+                    ItemStack(1 + (index + i) % 24, 1 + (index * 7 + i) % 64)
+                );
+            }
+        }
+        inventories[index] = std::move(inventory);
+    }
+    return inventories;
+}
+
+/// @brief Dropped items lying over the chunk
+static dv::value create_entities_list() {
+    auto list = dv::list();
+    for (int i = 0; i < 256; i++) {
+        auto& entity = list.object();
+        entity["def"] = "base:drop";
+        entity["uid"] = 1000 + i;
+        auto& transform = entity.object("transform");
+        transform["pos"] = dv::list(
+            {i % 16 + 0.5f, 64.0f + i % 3, i / 16 + 0.5f}
+        );
+        auto& body = entity.object("rigidbody");
+        body["vel"] = dv::list({0.0f, 0.0f, 0.0f});
+        body["damping"] = 1.0f;
+        body["type"] = "dynamic";
+        auto& item = entity.object("comps").object("base:drop");
+        item["id"] = "base:stone.item";
+        item["count"] = 1 + i % 64;
+    }
+    return list;
+}
+
+/// @brief Previous format: per-inventory gzipped bjson documents
+static std::vector<ubyte> encode_legacy_inventories(
+    const ChunkInventoriesMap& inventories
+) {
+    ByteBuilder builder;
+    builder.putInt32(inventories.size());
+    for (const auto& [index, inventory] : inventories) {
+        builder.putInt32(index);
+        auto bytes = json::to_binary(inventory->serialize(), true);
+        builder.putInt32(bytes.size());
+        builder.put(bytes.data(), bytes.size());
+    }
+    return builder.build();
+}
+
+/// @param legacy previous format (per-inventory gzip),
+/// otherwise native record gzipped once as done by regions layer
+static void inventories_encode(State& state, bool legacy) {
+    auto inventories = create_chests_chunk();
+    size_t size = 0;
+    while (state.next()) {
+        if (legacy) {
+            size = encode_legacy_inventories(inventories).size();
+        } else {
+            auto bytes = chunk_records::encode_inventories(inventories);
+            size = gzip::compress(bytes.data(), bytes.size()).size();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * inventories.size());
+    state.setCounter("bytes", size);
+}
+
+static void inventories_decode(State& state, bool legacy) {
+    auto inventories = create_chests_chunk();
+    std::vector<ubyte> bytes;
+    if (legacy) {
+        bytes = encode_legacy_inventories(inventories);
+    } else {
+        auto record = chunk_records::encode_inventories(inventories);
+        bytes = gzip::compress(record.data(), record.size());
+    }
+    while (state.next()) {
+        if (legacy) {
+            do_not_optimize(
+                chunk_records::decode_inventories(bytes.data(), bytes.size())
+            );
+        } else {
+            auto record = gzip::decompress(bytes.data(), bytes.size());
+            do_not_optimize(
+                chunk_records::decode_inventories(record.data(), record.size())
+            );
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * inventories.size());
+    state.setCounter("bytes", bytes.size());
+}
+
+static void chunk_records_inventories_encode(State& state) {
+    inventories_encode(state, false);
+}
+VC_BENCHMARK(
+    chunk_records_inventories_encode, "world/chunk_records/inventories_encode"
+);
+
+static void chunk_records_inventories_encode_legacy(State& state) {
+    inventories_encode(state, true);
+}
+VC_BENCHMARK(
+    chunk_records_inventories_encode_legacy,
+    "world/chunk_records/inventories_encode_legacy"
+);
+
+static void chunk_records_inventories_decode(State& state) {
+    inventories_decode(state, false);
+}
+VC_BENCHMARK(
+    chunk_records_inventories_decode, "world/chunk_records/inventories_decode"
+);
+
+static void chunk_records_inventories_decode_legacy(State& state) {
+    inventories_decode(state, true);
+}
+VC_BENCHMARK(
+    chunk_records_inventories_decode_legacy,
+    "world/chunk_records/inventories_decode_legacy"
+);
+
+/// @param legacy previous format: uncompressed bjson document
+static void entities_encode(State& state, bool legacy) {
+    auto list = create_entities_list();
+    auto root = dv::object();
+    root["data"] = list;
+    size_t size = 0;
+    while (state.next()) {
+        if (legacy) {
+            size = json::to_binary(root).size();
+        } else {
+            auto bytes = chunk_records::encode_entities(list);
+            size = gzip::compress(bytes.data(), bytes.size()).size();
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * list.size());
+    state.setCounter("bytes", size);
+}
+
+static void entities_decode(State& state, bool legacy) {
+    auto list = create_entities_list();
+    std::vector<ubyte> bytes;
+    if (legacy) {
+        auto root = dv::object();
+        root["data"] = list;
+        bytes = json::to_binary(root);
+    } else {
+        auto record = chunk_records::encode_entities(list);
+        bytes = gzip::compress(record.data(), record.size());
+    }
+    while (state.next()) {
+        if (legacy) {
+            do_not_optimize(
+                chunk_records::decode_entities(bytes.data(), bytes.size())
+            );
+        } else {
+            auto record = gzip::decompress(bytes.data(), bytes.size());
+            do_not_optimize(
+                chunk_records::decode_entities(record.data(), record.size())
+            );
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * list.size());
+    state.setCounter("bytes", bytes.size());
+}
+
+static void chunk_records_entities_encode(State& state) {
+    entities_encode(state, false);
+}
+VC_BENCHMARK(
+    chunk_records_entities_encode, "world/chunk_records/entities_encode"
+);
+
+static void chunk_records_entities_encode_legacy(State& state) {
+    entities_encode(state, true);
+}
+VC_BENCHMARK(
+    chunk_records_entities_encode_legacy,
+    "world/chunk_records/entities_encode_legacy"
+);
+
+static void chunk_records_entities_decode(State& state) {
+    entities_decode(state, false);
+}
+VC_BENCHMARK(
+    chunk_records_entities_decode, "world/chunk_records/entities_decode"
+);
+
+static void chunk_records_entities_decode_legacy(State& state) {
+    entities_decode(state, true);
+}
+VC_BENCHMARK(
+    chunk_records_entities_decode_legacy,
+    "world/chunk_records/entities_decode_legacy"
+);
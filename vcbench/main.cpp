@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <thread>
+
+#include "Benchmark.hpp"
+#include "BenchWorld.hpp"
+#include "coders/json.hpp"
+#include "constants.hpp"
+#include "debug/Logger.hpp"
+#include "util/ArgsReader.hpp"
+
+namespace fs = std::filesystem;
+
+using namespace vcbench;
+
+/// @brief Upper limit of iterations of a single run
+static constexpr size_t MAX_ITERATIONS = 1'000'000'000;
+
+struct Config {
+    std::string filter = ".*";
+    /// @brief Minimal measured time of a benchmark (seconds)
+    double minTime = 0.5;
+    fs::path jsonFile;
+    fs::path resDir {"res"};
+    fs::path userDir {".vcbench"};
+    bool list = false;
+};
+
+struct Result {
+    const Benchmark* benchmark;
+    size_t iterations;
+    /// @brief Time per iteration (nanoseconds)
+    double realTime;
+    double cpuTime;
+    double itemsPerSecond;
+    double bytesPerSecond;
+    std::map<std::string, double> counters;
+    std::string error;
+};
+
+static bool perform_keyword(
+    util::ArgsReader& reader, const std::string& keyword, Config& config
+) {
+    if (keyword == "--help" || keyword == "-h") {
+        std::cout << "Options\n\n";
+        std::cout << "  --help, -h                      = show help\n";
+        std::cout << "  --list                          = list benchmarks\n";
+        std::cout << "  --filter <regex>, -f <regex>    = run matching benchmarks only\n";
+        std::cout << "  --min-time <seconds>            = min measured time per benchmark\n";
+        std::cout << "  --json <path>                   = write results to json file\n";
+        std::cout << "  --res <path>, -r <path>         = 'res' directory path\n";
+        std::cout << "  --user <path>, -u <path>        = temporary user directory path\n";
+        std::cout << std::endl;
+        return false;
+    } else if (keyword == "--list") {
+        config.list = true;
+    } else if (keyword == "--filter" || keyword == "-f") {
+        config.filter = reader.next();
+    } else if (keyword == "--min-time") {
+        config.minTime = std::stod(reader.next());
+    } else if (keyword == "--json") {
+        config.jsonFile = fs::u8path(reader.next());
+    } else if (keyword == "--res" || keyword == "-r") {
+        config.resDir = fs::u8path(reader.next());
+    } else if (keyword == "--user" || keyword == "-u") {
+        config.userDir = fs::u8path(reader.next());
+    } else {
+        std::cerr << "unknown argument " << keyword << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool parse_cmdline(int argc, char** argv, Config& config) {
+    util::ArgsReader reader(argc, argv);
+    reader.skip();
+    while (reader.hasNext()) {
+        std::string token = reader.next();
+        if (reader.isKeywordArg()) {
+            if (!perform_keyword(reader, token, config)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// @brief Run benchmark increasing number of iterations until the
+/// measured time reaches min time
+static Result run_benchmark(const Benchmark& benchmark, double minTime) {
+    size_t iterations = 1;
+    while (true) {
+        State state(iterations, benchmark.arg);
+        try {
+            benchmark.func(state);
+        } catch (const std::exception& err) {
+            state.skipWithError(err.what());
+        }
+        if (!state.getError().empty()) {
+            return Result {&benchmark, 0, 0, 0, 0, 0, {}, state.getError()};
+        }
+        double seconds = state.getElapsed() * 1e-9;
+        if (seconds >= minTime || iterations >= MAX_ITERATIONS) {
+            double elapsed = std::max(seconds, 1e-9);
+            return Result {
+                &benchmark,
+                iterations,
+                state.getElapsed() / static_cast<double>(iterations),
+                state.getCpuElapsed() / static_cast<double>(iterations),
+                state.getItemsProcessed() / elapsed,
+                state.getBytesProcessed() / elapsed,
+                state.getCounters(),
+                ""};
+        }
+        // overshoot a bit to not repeat the run too many times
+        double multiplier = seconds > 0.0 ? minTime * 1.4 / seconds : 100.0;
+        multiplier = std::min(std::max(multiplier, 1.5), 100.0);
+        iterations = std::min(
+            MAX_ITERATIONS,
+            std::max(iterations + 1, static_cast<size_t>(iterations * multiplier))
+        );
+    }
+}
+
+static std::string format_time(double nanoseconds) {
+    char buffer[32];
+    if (nanoseconds < 1e3) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f ns", nanoseconds);
+    } else if (nanoseconds < 1e6) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f us", nanoseconds * 1e-3);
+    } else if (nanoseconds < 1e9) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f ms", nanoseconds * 1e-6);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.3f s", nanoseconds * 1e-9);
+    }
+    return buffer;
+}
+
+static std::string format_rate(double value) {
+    const char* units[] {"", "k", "M", "G"};
+    int unit = 0;
+    while (value >= 1000.0 && unit < 3) {
+        value /= 1000.0;
+        unit++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f%s", value, units[unit]);
+    return buffer;
+}
+
+static void print_result(const Result& result) {
+    std::printf("%-48s", result.benchmark->name.c_str());
+    if (!result.error.empty()) {
+        std::printf(" ERROR: %s\n", result.error.c_str());
+        std::fflush(stdout);
+        return;
+    }
+    std::printf(
+        " %12s %12s %10zu",
+        format_time(result.realTime).c_str(),
+        format_time(result.cpuTime).c_str(),
+        result.iterations
+    );
+    if (result.itemsPerSecond > 0.0) {
+        std::printf(" items/s=%s", format_rate(result.itemsPerSecond).c_str());
+    }
+    if (result.bytesPerSecond > 0.0) {
+        std::printf(" bytes/s=%s", format_rate(result.bytesPerSecond).c_str());
+    }
+    for (const auto& [name, value] : result.counters) {
+        std::printf(" %s=%s", name.c_str(), format_rate(value).c_str());
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+}
+
+/// @brief Results in Google Benchmark json format, so existing tools
+/// (e.g. compare.py) may be used to track them
+static dv::value results_to_json(
+    const std::vector<Result>& results, const Config& config
+) {
+    char date[32];
+    std::time_t time = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&time));
+
+    auto root = dv::object();
+    auto& context = root.object("context");
+    context["date"] = std::string(date);
+    context["engine_version"] = ENGINE_VERSION_STRING;
+    context["library_build_type"] = ENGINE_DEBUG_BUILD ? "debug" : "release";
+    context["num_cpus"] = static_cast<int>(std::thread::hardware_concurrency());
+    context["min_time"] = config.minTime;
+
+    auto& list = root.list("benchmarks");
+    for (const auto& result : results) {
+        auto& entry = list.object();
+        entry["name"] = result.benchmark->name;
+        entry["run_name"] = result.benchmark->name;
+        entry["run_type"] = "iteration";
+        if (!result.error.empty()) {
+            entry["error_occurred"] = true;
+            entry["error_message"] = result.error;
+            continue;
+        }
+        entry["iterations"] = static_cast<dv::integer_t>(result.iterations);
+        entry["real_time"] = result.realTime;
+        entry["cpu_time"] = result.cpuTime;
+        entry["time_unit"] = "ns";
+        if (result.itemsPerSecond > 0.0) {
+            entry["items_per_second"] = result.itemsPerSecond;
+        }
+        if (result.bytesPerSecond > 0.0) {
+            entry["bytes_per_second"] = result.bytesPerSecond;
+        }
+        for (const auto& [name, value] : result.counters) {
+            entry[name] = value;
+        }
+    }
+    return root;
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    try {
+        if (!parse_cmdline(argc, argv, config)) {
+            return EXIT_SUCCESS;
+        }
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::regex filter;
+    try {
+        filter = std::regex(config.filter);
+    } catch (const std::regex_error& err) {
+        std::cerr << "invalid filter: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<Benchmark> benchmarks;
+    for (auto& benchmark : get_benchmarks()) {
+        if (std::regex_search(benchmark.name, filter)) {
+            benchmarks.push_back(std::move(benchmark));
+        }
+    }
+    if (config.list) {
+        for (const auto& benchmark : benchmarks) {
+            std::cout << benchmark.name << "\n";
+        }
+        return EXIT_SUCCESS;
+    }
+    fs::create_directories(config.userDir);
+    debug::Logger::init((config.userDir / "vcbench.log").u8string());
+    BenchWorld::configure(config.resDir, config.userDir / "engine");
+
+    std::printf(
+        "%-48s %12s %12s %10s\n", "benchmark", "time", "cpu", "iterations"
+    );
+    std::vector<Result> results;
+    bool failed = false;
+    for (const auto& benchmark : benchmarks) {
+        auto result = run_benchmark(benchmark, config.minTime);
+        failed |= !result.error.empty();
+        print_result(result);
+        results.push_back(std::move(result));
+    }
+    BenchWorld::shutdown();
+
+    if (!config.jsonFile.empty()) {
+        std::ofstream file(config.jsonFile);
+        file << json::stringify(results_to_json(results, config), true);
+        if (!file) {
+            std::cerr << "could not write " << config.jsonFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}